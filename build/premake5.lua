@@ -86,6 +86,42 @@ function platform_defines()
     filter{}
 end
 
+-- Every file in ../resources becomes a constexpr byte array in embedded_resources.h
+-- (see include/resources.h), so the binary runs from any directory without a
+-- resources folder. The header is regenerated each time premake runs and only
+-- rewritten when a resource changed, so it does not force a rebuild otherwise.
+function embed_resources()
+    local lines = { "// Generated by build/premake5.lua from the resources folder. Do not edit.", "#pragma once", "" }
+    local entries = {}
+    local files = os.matchfiles("../resources/*")
+    table.sort(files)
+    for _, file in ipairs(files) do
+        local handle = io.open(file, "rb")
+        local data = handle:read("*all")
+        handle:close()
+        local name = path.getname(file)
+        local symbol = "embedded_" .. name:gsub("[^%w]", "_")
+        table.insert(lines, "static constexpr unsigned char " .. symbol .. "[] = {")
+        for offset = 1, #data, 24 do
+            local row = {}
+            for i = offset, math.min(offset + 23, #data) do
+                table.insert(row, string.format("0x%02x", data:byte(i)))
+            end
+            table.insert(lines, "    " .. table.concat(row, ",") .. ",")
+        end
+        table.insert(lines, "};")
+        table.insert(entries, string.format('    { "%s", "%s", %s, (int)sizeof(%s) },', name, path.getextension(name), symbol, symbol))
+    end
+    table.insert(lines, "")
+    table.insert(lines, "static constexpr EmbeddedResource embeddedResources[] = {")
+    for _, entry in ipairs(entries) do table.insert(lines, entry) end
+    table.insert(lines, "};")
+    table.insert(lines, "")
+    os.mkdir("build_files/generated")
+    os.writefile_ifnotequal(table.concat(lines, "\n"), "build_files/generated/embedded_resources.h")
+    print("Embedded " .. #files .. " resources")
+end
+
 -- if you don't want to download raylib, then set this to false, and set the raylib dir to where you want raylib to be pulled from, must be full sources.
 downloadRaylib = true
 raylib_dir = "external/raylib-master"
@@ -105,6 +141,8 @@ if (os.isdir('external') == false) then
     os.mkdir('external')
 end
 
+embed_resources()
+
 
 workspace (workspaceName)
     location "../"
@@ -164,6 +202,7 @@ if (downloadRaylib) then
     
         includedirs { "../src" }
         includedirs { "../include" }
+        includedirs { "build_files/generated" }
 
         links {"raylib"}
 
@@ -0,0 +1,18 @@
+#ifndef AUTOSELECT_H
+#define AUTOSELECT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Number of positions sampled by ProfileInput (evenly strided over the array)
+#define AUTO_SAMPLE_SIZE 1024
+
+// InputProfile is declared in visualization_state.h (the state keeps the last profile)
+
+// Sample the input: O(AUTO_SAMPLE_SIZE log AUTO_SAMPLE_SIZE), independent of n
+InputProfile ProfileInput(const std::vector<int>& array);
+
+// Pick the engine expected to be fastest for this profile; *reason gets a short explanation
+AlgorithmType ChooseAlgorithm(const InputProfile& profile, int n, const char** reason);
+
+#endif // AUTOSELECT_H
@@ -0,0 +1,59 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "visualization_state.h"
+
+// Sizes covered by a sweep; quadratic engines stop at BENCHMARK_QUADRATIC_MAX_SIZE
+#define BENCHMARK_SIZE_COUNT 3
+#define BENCHMARK_QUADRATIC_MAX_SIZE 10000
+// Each configuration runs this many times on the same input; the fastest run is kept
+#define BENCHMARK_REPETITIONS 3
+// Selection sweep: one input size, k at 0.1%, 1%, 10%, 50% and 90% of it
+#define SELECTION_BENCHMARK_SIZE 100000
+#define SELECTION_BENCHMARK_RANK_COUNT 5
+// Lookup sweep: random queries per layout, on the sorted array and these many synthetic sizes
+#define LOOKUP_BENCHMARK_QUERIES (1 << 18)
+#define LOOKUP_BENCHMARK_SIZE_COUNT 4
+// Graph sweep: vertex counts per generator
+#define GRAPH_BENCHMARK_SIZE_COUNT 2
+// Heapsort sweep: input sizes (64 KB, 512 KB and 4 MB of keys)
+#define HEAP_BENCHMARK_SIZE_COUNT 3
+
+// Run the current algorithm's full-speed engine over every distribution and size,
+// timing each run and reading the hardware counters around it. Results replace
+// state.benchmarkResults; the visualized array is left untouched. In Auto mode the
+// engine is chosen per input, as it would be on reset.
+void RunBenchmarkSweep(VisualizationState& state);
+
+// Selection sweep: quickselect, Floyd-Rivest and heap top-k against a full quicksort
+// on one SELECTION_BENCHMARK_SIZE input of the current distribution, for several k
+void RunSelectionBenchmark(VisualizationState& state);
+
+// Quickselect, Floyd-Rivest and heap top-k (benchmarked with RunSelectionBenchmark)
+bool IsSelectionAlgorithm(AlgorithmType algorithm);
+
+// String sweep: multikey quicksort and MSD radix on the arena, std::sort over the same
+// handles and std::sort over std::string, for every key kind and sweep size
+void RunStringBenchmark(VisualizationState& state);
+
+// Lookup sweep: every search layout, with and without prefetching, over the sorted
+// array of the lookup phase and LOOKUP_BENCHMARK_SIZE_COUNT larger arrays of distinct
+// keys. Results replace state.lookupResults.
+void RunLookupBenchmark(VisualizationState& state);
+
+// Graph sweep: BFS top-down and direction-optimizing, Dijkstra with both queues, on
+// each generator at GRAPH_BENCHMARK_SIZE_COUNT vertex counts. Size = edges traversed.
+void RunGraphBenchmark(VisualizationState& state);
+
+// Heapsort sweep: the d-ary engine at arity 2, 4 and 8, each with and without prefetch,
+// against std::make_heap + std::sort_heap, on HEAP_BENCHMARK_SIZE_COUNT inputs of the
+// current distribution
+void RunHeapBenchmark(VisualizationState& state);
+
+// BFS and Dijkstra (run on state.graph, not the int array)
+bool IsGraphAlgorithm(AlgorithmType algorithm);
+
+// Multikey quicksort and MSD radix (sort state.strings, not the int array)
+bool IsStringAlgorithm(AlgorithmType algorithm);
+
+#endif // BENCHMARK_H
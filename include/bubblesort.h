@@ -2,16 +2,22 @@
 #define BUBBLESORT_H
 
 #include "visualization_state.h"
+#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Step function declared in visualization_state.h
+// Step functions declared in visualization_state.h
 // bool StepBubbleSort(VisualizationState& state);
+// bool StepCocktailSort(VisualizationState& state);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // BUBBLESORT_H
\ No newline at end of file
+// Full-speed engines. With earlyExit the sort stops after the first pass without swaps.
+void BubbleSortFull(std::vector<int>& arr, bool earlyExit);
+void CocktailSortFull(std::vector<int>& arr, bool earlyExit);
+
+#endif // BUBBLESORT_H
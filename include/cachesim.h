@@ -0,0 +1,67 @@
+#ifndef CACHESIM_H
+#define CACHESIM_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Set-associative, LRU, non-exclusive cache hierarchy fed with the engines'
+// array accesses. Sizes are in bytes and must be powers of two.
+
+#define CACHE_MAX_LEVELS 3
+
+typedef struct {
+    const char* name;
+    int sizeBytes;
+    int lineBytes;
+    int ways;
+} CacheLevelConfig;
+
+typedef struct {
+    const char* name;
+    CacheLevelConfig levels[CACHE_MAX_LEVELS];
+} CachePreset;
+
+// Memory regions traced separately; each gets its own simulated base address
+typedef enum {
+    MEM_REGION_ARRAY,   // state.array
+    MEM_REGION_AUX,     // Scratch / merge / radix buffers
+    MEM_REGION_COUNTS,  // Histograms and bucket offsets
+    MEM_REGION_COUNT
+} MemoryRegion;
+
+struct CacheLevel {
+    CacheLevelConfig config;
+    int sets;
+    int lineShift;
+    std::vector<uint64_t> tags;     // sets * ways, UINT64_MAX = empty
+    std::vector<uint64_t> lastUse;  // LRU timestamps, same layout
+    long long hits;
+    long long misses;
+};
+
+struct CacheSimulator {
+    CacheLevel levels[CACHE_MAX_LEVELS];
+    int levelCount;
+    int presetIndex;
+    uint64_t clock;
+    long long accesses;
+    long long reads;
+    long long writes;
+};
+
+// Built-in hierarchies (index 0 is the default)
+int GetCachePresetCount(void);
+const CachePreset& GetCachePreset(int index);
+
+// Configure the levels from a preset and clear contents and statistics
+void InitCacheSimulator(CacheSimulator& sim, int presetIndex);
+
+// Empty every level and zero the statistics, keeping the configuration
+void ResetCacheSimulator(CacheSimulator& sim);
+
+// Simulate one access. Returns the index of the level that hit, or levelCount
+// if the access went to memory. Missing levels are filled on the way back.
+int SimulateCacheAccess(CacheSimulator& sim, MemoryRegion region, int index, bool isWrite);
+
+#endif // CACHESIM_H
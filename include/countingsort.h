@@ -0,0 +1,17 @@
+#ifndef COUNTINGSORT_H
+#define COUNTINGSORT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Step function declared in visualization_state.h
+// bool StepCountingSort(VisualizationState& state);
+
+// Counting sort allocates one counter per distinct value in [min, max]; beyond this the
+// engine refuses (the auto selector never picks it for wider ranges).
+#define COUNTING_SORT_MAX_RANGE (1 << 24)
+
+// Full-speed engine. Returns false (leaving arr untouched) if the value range is too wide.
+bool CountingSortFull(std::vector<int>& arr, long long* bytesMoved);
+
+#endif // COUNTINGSORT_H
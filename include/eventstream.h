@@ -0,0 +1,126 @@
+#ifndef EVENTSTREAM_H
+#define EVENTSTREAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Shared-memory event stream: while enabled (F5), engine progress is published into a
+// POSIX shared-memory object that local tools map and read with plain loads, no
+// syscalls on either side. One writer (this app), any number of readers. The writer
+// never waits for anyone: a reader that falls more than a ring behind loses events,
+// and can tell. Readers written in C++ can include this header as is.
+//
+// Layout of the object (host byte order, offsets from the start of the mapping):
+//
+//   0                       EventStreamHeader
+//   header.eventOffset      EventRecord[header.eventCapacity]   (ring, capacity a power of two)
+//   header.snapshotOffset   int32_t[header.snapshotCapacity]    (latest array snapshot)
+//
+// Events: event s (counting from 0) lives in slot s & (eventCapacity - 1). The writer
+// stores 0 into the slot's `sequence`, fills in the payload, stores s + 1 into
+// `sequence` (release) and finally s + 1 into `writeSequence` (release). To read event s,
+// load `sequence` (acquire), copy the record, fence (acquire) and load `sequence` again:
+// both loads must return s + 1, otherwise the slot was being overwritten.
+//
+// Snapshot: a seqlock. `snapshotSequence` is odd while the writer copies the array in.
+// Copy snapshotLength values between two loads of it that are even and equal.
+//
+// The header is filled in before `magic` is stored (release); `writerActive` drops to 0
+// when the app closes the stream, after which the name no longer exists.
+
+#define EVENT_STREAM_NAME "/algowizz-events"
+#define EVENT_STREAM_MAGIC 0x455A5741u     // "AWZE"
+#define EVENT_STREAM_VERSION 1
+#define EVENT_STREAM_CAPACITY (1 << 16)    // Events in the ring (4 MB)
+#define EVENT_STREAM_SNAPSHOT_CAPACITY (1 << 17) // Largest array a snapshot holds
+
+typedef enum {
+    EVENT_RESET = 1, // a = array size, b = AlgorithmType
+    EVENT_STEP,      // a, b, c = primary, secondary, tertiary index after the step (-1 = none)
+    EVENT_READ,      // a = index, b = MemoryRegion (memory-traced engines only)
+    EVENT_WRITE,     // a = index, b = MemoryRegion
+    EVENT_SNAPSHOT,  // a = length; snapshotSequence after the copy in c
+    EVENT_FINISHED,  // a = 1 if the run finished stepping, 0 if it was run at full speed
+} EventType;
+
+// One cache line per event, so the writer never shares a line with a reader's slot
+struct alignas(64) EventRecord {
+    std::atomic<uint64_t> sequence; // s + 1 once event s is complete, 0 while it is written
+    uint32_t type;                  // EventType
+    int32_t a;
+    int32_t b;
+    int32_t c;
+    int64_t step;                   // Step count, comparisons and swaps at the event
+    int64_t comparisons;
+    int64_t swaps;
+    uint64_t timeNs;                // Steady clock of the writer
+};
+
+struct EventStreamHeader {
+    std::atomic<uint32_t> magic;  // EVENT_STREAM_MAGIC once the rest is valid
+    uint32_t version;
+    uint32_t headerSize;          // sizeof(EventStreamHeader)
+    uint32_t recordSize;          // sizeof(EventRecord)
+    uint32_t eventCapacity;
+    uint32_t snapshotCapacity;
+    uint64_t eventOffset;
+    uint64_t snapshotOffset;
+    uint32_t writerPid;
+    std::atomic<uint32_t> writerActive;
+    // Written on every event: kept off the line the constant fields are on
+    alignas(64) std::atomic<uint64_t> writeSequence; // Events published so far
+    alignas(64) std::atomic<uint64_t> snapshotSequence;
+    std::atomic<int32_t> snapshotLength;
+};
+
+static_assert(sizeof(EventRecord) == 64, "EventRecord is one cache line");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomics must be plain words in shared memory");
+
+// Writer side, owned by the visualization state
+struct EventStream {
+    bool active;
+    int fd;
+    void* mapping;
+    size_t mappingSize;
+    EventStreamHeader* header;
+    EventRecord* events;
+    int32_t* snapshot;
+    uint64_t next;       // Next event number (the writer's copy of writeSequence)
+    uint64_t snapshots;  // Writer's copy of snapshotSequence
+};
+
+// Create (or take over) the shared-memory object and map it. Returns false if shared
+// memory is unavailable; the reason is in GetEventStreamStatus().
+bool OpenEventStream(EventStream& stream, const char* name);
+// Unmap and remove the object (readers keep their mappings)
+void CloseEventStream(EventStream& stream);
+
+uint64_t EventStreamClockNs();
+
+inline void PublishEvent(EventStream& stream, EventType type, int a, int b, int c,
+                         long long step, long long comparisons, long long swaps) {
+    uint64_t s = stream.next++;
+    EventRecord& r = stream.events[s & (EVENT_STREAM_CAPACITY - 1)];
+    r.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    r.type = (uint32_t)type;
+    r.a = a;
+    r.b = b;
+    r.c = c;
+    r.step = step;
+    r.comparisons = comparisons;
+    r.swaps = swaps;
+    r.timeNs = EventStreamClockNs();
+    r.sequence.store(s + 1, std::memory_order_release);
+    stream.header->writeSequence.store(s + 1, std::memory_order_release);
+}
+
+// Copy up to EVENT_STREAM_SNAPSHOT_CAPACITY values into the snapshot area. Returns the
+// new (even) snapshot sequence.
+uint64_t PublishSnapshot(EventStream& stream, const int* values, int count);
+
+// "off", "/algowizz-events: 123456 events" or why the stream could not be opened
+const char* GetEventStreamStatus(const EventStream& stream);
+
+#endif // EVENTSTREAM_H
@@ -0,0 +1,152 @@
+#ifndef EXTERNALSORT_H
+#define EXTERNALSORT_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// External merge sort: the data set lives in a temporary file and only `memoryCap`
+// elements of working memory are used. Replacement selection forms sorted runs, then
+// passes of k-way loser-tree merges combine them until one run is left. All file I/O
+// goes through double-buffered streams whose next block is read/written by the job's
+// I/O thread. Step function (StepExternalSort) declared in visualization_state.h.
+
+#define EXTSORT_BLOCK_ELEMENTS 1024                     // I/O unit: one buffer of a double-buffered stream
+#define EXTSORT_MIN_MEMORY (8 * EXTSORT_BLOCK_ELEMENTS) // Formation needs 4 buffers plus a heap
+#define EXTSORT_STEPS_PER_PASS 256                     // Visualization steps per pass over the data
+
+typedef enum {
+    EXTSORT_IDLE,     // No data set
+    EXTSORT_FILLING,  // Loading the replacement-selection heap
+    EXTSORT_FORMING,  // Writing runs
+    EXTSORT_MERGING,
+    EXTSORT_DONE,
+    EXTSORT_FAILED    // I/O error (see error)
+} ExternalSortPhase;
+
+// Contiguous sorted range of a temp file, in elements
+struct ExternalRun {
+    long long start;
+    long long length;
+};
+
+// Sequential reader of one run: the block after the one being consumed is already
+// being read by the I/O thread
+struct ExternalReader {
+    FILE* file;
+    long long next;      // File offset of the next block to request
+    long long remaining; // Elements not yet requested
+    std::vector<int> buffers[2];
+    int counts[2];
+    int requested;       // Size of the block in flight
+    int active;          // Buffer being consumed
+    int position;
+    std::future<int> pending;
+};
+
+// Sequential writer: one buffer fills while the I/O thread writes the other
+struct ExternalWriter {
+    FILE* file;
+    std::vector<int> buffers[2];
+    int active;
+    int count;
+    int requested;
+    std::future<int> pending;
+};
+
+// One block for the I/O thread; `done` receives the element count transferred
+struct ExternalIoRequest {
+    FILE* file;
+    long long offset; // Element offset of a read; writes go to the file position (-1)
+    int* buffer;
+    int count;
+    std::promise<int> done;
+};
+
+// Tournament tree over k sources: nodes[0] is the current winner, nodes[1..k) hold the
+// loser of the match played at that node, so a replay only walks one leaf-to-root path
+struct LoserTree {
+    int k;
+    std::vector<int> nodes;
+    std::vector<int> heads;      // Current element of each source
+    std::vector<char> exhausted;
+};
+
+struct ExternalSortJob {
+    // Configuration, kept across resets
+    long long totalElements;
+    int memoryCap;    // Elements of working memory (heap or stream buffers)
+
+    ExternalSortPhase phase;
+    const char* error;
+    int fanout;       // Runs merged at once: two buffers per input plus two for the output
+
+    // files[0] holds the input; passes alternate between files[1] and files[2].
+    // Readers of one file share it; the single I/O thread serializes their seeks.
+    FILE* files[3];
+    int sourceFile;
+    int targetFile;
+
+    std::vector<ExternalRun> runs;     // Runs of the source file
+    std::vector<ExternalRun> nextRuns; // Runs written to the target file so far
+    int pass;                          // 0 = run formation
+    int groupStart;                    // First source run of the current merge
+    int groupSize;
+    long long outputPosition;          // Elements written to the target file in this pass
+
+    // Replacement selection: min-heap of (run << 32 | biased key)
+    std::vector<uint64_t> heap;
+    int heapSize;
+    int heapCapacity;
+    int currentRun;
+
+    ExternalReader input;
+    std::vector<ExternalReader> readers; // One per run of the current merge
+    ExternalWriter writer;
+    LoserTree tree;
+
+    // I/O thread, started with the job and joined by ReleaseExternalSort; it serves the
+    // queued blocks in order
+    std::thread ioThread;
+    std::mutex ioLock;
+    std::condition_variable ioWake;
+    std::deque<ExternalIoRequest> ioQueue;
+    bool ioStop;
+
+    // Cost accounting
+    int initialRuns;
+    long long bytesRead;
+    long long bytesWritten;
+    uint64_t ioWaitTicks; // Blocked on a read or write that had not finished
+    uint64_t busyTicks;   // Total time inside AdvanceExternalSort
+};
+
+// Runs k-way merged per pass for a memory cap
+int ExternalSortFanout(int memoryCap);
+
+// Close the temp files (after any I/O in flight completes), stop the I/O thread and
+// clear the progress; the configuration is kept
+void ReleaseExternalSort(ExternalSortJob& job);
+
+// Write `count` elements to a temp file and get ready to sort them (totalElements is
+// set to count). `view` (may be null, its size is kept) receives an evenly spaced
+// sample of the file. Returns false if the temp file could not be written.
+bool StartExternalSort(ExternalSortJob& job, const int* data, long long count, std::vector<int>* view);
+
+// Sort on for up to `budget` elements of work. While elements are written, the
+// samples of `view` (may be null) are updated to follow the target file.
+// Returns true while there is work left.
+bool AdvanceExternalSort(ExternalSortJob& job, long long budget, std::vector<int>* view);
+
+// Full-speed engine: sorts `arr` through temp files with `memoryCap` elements of memory.
+// Returns false (logging the job's error, arr possibly unsorted) if the file I/O failed.
+bool ExternalSortFull(std::vector<int>& arr, int memoryCap, long long* bytesMoved);
+
+const char* GetExternalSortPhaseName(ExternalSortPhase phase);
+
+#endif // EXTERNALSORT_H
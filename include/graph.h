@@ -0,0 +1,122 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+// Graph traversal on a compressed sparse row (CSR) graph: the neighbours of vertex v
+// are targets[offsets[v] .. offsets[v + 1]) with the matching weights. Every graph is
+// stored symmetric (each edge in both rows), so a row doubles as the in-edges that
+// bottom-up BFS scans. Step functions (StepBfs, StepDijkstra) declared in
+// visualization_state.h.
+
+#define GRAPH_AVERAGE_DEGREE 8   // Generated random and R-MAT graphs (grids have 4)
+#define GRAPH_MAX_WEIGHT 100     // Edge weights are 1..GRAPH_MAX_WEIGHT
+#define GRAPH_UNREACHED INT64_MAX
+#define GRAPH_FILE_VARIABLE "ALGOWIZZ_GRAPH" // Environment variable naming an edge list to load
+#define BFS_ALPHA 14  // Top-down -> bottom-up once the frontier's edges exceed the unexplored edges / alpha
+#define BFS_BETA 24   // Bottom-up -> top-down once the frontier shrinks below n / beta
+#define RADIX_HEAP_BUCKETS 65 // Bucket 0 = the last minimum, bucket b = keys differing from it first in bit b-1
+
+typedef enum {
+    GRAPH_GRID,   // 2-D grid, 4 neighbours: long diameter, thin frontiers
+    GRAPH_RANDOM, // Uniform random edges: short diameter, even degrees
+    GRAPH_RMAT,   // R-MAT power law (Graph500 parameters): a few hubs reach most vertices early
+    GRAPH_FILE,   // Edge list named by GRAPH_FILE_VARIABLE (see LoadEdgeList)
+    GRAPH_KIND_COUNT
+} GraphKind;
+
+struct GraphEdge {
+    int from;
+    int to;
+    int weight;
+};
+
+struct CsrGraph {
+    int vertexCount;
+    std::vector<int> offsets; // vertexCount + 1 entries
+    std::vector<int> targets; // Both directions of every edge
+    std::vector<int> weights;
+    std::vector<float> layoutX; // Drawing position of each vertex in [0, 1]
+    std::vector<float> layoutY;
+};
+
+inline int GraphDegree(const CsrGraph& graph, int v) {
+    return graph.offsets[v + 1] - graph.offsets[v];
+}
+
+// BFS from one source, one level per call. The frontier is always kept as a queue;
+// bottom-up levels test frontier membership in a bitmap built from it.
+struct BfsSearch {
+    bool directionOptimizing; // Off: every level is top-down
+    bool bottomUp;            // Direction of the next level
+    int level;                // Depth of the current frontier
+    std::vector<int> depth;   // -1 = not reached
+    std::vector<int> parent;
+    std::vector<int> frontier;
+    std::vector<int> next;
+    std::vector<uint64_t> frontierBits;
+    long long frontierEdges;   // Sum of the frontier's degrees
+    long long unexploredEdges; // Sum of the unreached vertices' degrees
+    int previousFrontierSize;  // Bottom-up only hands back to top-down while the frontier shrinks
+    int topDownLevels;
+    int bottomUpLevels;
+};
+
+typedef enum {
+    DIJKSTRA_BINARY_HEAP, // Lazy deletion: a decrease pushes a new entry, stale ones are skipped
+    DIJKSTRA_RADIX_HEAP,  // Monotone: keys never drop below the last minimum, buckets by highest differing bit
+    DIJKSTRA_QUEUE_COUNT
+} DijkstraQueue;
+
+// Queue entry of Dijkstra; entries compare by distance
+struct DijkstraEntry {
+    uint64_t distance;
+    int vertex;
+};
+
+// Dijkstra from one source, one vertex settled per call. Distances are 64-bit: a path
+// of up to INT_MAX edges of weight up to INT_MAX cannot overflow them.
+struct DijkstraSearch {
+    DijkstraQueue queue;
+    std::vector<int64_t> distance; // GRAPH_UNREACHED until reached
+    std::vector<int> parent;
+    std::vector<unsigned char> settled;
+    std::vector<DijkstraEntry> heap;                         // Binary heap
+    std::vector<DijkstraEntry> buckets[RADIX_HEAP_BUCKETS];  // Radix heap
+    uint64_t radixLast;   // Radix heap: last extracted distance
+    long long queued;     // Entries in the queue, stale ones included
+    int current;          // Last settled vertex (-1 before the first)
+    int settledCount;
+    long long staleEntries;
+};
+
+// Replace the graph with `vertexCount` vertices of `kind` (not GRAPH_FILE)
+void GenerateGraph(CsrGraph& graph, GraphKind kind, int vertexCount);
+
+// Load a text edge list: "u v [w]" per line with 0-based ids (SNAP), or DIMACS
+// "a u v w" arcs with 1-based ids. Lines starting with #, %, c or p are skipped;
+// missing weights are drawn at random. Sparse ids (largest id beyond twice the edge
+// count) are renumbered densely in their order. Returns false if nothing could be read,
+// or if a weight is negative or beyond an int (logged; Dijkstra needs them as they are).
+bool LoadEdgeList(CsrGraph& graph, const char* path);
+
+// Build the symmetric CSR rows from an edge list (self loops dropped)
+void BuildCsrGraph(CsrGraph& graph, int vertexCount, const std::vector<GraphEdge>& edges);
+
+// Random vertex with at least one edge (R-MAT and loaded graphs have isolated ones)
+int PickGraphSource(const CsrGraph& graph);
+
+void StartBfs(BfsSearch& search, const CsrGraph& graph, int source, bool directionOptimizing);
+// Expand the frontier by one level. Returns false once the frontier is empty.
+// `edgesChecked` counts the row entries examined.
+bool BfsLevel(BfsSearch& search, const CsrGraph& graph, long long* edgesChecked);
+
+void StartDijkstra(DijkstraSearch& search, const CsrGraph& graph, int source, DijkstraQueue queue);
+// Settle the closest queued vertex and relax its edges. Returns false once the queue is empty.
+bool DijkstraSettleNext(DijkstraSearch& search, const CsrGraph& graph, long long* edgesChecked);
+
+const char* GetGraphKindName(GraphKind kind);
+const char* GetDijkstraQueueName(DijkstraQueue queue);
+
+#endif // GRAPH_H
@@ -0,0 +1,27 @@
+#ifndef HEAPSORT_H
+#define HEAPSORT_H
+
+#include <vector>
+
+// Heapsort over a d-ary max-heap: the children of node i are d*i+1 .. d*i+d, so a
+// sift visits log_d(n) levels and reads one contiguous group of d keys per level.
+// Extraction uses Floyd's bottom-up sift: the hole left by the root drops along the
+// larger children to a leaf (d - 1 comparisons per level, none against the displaced
+// element) and the displaced last element then climbs back up from there, which is
+// usually only a level or two. Step function (StepHeapSort) declared in
+// visualization_state.h.
+
+#define HEAP_DEFAULT_ARITY 4
+#define HEAP_TREE_DRAW_LEVEL_NODES 128 // Tree overlay: levels wider than this are left out
+
+// 2 -> 4 -> 8 -> 2. With d ints per group, 8 still fits a 64-byte line twice.
+int NextHeapArity(int arity);
+
+// Full-speed engine. Sorts a copy laid out so that heap + 1 is 64-byte aligned: every
+// child group then starts on a multiple of d ints and never straddles a cache line.
+// With `prefetch`, each level also prefetches every cache line holding the grandchildren
+// (the d*d keys the next level can read: 2 lines for d=4, up to 5 for d=8).
+// comparisons/bytesMoved may be null; when set they are incremented.
+void HeapSortFull(std::vector<int>& arr, int arity, bool prefetch, long long* comparisons, long long* bytesMoved);
+
+#endif // HEAPSORT_H
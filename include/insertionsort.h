@@ -2,16 +2,26 @@
 #define INSERTIONSORT_H
 
 #include "visualization_state.h"
+#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Step function declared in visualization_state.h
+// Step functions declared in visualization_state.h
 // bool StepInsertionSort(VisualizationState& state);
+// bool StepBinaryInsertionSort(VisualizationState& state);
 
 #ifdef __cplusplus
 }
 #endif
 
-#endif // INSERTIONSORT_H
\ No newline at end of file
+// Index of the first element in arr[0, n) greater than key (keeps equal keys stable).
+// The loop body compiles to a conditional move; adds the number of probes to *comparisons.
+int BranchlessUpperBound(const int* arr, int n, int key, long long* comparisons);
+
+// Full-speed engines. comparisons/bytesMoved may be null; when set they are incremented.
+void InsertionSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved);
+void BinaryInsertionSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved);
+
+#endif // INSERTIONSORT_H
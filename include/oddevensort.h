@@ -0,0 +1,27 @@
+#ifndef ODDEVENSORT_H
+#define ODDEVENSORT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Step function declared in visualization_state.h
+// bool StepOddEvenTranspositionSort(VisualizationState& state);
+
+// Full-speed engine: arrays at least this large split each phase across worker threads
+#define ODDEVEN_PARALLEL_THRESHOLD (1 << 16)
+
+// Run one phase of odd-even transposition on the calling thread: compare-exchange every
+// disjoint pair (i, i + 1) with i % 2 == parity, with AVX2 when available. A phase is
+// too short to pay for starting threads; only the full-speed engine keeps workers.
+// Returns the number of swaps performed.
+long long OddEvenPhase(int* arr, int n, int parity);
+
+// Number of threads a phase over n elements should use
+int GetOddEvenThreadCount(int n);
+
+// Full-speed engine. Worker threads stay alive across phases and meet at a barrier.
+// With earlyExit the sort stops after an even+odd phase pair without swaps;
+// otherwise it runs the full n phases.
+void OddEvenTranspositionSortFull(std::vector<int>& arr, bool earlyExit);
+
+#endif // ODDEVENSORT_H
@@ -0,0 +1,42 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+// Hardware performance counters around full-speed runs. On Linux these come from
+// perf_event_open (user space only, so perf_event_paranoid <= 2 is enough); elsewhere,
+// or when the kernel refuses an event (VMs, containers, missing PMU), the affected
+// counters are reported as unavailable and everything else keeps working.
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_CACHE_MISSES,   // Last-level cache misses
+    PERF_COUNTER_COUNT
+} PerfCounterKind;
+
+typedef struct {
+    long long values[PERF_COUNTER_COUNT];
+    bool valid[PERF_COUNTER_COUNT]; // False if the counter could not be opened or never ran
+} PerfSample;
+
+struct PerfCounterSet {
+    int fds[PERF_COUNTER_COUNT]; // -1 = unavailable
+};
+
+// Open every counter for the calling thread (and threads it creates afterwards).
+// Returns true if at least one counter is available.
+bool OpenPerfCounters(PerfCounterSet& set);
+void ClosePerfCounters(PerfCounterSet& set);
+
+// Zero and enable / disable and read the counters. Values are scaled up if the
+// kernel had to multiplex them.
+void StartPerfCounters(PerfCounterSet& set);
+void StopPerfCounters(PerfCounterSet& set, PerfSample& sample);
+
+// Short label for the UI ("cycles", "branch-misses", ...)
+const char* GetPerfCounterName(PerfCounterKind kind);
+
+// Human-readable availability summary, e.g. "4/4 counters" or "perf_event_open: Permission denied"
+const char* GetPerfCounterStatus(void);
+
+#endif // PERFCOUNTERS_H
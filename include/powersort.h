@@ -0,0 +1,34 @@
+#ifndef POWERSORT_H
+#define POWERSORT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Step function declared in visualization_state.h
+// bool StepPowersort(VisualizationState& state);
+
+// Galloping starts after this many consecutive wins by one run (adapted during a merge)
+#define POWERSORT_MIN_GALLOP 7
+
+// Minimum run length for n elements (TimSort's rule: 32..64 for large n).
+// Small arrays still get a few runs so the merge stack has something to show.
+int ComputeMinRun(int n);
+
+// Find the maximal run starting at `start` (strictly descending runs are reversed),
+// then extend it to at least minRun elements with binary insertion sort.
+// Returns the run length.
+int DetectRun(int* arr, int n, int start, int minRun, long long* comparisons, long long* bytesMoved);
+
+// Powersort merge policy: the "power" of the boundary between two adjacent runs
+// [beginA, beginB) and [beginB, endB) in an array of n elements.
+int NodePower(int n, int beginA, int beginB, int endB);
+
+// Stable merge of arr[lo, mid) and arr[mid, hi) with galloping; the left run is
+// copied to tmp. minGallop is adapted in place.
+void MergeRunsGalloping(int* arr, int lo, int mid, int hi, std::vector<int>& tmp, int& minGallop,
+                        long long* comparisons, long long* bytesMoved);
+
+// Full-speed engine
+void PowersortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved);
+
+#endif // POWERSORT_H
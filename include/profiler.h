@@ -0,0 +1,60 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <vector>
+
+// Scoped zone profiler. Zones are timed with the CPU timestamp counter (steady_clock
+// on non-x86) and written to a per-thread ring buffer without locks, so they are cheap
+// enough to leave around every frame phase. When the profiler is disabled a zone costs
+// one relaxed atomic load.
+//
+//     void DrawSomething() {
+//         PROFILE_ZONE("DrawSomething"); // Name must be a string literal
+//         ...
+//     }
+
+#define PROFILER_MAX_THREADS 32
+#define PROFILER_EVENTS_PER_THREAD (1 << 16) // Ring size, power of two
+#define PROFILER_MAX_DEPTH 32
+
+typedef struct {
+    const char* name; // Only the pointer is stored
+    uint64_t begin;   // Ticks
+    uint64_t end;
+    int depth;        // Nesting level on its thread (0 = outermost)
+} ProfileEvent;
+
+void SetProfilerEnabled(bool enabled);
+bool IsProfilerEnabled(void);
+
+// Current timestamp in ticks, and conversion to milliseconds (calibrated once against steady_clock)
+uint64_t ProfilerNow(void);
+double ProfilerTicksToMs(uint64_t ticks);
+
+struct ProfileZone {
+    explicit ProfileZone(const char* name);
+    ~ProfileZone();
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+    const char* name;
+    uint64_t begin; // 0 = not recording
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+// Mark the start of a new frame. Call once per frame from the thread that draws.
+void ProfilerMarkFrame(void);
+
+// Zones recorded by the calling thread during the last completed frame (between the
+// two most recent frame marks). Returns false if there is no complete frame yet.
+bool GetLastFrameZones(std::vector<ProfileEvent>& events, uint64_t& frameBegin, uint64_t& frameEnd);
+
+// Write every buffered zone of every thread, plus the frame marks, as a Chrome trace
+// (chrome://tracing or ui.perfetto.dev). Returns the number of events written, -1 on error.
+int ExportChromeTrace(const char* path);
+
+#endif // PROFILER_H
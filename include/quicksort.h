@@ -2,6 +2,7 @@
 #define QUICKSORT_H
 
 #include "visualization_state.h" // Include the common state header
+#include <vector>
 
 // No specific data struct needed here anymore if managed by VisualizationState
 
@@ -19,4 +20,38 @@ extern "C" { // Keep C linkage if quicksort.c is C, but we'll make it C++
 }
 #endif
 
-#endif // QUICKSORT_H
\ No newline at end of file
+// --- Partition kernels ---
+// All kernels use arr[high] as the pivot, move every element smaller than the pivot
+// in front of it and return the pivot's final index (Lomuto semantics).
+
+// Classic branchy compare-and-swap loop
+int PartitionScalar(int* arr, int low, int high);
+// Same loop with the swap made unconditional, so the only branch is the loop itself
+int PartitionBranchless(int* arr, int low, int high);
+// AVX2 compress-store: 8 elements per iteration, permuted with a lookup table into
+// two scratch buffers. scratch must hold at least 2 * (high - low + 8) ints.
+// Only call this when CpuSupportsAVX2() is true.
+int PartitionAVX2(int* arr, int low, int high, int* scratch);
+
+// Falls back to the branchless kernel if AVX2 was requested but is not available
+PartitionKernel ResolvePartitionKernel(PartitionKernel requested);
+const char* GetPartitionKernelName(PartitionKernel kernel);
+
+// Runs one partition with the chosen kernel, growing scratch if the AVX2 kernel needs it
+int PartitionWithKernel(int* arr, int low, int high, PartitionKernel kernel, std::vector<int>& scratch);
+
+// Full-speed engine: sorts the whole array without visualization steps.
+// Uses a fixed on-stack frame array; the only allocation is the AVX2 scratch.
+// Pivots are medians of three, and runs of keys equal to the previous pivot are set
+// aside in one pass, so sorted, reversed and few-unique inputs stay n log n.
+void QuickSortFull(std::vector<int>& arr, PartitionKernel kernel);
+
+// Pending frames needed for n elements when the larger side is deferred and the
+// smaller one processed first: floor(log2(n)) + 1
+int QuickSortStackCapacity(int n);
+
+// Set up the step engine for the whole array. Allocates only if the arena or the
+// scratch buffer is smaller than this size needs; nothing allocates after this.
+void PrepareQuickSort(VisualizationState& state);
+
+#endif // QUICKSORT_H
@@ -0,0 +1,17 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Step function declared in visualization_state.h
+// bool StepRadixSort(VisualizationState& state);
+
+// Digit width of the visualized engine (16 buckets keeps each pass readable)
+#define RADIX_VIZ_BITS 4
+
+// Full-speed LSD radix sort on bytes. Keys are biased by the minimum so negative
+// values work, and passes whose digit is the same for every element are skipped.
+void RadixSortFull(std::vector<int>& arr, long long* bytesMoved);
+
+#endif // RADIXSORT_H
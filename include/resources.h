@@ -0,0 +1,39 @@
+#ifndef RESOURCES_H
+#define RESOURCES_H
+
+#include "raylib.h"
+
+// Resources are compiled into the binary: build/premake5.lua turns every file in the
+// resources folder into a constexpr byte array (embedded_resources.h), so nothing is
+// read from disk and the working directory does not matter. Images are decoded on a
+// worker thread while the first frames draw without them; the decoded pixels are
+// uploaded to the GPU from the main thread, which owns the GL context.
+
+typedef struct {
+    const char* name;     // File name in the resources folder, e.g. "rec.png"
+    const char* fileType; // Extension with the dot, as raylib's *FromMemory loaders expect
+    const unsigned char* data;
+    int size;
+} EmbeddedResource;
+
+// nullptr if no resource of that name was embedded
+const EmbeddedResource* FindEmbeddedResource(const char* name);
+
+// Start decoding every embedded image on a worker thread
+void StartResourceLoading(void);
+// Main thread, once per frame: upload the images decoded so far. Returns true once
+// every texture is on the GPU (cheap to keep calling afterwards).
+bool UploadLoadedResources(void);
+// Texture of an embedded image; id 0 until it has been uploaded
+Texture2D GetResourceTexture(const char* name);
+// Waits for the worker and unloads the textures (before CloseWindow)
+void UnloadResources(void);
+
+// --- Startup timing ---
+// Record that `phase` (a string literal) finished, in ms since the process started.
+// Once "interactive" is marked the phases are logged as one line.
+void MarkStartupPhase(const char* phase);
+// "window 41.2 ms, first frame 58.0 ms, ..." or "" before startup has finished
+const char* GetStartupReport(void);
+
+#endif // RESOURCES_H
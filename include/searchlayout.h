@@ -0,0 +1,76 @@
+#ifndef SEARCHLAYOUT_H
+#define SEARCHLAYOUT_H
+
+#include "perfcounters.h"
+#include <vector>
+
+// Lookup phase: the sorted array is copied into layouts built for searching and
+// lower_bound queries are run against each. Step function (StepLookup) declared in
+// visualization_state.h.
+
+#define STREE_NODE_KEYS 16   // S-tree node = one 64-byte cache line of keys
+#define LOOKUP_BATCH 16      // Queries advanced in lockstep by the batched (prefetching) searches
+#define LOOKUP_VIZ_QUERIES 32 // Queries traced per visualized lookup run
+
+typedef enum {
+    SEARCH_BINARY,     // Branchy binary search over the sorted array
+    SEARCH_BRANCHLESS, // Binary search with a conditional move per level
+    SEARCH_EYTZINGER,  // Breadth-first order: the first levels share a few cache lines
+    SEARCH_STREE,      // Static B-tree, 17-ary, node searched with SIMD compares
+    SEARCH_LAYOUT_COUNT
+} SearchLayoutKind;
+
+struct SearchLayouts {
+    int n;
+    std::vector<int> sorted;
+    std::vector<int> eytzingerStorage; // 1-based slots, padded for alignment (see EytzingerSlots)
+    int eytzingerOffset;          // Slot 0 of the layout; 64-byte aligned within eytzingerStorage
+    std::vector<int> streeStorage; // Nodes of STREE_NODE_KEYS, padded with INT_MAX (see StreeNodes)
+    int streeOffset;              // First element of the 64-byte aligned region in streeStorage
+    int streeNodes;
+    // Sorted position of every Eytzinger slot and S-tree key, for tracing (optional)
+    std::vector<int> eytzingerRank;
+    std::vector<int> streeRank;
+};
+
+// One memory access of a traced query: where it is in the layout and which element of
+// the sorted order it reads (an S-tree probe reads a whole node)
+struct SearchProbe {
+    int memoryIndex;
+    int sortedIndex;
+};
+
+// Queries per second of one layout over one array size
+struct LookupResult {
+    SearchLayoutKind layout;
+    bool prefetch;
+    int size;
+    double nsPerQuery;   // Fastest of the repetitions
+    PerfSample counters; // Counters of that repetition
+};
+
+// Build every layout from `sorted` (ascending). Ranks are only needed for tracing.
+void BuildSearchLayouts(SearchLayouts& layouts, const std::vector<int>& sorted, bool withRanks);
+
+inline const int* StreeNodes(const SearchLayouts& layouts) {
+    return layouts.streeStorage.data() + layouts.streeOffset;
+}
+
+// Slot 0 (unused) sits on a line boundary, so slots 16k..16k+15 share one cache line
+inline const int* EytzingerSlots(const SearchLayouts& layouts) {
+    return layouts.eytzingerStorage.data() + layouts.eytzingerOffset;
+}
+
+// lower_bound over `count` queries: results[i] = smallest element >= queries[i], or INT_MAX.
+// With `prefetch`, branchless and S-tree searches advance LOOKUP_BATCH queries in
+// lockstep and prefetch each query's next probe; Eytzinger prefetches four levels ahead.
+void RunSearchQueries(const SearchLayouts& layouts, SearchLayoutKind kind, bool prefetch,
+                      const int* queries, int count, int* results);
+
+// Scalar search of one query recording its probes; returns the sorted position of the
+// lower bound (n if every element is smaller). Needs layouts built with ranks.
+int TraceSearch(const SearchLayouts& layouts, SearchLayoutKind kind, int query, std::vector<SearchProbe>& probes);
+
+const char* GetSearchLayoutName(SearchLayoutKind kind);
+
+#endif // SEARCHLAYOUT_H
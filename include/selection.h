@@ -0,0 +1,28 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Selection engines: afterwards arr[k] holds the element of rank k (0-based), everything
+// before it is <= arr[k] and everything after is >=. Heap top-k additionally leaves
+// arr[0..k] sorted. Step functions declared in visualization_state.h.
+
+// Floyd-Rivest samples ranges longer than this to pick two pivots close to rank k
+#define FLOYD_RIVEST_SAMPLE_CUTOFF 600
+
+// Target index for a fraction of the array (0 = minimum, 0.5 = median, 1 = maximum)
+int SelectionRank(float fraction, int n);
+
+// Introselect: median-of-three quickselect with three-way partitions; after
+// 2 * log2(n) rounds it switches to median-of-medians pivots (linear worst case)
+void QuickSelectFull(std::vector<int>& arr, int k, long long* comparisons);
+
+// Floyd-Rivest: recursively selects inside a small sample to bracket rank k tightly,
+// so the big partitions discard most of the range in one pass
+void FloydRivestFull(std::vector<int>& arr, int k, long long* comparisons);
+
+// Partial sort: a max-heap of the k + 1 smallest seen so far, then sorted in place
+void HeapTopKFull(std::vector<int>& arr, int k, long long* comparisons);
+
+#endif // SELECTION_H
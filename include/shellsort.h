@@ -0,0 +1,16 @@
+#ifndef SHELLSORT_H
+#define SHELLSORT_H
+
+#include "visualization_state.h"
+#include <vector>
+
+// Step function declared in visualization_state.h
+// bool StepShellSort(VisualizationState& state);
+
+// Ciura's gap sequence, extended by a factor of 2.25, with every gap < n (ascending)
+void BuildShellGaps(int n, std::vector<int>& gaps);
+
+// Full-speed engine. comparisons/bytesMoved may be null; when set they are incremented.
+void ShellSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved);
+
+#endif // SHELLSORT_H
@@ -0,0 +1,34 @@
+#ifndef SIMD_SUPPORT_H
+#define SIMD_SUPPORT_H
+
+// Compile-time detection of the target architecture plus a runtime CPUID query.
+// Kernels that use AVX2 are compiled per-function with ALGOWIZZ_TARGET_AVX2 so the
+// rest of the program still runs on CPUs without it; callers must check
+// CpuSupportsAVX2() before calling them.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define ALGOWIZZ_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define ALGOWIZZ_TARGET_AVX2
+    #else
+        #define ALGOWIZZ_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#else
+    #define ALGOWIZZ_X86 0
+    #define ALGOWIZZ_TARGET_AVX2
+#endif
+
+// Hint that `address` will be read soon (no-op where there is no prefetch instruction)
+#if ALGOWIZZ_X86
+    #define ALGOWIZZ_PREFETCH(address) _mm_prefetch((const char*)(address), _MM_HINT_T0)
+#elif defined(__GNUC__)
+    #define ALGOWIZZ_PREFETCH(address) __builtin_prefetch(address)
+#else
+    #define ALGOWIZZ_PREFETCH(address) ((void)(address))
+#endif
+
+// Returns true if the CPU (and OS) support AVX2. The result is cached after the first call.
+bool CpuSupportsAVX2(void);
+
+#endif // SIMD_SUPPORT_H
@@ -0,0 +1,35 @@
+#ifndef SORTINGNETWORK_H
+#define SORTINGNETWORK_H
+
+#include "visualization_state.h"
+#include <vector>
+#include <utility>
+
+// Step function declared in visualization_state.h
+// bool StepSortingNetwork(VisualizationState& state);
+
+// Largest block SortSmallWithNetwork accepts (used as the quicksort base case)
+#define NETWORK_BASE_CASE_MAX 16
+
+// Build the layers of a sorting network for n elements. Every layer is a set of
+// disjoint compare-exchanges, so a whole layer can run in parallel.
+// Bitonic uses the "flip" formulation so all comparators put the minimum first,
+// which lets sizes that aren't a power of two behave as if padded with +infinity.
+void BuildSortingNetwork(SortingNetworkKind kind, int n, std::vector<VisualizationState::NetworkLayer>& layers);
+
+// Apply every compare-exchange of one layer (AVX2 min/max when available).
+// Returns the number of comparators in the layer.
+long long ApplyNetworkLayer(int* arr, int n, const VisualizationState::NetworkLayer& layer);
+
+// List the (low, high) index pairs compared by a layer, for drawing
+void GetNetworkLayerPairs(const VisualizationState::NetworkLayer& layer, int n, std::vector<std::pair<int, int>>& pairs);
+
+// Sort at most NETWORK_BASE_CASE_MAX elements with a cached odd-even merge network
+void SortSmallWithNetwork(int* arr, int n);
+
+// Full-speed engine: builds the network and applies all layers
+void SortingNetworkFull(std::vector<int>& arr, SortingNetworkKind kind);
+
+const char* GetSortingNetworkName(SortingNetworkKind kind);
+
+#endif // SORTINGNETWORK_H
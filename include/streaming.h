@@ -0,0 +1,98 @@
+#ifndef STREAMING_H
+#define STREAMING_H
+
+#include <vector>
+#include <cstdint>
+
+// Streaming ingest: elements arrive continuously and an online structure keeps them
+// ordered. Step function (StepStreamIngest) declared in visualization_state.h.
+
+#define STREAM_MAX_ELEMENTS (1 << 20)   // The stream ends after this many arrivals
+#define STREAM_LATENCY_WINDOW 8192      // Per-element latencies kept for the percentiles
+#define STREAM_FIRST_CHECKPOINT 1024    // Latency/throughput snapshots at every doubling from here
+#define BTREE_MAX_KEYS 31               // Per node; a node is split when it would exceed this
+#define LSM_MEMTABLE_SIZE 256           // Elements buffered before a flush to level 0
+#define LSM_FANOUT 4                    // Runs per level before they are merged one level down
+
+typedef enum {
+    STREAM_TOPK_HEAP,  // Binary min-heap holding the k largest values seen
+    STREAM_BTREE,      // B+tree, leaves chained for in-order scans
+    STREAM_LSM,        // Sorted memtable + tiered sorted runs with compaction
+    STREAM_STRUCTURE_COUNT
+} StreamStructure;
+
+// B+tree node in a flat pool (indices, not pointers, so the pool can grow).
+// One slot of slack in keys/children lets an insert overflow before the split.
+struct BTreeNode {
+    int count;   // Keys in use
+    bool leaf;
+    int next;    // Leaves: next leaf to the right, -1 at the end
+    int keys[BTREE_MAX_KEYS + 1];
+    int children[BTREE_MAX_KEYS + 2];
+};
+
+struct LsmRun {
+    int level;
+    std::vector<int> keys; // Sorted
+};
+
+// Latency and throughput when the stream reached `count` elements
+struct StreamCheckpoint {
+    long long count;
+    double p50Ns;
+    double p99Ns;
+    double p999Ns;
+    double elementsPerSecond; // Ingest capacity since the previous checkpoint
+};
+
+// Bars of the view that belong to one part of the structure (LSM: memtable or one run)
+struct StreamSegment {
+    int start;
+    int length;
+    int level; // -1 = memtable
+};
+
+struct StreamIngest {
+    StreamStructure structure;
+    int arrivalRate;   // Elements per simulated second (one step = 1 / speed seconds)
+    int topK;          // Heap capacity
+    long long count;   // Elements ingested so far
+    long long bytesMoved;
+
+    std::vector<int> heap; // Min-heap: heap[0] is the smallest of the top k
+
+    std::vector<BTreeNode> nodes;
+    int root;
+    int height;
+
+    std::vector<int> memtable;
+    std::vector<LsmRun> runs; // Oldest first
+    long long compactions;
+
+    // Latency ring (timestamp ticks per element) and derived statistics
+    std::vector<uint32_t> latencies;
+    double p50Ns, p99Ns, p999Ns;
+    uint64_t ingestTicks;               // Total time spent inserting
+    uint64_t checkpointTicks;           // Since the last checkpoint
+    long long checkpointStartCount;
+    long long nextCheckpoint;
+    std::vector<StreamCheckpoint> checkpoints;
+};
+
+// Empty every structure and the statistics, keeping structure/rate/k
+void ResetStream(StreamIngest& stream);
+
+// Insert one element into the active structure (not timed)
+void StreamInsert(StreamIngest& stream, int value);
+
+// Ingest `count` arrivals, timing each insert
+void StreamIngestBatch(StreamIngest& stream, const int* values, int count);
+
+// Fill `view` (its size is kept) with an evenly spaced sample of the structure's
+// contents in its natural order; unused slots are 0. For the LSM, segments describe
+// which bars come from the memtable and from each run.
+void BuildStreamView(const StreamIngest& stream, std::vector<int>& view, std::vector<StreamSegment>& segments);
+
+const char* GetStreamStructureName(StreamStructure structure);
+
+#endif // STREAMING_H
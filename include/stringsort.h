@@ -0,0 +1,74 @@
+#ifndef STRINGSORT_H
+#define STRINGSORT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// String keys: the characters of all keys live back to back in one arena and the sort
+// moves 16-byte handles. Each handle caches the key's first 8 bytes big-endian, so most
+// decisions near the root never touch the arena. Step functions (StepMultikeyQuicksort,
+// StepMsdRadixSort) declared in visualization_state.h.
+
+#define STRING_PREFIX_BYTES 8
+#define STRING_INSERTION_CUTOFF 16 // Ranges up to this size are insertion sorted from their depth
+#define STRING_RADIX_CUTOFF 64     // MSD radix hands smaller ranges to multikey quicksort
+
+typedef enum {
+    STRING_KEYS_WORDS, // Random lowercase words, 3-12 characters
+    STRING_KEYS_URLS,  // Long shared prefixes: the cached prefix alone cannot order them
+    STRING_KEYS_IDS,   // Fixed-width decimal ids
+    STRING_KEY_KIND_COUNT
+} StringKeyKind;
+
+struct StringHandle {
+    uint32_t offset;
+    uint32_t length;
+    uint64_t prefix; // First STRING_PREFIX_BYTES bytes, zero padded: integer order = byte order
+};
+
+struct StringArena {
+    std::vector<char> bytes;
+    std::vector<StringHandle> handles; // In the current order
+    int sharedPrefix;                  // Bytes every key starts with
+    int viewMin, viewMax;              // Range of the two bytes after it (bar heights)
+};
+
+// Range of handles whose keys agree on their first `depth` bytes
+struct StringSortRange {
+    int low;
+    int high;
+    int depth;
+};
+
+// Replace the arena's contents with `count` keys of `kind`
+void GenerateStrings(StringArena& arena, int count, StringKeyKind kind);
+
+// Byte `depth` of a key, 0 past its end (keys contain no zero bytes)
+inline int StringCharAt(const StringArena& arena, const StringHandle& h, int depth) {
+    if (depth < STRING_PREFIX_BYTES) return (int)((h.prefix >> (56 - 8 * depth)) & 0xFF);
+    return depth < (int)h.length ? (unsigned char)arena.bytes[h.offset + depth] : 0;
+}
+
+// Lexicographic order: cached prefixes first, the arena only on a tie
+bool StringLess(const StringArena& arena, const StringHandle& a, const StringHandle& b);
+
+// Bar height (5..104) of a key, from the two bytes after the shared prefix
+int StringViewValue(const StringArena& arena, const StringHandle& h);
+void BuildStringView(const StringArena& arena, std::vector<int>& view);
+
+std::string GetStringKey(const StringArena& arena, const StringHandle& h);
+
+// One round of each engine on range r: the ranges left to sort are appended to `pending`.
+// `comparisons` counts character inspections.
+void MultikeyPartition(StringArena& arena, StringSortRange r, std::vector<StringSortRange>& pending, long long* comparisons);
+void MsdRadixPartition(StringArena& arena, StringSortRange r, std::vector<StringHandle>& scratch,
+                       std::vector<StringSortRange>& pending, long long* comparisons, long long* bytesMoved);
+
+// Full-speed engines over the whole arena
+void MultikeyQuicksortFull(StringArena& arena, long long* comparisons);
+void MsdRadixSortFull(StringArena& arena, long long* comparisons, long long* bytesMoved);
+
+const char* GetStringKeyKindName(StringKeyKind kind);
+
+#endif // STRINGSORT_H
@@ -2,6 +2,7 @@
 #define UI_COMPONENTS_H
 
 #include "raylib.h"
+#include <vector>
 
 // Structure for button properties using N-Patch
 typedef struct {
@@ -18,6 +19,77 @@ typedef struct {
 
 // Function to draw an N-Patch button and handle interaction
 // Returns true if the button was clicked this frame
+// (immediate mode: measures and lays out everything again on every call)
 bool DrawNButton(NButton& button);
 
-#endif // UI_COMPONENTS_H
\ No newline at end of file
+// --- Retained widgets ---
+// A UiPanel keeps its widgets from frame to frame. The 9-patch quads of a button and
+// the glyph quads of its label are built when the widget's bounds or text change, not
+// on every frame. Drawing submits every background and then every glyph, so raylib's
+// batch switches texture once per panel instead of twice per button.
+//
+// Owners set the widgets from their state in a layout function and call it only when
+// that state changed; every frame they just update and draw the panel:
+//
+//     if (layoutKeyChanged) { BeginUiLayout(panel); SetUiButton(panel, ID_PLAY, ...); ... }
+//     UpdateUiPanel(panel);
+//     if (IsUiWidgetClicked(panel, ID_PLAY)) ...
+//     DrawUiPanel(panel);
+
+typedef enum {
+    UI_WIDGET_BUTTON, // 9-patch background plus a centered label, clickable
+    UI_WIDGET_LABEL,  // Text only
+} UiWidgetKind;
+
+#define UI_LABEL_CAPACITY 64
+
+// Screen rectangle and texture coordinates of one textured quad, ready to submit
+typedef struct {
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+} UiQuad;
+
+struct UiWidget {
+    UiWidgetKind kind;
+    bool visible;
+    bool dirty;          // Quads are stale (bounds, text or texture changed)
+    Rectangle bounds;    // Labels: the text's own box
+    char label[UI_LABEL_CAPACITY];
+    int fontSize;
+    Color textColor;
+    Color tintNormal;
+    Color tintHover;
+    Color tintPressed;
+    UiQuad background[9];
+    int backgroundQuads;
+    std::vector<UiQuad> glyphs;
+};
+
+struct UiPanel {
+    std::vector<UiWidget> widgets; // Indexed by the owner's widget ids
+    Texture2D texture;             // Button backgrounds (id 0: plain rectangles)
+    NPatchInfo nPatchInfo;
+    int hovered;                   // Widget under the mouse, -1 if none
+    int clicked;                   // Widget the mouse was released over this frame, -1 if none
+    bool pressed;                  // Mouse held down over `hovered`
+};
+
+void InitUiPanel(UiPanel& panel, int widgetCount);
+// Rebuilds the backgrounds only if the texture or its patch borders differ
+void SetUiPanelTexture(UiPanel& panel, Texture2D texture, NPatchInfo nPatchInfo);
+
+// Hide every widget; the Set* calls that follow show the ones the layout wants
+void BeginUiLayout(UiPanel& panel);
+// Show a button (or label) and mark it dirty only if something about it changed
+void SetUiButton(UiPanel& panel, int id, Rectangle bounds, const char* label,
+                 Color tintNormal, Color tintHover, Color tintPressed, Color textColor, int fontSize);
+void SetUiLabel(UiPanel& panel, int id, float x, float y, const char* text, int fontSize, Color color);
+
+// Hover, press and click from the mouse, once per frame before the clicks are read
+void UpdateUiPanel(UiPanel& panel);
+inline bool IsUiWidgetClicked(const UiPanel& panel, int id) {
+    return panel.clicked == id;
+}
+void DrawUiPanel(UiPanel& panel);
+
+#endif // UI_COMPONENTS_H
@@ -2,6 +2,14 @@
 #define VISUALIZATION_STATE_H
 
 #include "raylib.h"
+#include "cachesim.h"
+#include "perfcounters.h"
+#include "streaming.h"
+#include "externalsort.h"
+#include "stringsort.h"
+#include "searchlayout.h"
+#include "graph.h"
+#include "eventstream.h"
 #include <vector>
 
 // Enum for the current state of the visualization
@@ -17,16 +25,74 @@ typedef enum {
     ALGO_NONE,
     ALGO_QUICKSORT,
     ALGO_BUBBLESORT,
-    ALGO_INSERTIONSORT
+    ALGO_INSERTIONSORT,
+    ALGO_BITONICSORT,
+    ALGO_ODDEVENMERGESORT,
+    ALGO_ODDEVENTRANSPOSITION,
+    ALGO_COCKTAILSORT,
+    ALGO_BINARYINSERTIONSORT,
+    ALGO_SHELLSORT,
+    ALGO_POWERSORT,
+    ALGO_COUNTINGSORT,
+    ALGO_RADIXSORT,
+    ALGO_HEAPSORT,     // d-ary heap (see heapsort.h); the heap tree is drawn over the bars
+    ALGO_QUICKSELECT,  // Selection engines: place rank k only (see selection.h)
+    ALGO_FLOYDRIVEST,
+    ALGO_HEAPTOPK,
+    ALGO_EXTERNALSORT, // Sorts a temp file larger than its memory cap; the bars sample it
+    ALGO_MULTIKEYQUICKSORT, // String keys (see stringsort.h); the bars show each key's leading bytes
+    ALGO_MSDRADIXSORT,
+    ALGO_STREAMING,    // Not a batch sort: elements arrive continuously (see streaming.h)
+    ALGO_BFS,          // Graph traversal (see graph.h): the graph is drawn instead of the bars
+    ALGO_DIJKSTRA,
+    ALGO_AUTO          // Menu entry only: resolved to a concrete engine by the auto selector
     // Add other algorithms here
 } AlgorithmType;
 
-// Structure to hold common visualization data and controls
+// Enum for the generated input data
+typedef enum {
+    DATA_RANDOM,
+    DATA_NEARLY_SORTED, // Sorted, then about 2% of the elements swapped at random
+    DATA_SORTED,
+    DATA_REVERSED,
+    DATA_SAWTOOTH,      // A handful of ascending runs
+    DATA_FEW_UNIQUE,    // Only 5 distinct values
+    DATA_DISTRIBUTION_COUNT
+} DataDistribution;
+
+// Enum for the quicksort partition kernel
+typedef enum {
+    PARTITION_SCALAR,     // Branchy compare-and-swap loop
+    PARTITION_BRANCHLESS, // Unconditional swap, index advanced by the comparison result
+    PARTITION_AVX2,       // Vectorized compress-store (falls back to branchless without AVX2)
+    PARTITION_KERNEL_COUNT
+} PartitionKernel;
+
+// Enum for the sorting network construction
+typedef enum {
+    NETWORK_BITONIC,
+    NETWORK_ODDEVEN_MERGE
+} SortingNetworkKind;
+
+// Cheap statistics of an input, computed from a strided sample
 typedef struct {
+    int sampleSize;
+    int minValue;         // Over the sample
+    int maxValue;
+    long long range;      // maxValue - minValue + 1
+    float duplicateRatio; // Fraction of sampled values equal to another sampled value
+    float sortedness;     // Fraction of sampled adjacent pairs with a[i] <= a[i + 1]
+    float reversedness;   // Fraction of sampled adjacent pairs with a[i] > a[i + 1]
+    long long estimatedRuns; // Ascending runs extrapolated from the sampled descents
+} InputProfile;
+
+// Structure to hold common visualization data and controls
+typedef struct VisualizationState {
     std::vector<int> array; // Use std::vector for easier management
     int size;
     VisualizationStatus status;
     AlgorithmType currentAlgorithm;
+    DataDistribution distribution;
 
     // Control parameters
     float speed; // Steps per second
@@ -40,15 +106,154 @@ typedef struct {
     int highlightStart; // Range highlighting
     int highlightEnd;
 
-    // For Quicksort's recursive nature (simplified state for this example)
+    // Operation counters, reset with the array
+    long long stepCount;
+    long long comparisons;
+    long long swaps;
+    long long bytesMoved; // Bytes written by shifts, block moves and swaps (two ints each)
+
+    // For the bubble family (bubble, cocktail shaker, odd-even transposition)
+    bool earlyExit;        // Stop after a full pass (or odd+even phase pair) without swaps
+    bool swappedThisPass;
+    int passDirection;     // Cocktail shaker: 1 = forward, -1 = backward
+    int passLow;           // Cocktail shaker: unsorted range [passLow, passHigh]
+    int passHigh;
+    int oddEvenPhase;      // Odd-even transposition: phases completed (parity = phase & 1)
+    int quietPhases;       // Odd-even transposition: consecutive phases without swaps
+
+    // For the insertion family (insertion, binary insertion, Shell sort)
+    int heldValue;                // Key lifted out of the array while its slot is shifted over
+    std::vector<int> gapSequence; // Shell sort gaps, ascending
+    int gapIndex;                 // Current gap (counts down to 0)
+
+    // For Powersort: natural runs and the merge stack
+    struct SortedRun {
+        int start;
+        int length;
+        int power; // Powersort node power of the boundary after this run
+    };
+    std::vector<SortedRun> runStack;
+    SortedRun activeRun;  // Run A: most recent run, not yet on the stack
+    SortedRun pendingRun; // Run B: detected, waiting for the stack to settle (length 0 if none)
+    int minRun;
+    int minGallop;
+
+    // For counting and radix sort
+    int sortPhase;           // Engine-specific phase (see countingsort.cpp / radixsort.cpp)
+    std::vector<int> counts; // Histogram / bucket offsets
+    int countMin;            // Smallest value; keys are biased by it
+    int radixShift;          // Current digit position in bits
+    unsigned int radixMaxKey;
+    bool countingFallback;   // Counting sort: range too wide this run, the radix steps sort it
+
+    // Heapsort: arity of the heap and the nodes the last sift went through
+    int heapArity;
+    bool heapPrefetch;             // Full-speed engine: prefetch the grandchildren
+    std::vector<int> heapPath;
+
+    // Selection engines: target rank k and the window that still contains it
+    float selectFraction;  // k as a fraction of n (0.5 = median)
+    int selectRank;
+    int selectLow;
+    int selectHigh;
+    int selectRounds;      // Quickselect partition rounds so far
+    bool selectFallback;   // Quickselect switched to median-of-medians pivots
+    struct SelectFrame {
+        int low;
+        int high;
+        bool sampled;      // Floyd-Rivest: the sample bracket for this pass was already selected
+    };
+    std::vector<SelectFrame> selectFrames; // Floyd-Rivest recursion
+
+    // Auto mode: the engine was chosen by sampling the input
+    bool autoSelect;
+    InputProfile autoProfile;
+    const char* autoReason;
+
+    // Streaming ingest: the online structures and the bars' origin in them (LSM)
+    StreamIngest stream;
+    std::vector<StreamSegment> streamSegments;
+
+    // String sorting: keys in an arena, the ranges still to sort and the depth of the last one
+    StringArena strings;
+    StringKeyKind stringKind;
+    std::vector<StringSortRange> stringRanges;
+    std::vector<StringHandle> stringScratch; // MSD radix distribution buffer
+    int stringDepth;
+
+    // External merge sort: the job owns the temp files and the I/O in flight
+    ExternalSortJob externalSort;
+
+    // Graph traversal: one vertex per array element (or a loaded edge list)
+    CsrGraph graph;
+    GraphKind graphKind;
+    int graphSource;
+    bool bfsDirectionOptimizing;
+    DijkstraQueue dijkstraQueue;
+    BfsSearch bfs;
+    DijkstraSearch dijkstra;
+
+    // Lookup phase after a finished sort: queries traced against one search layout
+    bool lookupMode;
+    SearchLayouts searchLayouts;
+    SearchLayoutKind lookupLayout;
+    int lookupQuery;
+    int lookupCount;                      // Queries traced so far
+    std::vector<SearchProbe> lookupProbes; // Probes of the last query
+    std::vector<LookupResult> lookupResults; // Last lookup benchmark
+
+    // Memory tracing: engines report array accesses to a cache simulator and a per-index heatmap
+    bool memoryTrace;
+    CacheSimulator cacheSim;
+    std::vector<unsigned int> accessCounts; // Accesses per array index since the last reset
+
+    // Shared-memory event stream (F5): steps, traced accesses and array snapshots for local tools
+    EventStream eventStream;
+
+    // Quicksort: the range being worked on plus the pending larger sides. Always
+    // continuing with the smaller side bounds the pending frames by log2(n), so the
+    // arena is sized once per array size and never grows during a run.
     struct QuickSortStackFrame {
         int low;
         int high;
-        int stage; // 0: initial, 1: partitioning, 2: after partition (before left call), 3: after left call (before right call), 4: done
+        int stage; // -1: no range (finished), 0: partition next, 1: partitioned, split next
         int partitionIndex; // Store result of partition
     };
-    std::vector<QuickSortStackFrame> quickSortStack;
+    QuickSortStackFrame quickSortCurrent;
+    std::vector<QuickSortStackFrame> quickSortArena; // Fixed capacity (see QuickSortStackCapacity)
+    int quickSortDepth;    // Pending frames in the arena
+    int quickSortMaxDepth; // Deepest the arena got during this run
+    PartitionKernel partitionKernel;
+    bool useNetworkBaseCase; // Sort small quicksort ranges with a sorting network in one step
 
+    // For sorting networks: one layer of disjoint compare-exchanges per step
+    struct NetworkLayer {
+        int type;     // Layer construction (see sortingnetwork.cpp)
+        int size;     // Block size / merge round
+        int distance; // Distance between compared elements
+    };
+    std::vector<NetworkLayer> networkLayers;
+    int networkLayerIndex; // Next layer to apply
+
+    // Scratch memory shared by kernels that need an out-of-place buffer
+    std::vector<int> scratchBuffer;
+
+    // Wall-clock time of the last full-speed run in seconds (-1 if none)
+    double fullSpeedSeconds;
+    PerfSample fullSpeedCounters; // Hardware counters of that run
+
+    // Last benchmark sweep of the current algorithm (cleared on reset)
+    struct BenchmarkResult {
+        AlgorithmType algorithm; // Differs per row in Auto mode and in the selection sweep
+        DataDistribution distribution;
+        int size;
+        int rank;                // Selection sweep: target rank k (-1 for sorts)
+        const char* inputName;   // String sweep: key kind instead of a distribution (nullptr otherwise)
+        const char* engineName;  // Baselines without an AlgorithmType (nullptr otherwise)
+        double seconds;          // Fastest of the repetitions
+        PerfSample counters;     // Counters of that repetition
+    };
+    std::vector<BenchmarkResult> benchmarkResults;
 
 } VisualizationState;
 
@@ -60,19 +265,90 @@ void InitializeVisualizationState(VisualizationState& state, int arraySize);
 // Reset the array and state
 void ResetVisualizationState(VisualizationState& state);
 
+// Fill the array with values from 5 to 104 following the selected distribution
+void GenerateArrayData(std::vector<int>& array, DataDistribution distribution);
+const char* GetDistributionName(DataDistribution distribution);
+
+// Change the array size and reset (keeps the selected algorithm)
+void ResizeVisualizationState(VisualizationState& state, int arraySize);
+
+// Enter the lookup phase on the (sorted) bars: build the search layouts and pause
+// before the first traced query. Leaves when the state is reset.
+void StartLookup(VisualizationState& state);
+
 // Update the visualization (advances one step if needed)
 void UpdateVisualization(VisualizationState& state, float deltaTime);
 
+// Advance the current algorithm by one step. Returns true if it is still running
+bool StepAlgorithm(VisualizationState& state);
+
+// Display name of an algorithm
+const char* GetAlgorithmName(AlgorithmType algorithm);
+
 // Draw the visualization panel (bars, indices)
 void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds);
 
 // Draw the control panel (buttons, sliders)
 void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D buttonTexture, NPatchInfo buttonNpatchInfo);
 
+// Run the full-speed engine for `algorithm` on `array`, with the engine options
+// (partition kernel, early exit, ...) taken from `options`. Returns false if there is none
+// (or if it failed, which only the external sort can).
+bool RunFullSpeedEngine(AlgorithmType algorithm, const VisualizationState& options, std::vector<int>& array,
+                        long long* comparisons, long long* bytesMoved);
+
+// Sort the remaining array at full speed (no visualization steps) and mark it finished.
+// Returns false if the current algorithm has no full-speed engine.
+bool RunAlgorithmFullSpeed(VisualizationState& state);
+
 // --- Algorithm Step Functions (to be called by UpdateVisualization) ---
 // Returns true if the algorithm is still running
 bool StepQuickSort(VisualizationState& state);
 bool StepBubbleSort(VisualizationState& state);
 bool StepInsertionSort(VisualizationState& state);
+bool StepSortingNetwork(VisualizationState& state);
+bool StepOddEvenTranspositionSort(VisualizationState& state);
+bool StepCocktailSort(VisualizationState& state);
+bool StepBinaryInsertionSort(VisualizationState& state);
+bool StepShellSort(VisualizationState& state);
+bool StepPowersort(VisualizationState& state);
+bool StepCountingSort(VisualizationState& state);
+bool StepRadixSort(VisualizationState& state);
+bool StepHeapSort(VisualizationState& state);
+bool StepQuickSelect(VisualizationState& state);
+bool StepFloydRivest(VisualizationState& state);
+bool StepHeapTopK(VisualizationState& state);
+bool StepStreamIngest(VisualizationState& state);
+bool StepExternalSort(VisualizationState& state);
+bool StepMultikeyQuicksort(VisualizationState& state);
+bool StepMsdRadixSort(VisualizationState& state);
+bool StepLookup(VisualizationState& state);
+bool StepBfs(VisualizationState& state);
+bool StepDijkstra(VisualizationState& state);
+
+// --- Event Stream ---
+// Open or close the shared-memory stream; opening publishes a reset and a snapshot of the
+// current array so a reader starts from a known state.
+void SetEventStreamEnabled(VisualizationState& state, bool enabled);
+
+// --- Memory Tracing ---
+// Engines call these for the accesses they make; with memoryTrace and the event stream
+// both off they cost two well-predicted branches.
+void RecordMemoryAccess(VisualizationState& state, MemoryRegion region, int index, bool isWrite);
+void RecordMemoryRange(VisualizationState& state, MemoryRegion region, int begin, int end, bool isWrite);
+
+inline void TraceRead(VisualizationState& state, int index) {
+    if (state.memoryTrace || state.eventStream.active) RecordMemoryAccess(state, MEM_REGION_ARRAY, index, false);
+}
+inline void TraceWrite(VisualizationState& state, int index) {
+    if (state.memoryTrace || state.eventStream.active) RecordMemoryAccess(state, MEM_REGION_ARRAY, index, true);
+}
+inline void TraceAccess(VisualizationState& state, MemoryRegion region, int index, bool isWrite) {
+    if (state.memoryTrace || state.eventStream.active) RecordMemoryAccess(state, region, index, isWrite);
+}
+// Sequential accesses to [begin, end), for kernels that work on raw pointers
+inline void TraceRange(VisualizationState& state, MemoryRegion region, int begin, int end, bool isWrite) {
+    if (state.memoryTrace || state.eventStream.active) RecordMemoryRange(state, region, begin, end, isWrite);
+}
 
 #endif // VISUALIZATION_STATE_H
\ No newline at end of file
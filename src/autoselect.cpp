@@ -0,0 +1,72 @@
+#include "autoselect.h"
+#include "countingsort.h"
+#include <algorithm> // For std::sort, std::min, std::max
+
+InputProfile ProfileInput(const std::vector<int>& array) {
+    InputProfile profile = {};
+    int n = (int)array.size();
+    if (n == 0) return profile;
+
+    int samples = std::min(n, AUTO_SAMPLE_SIZE);
+    long long stride = std::max(1, n / samples);
+    std::vector<int> sample;
+    sample.reserve(samples);
+
+    int ascending = 0;
+    int descending = 0;
+    int pairs = 0;
+    for (int s = 0; s < samples; s++) {
+        int i = (int)(s * stride);
+        sample.push_back(array[i]);
+        // Presortedness is measured on true neighbours, not on strided samples
+        if (i + 1 < n) {
+            pairs++;
+            if (array[i] <= array[i + 1]) ascending++;
+            else descending++;
+        }
+    }
+
+    profile.sampleSize = samples;
+    profile.sortedness = pairs ? (float)ascending / pairs : 1.0f;
+    profile.reversedness = pairs ? (float)descending / pairs : 0.0f;
+    // Every descent starts a new ascending run
+    profile.estimatedRuns = 1 + (long long)(profile.reversedness * (n - 1));
+
+    std::sort(sample.begin(), sample.end());
+    profile.minValue = sample.front();
+    profile.maxValue = sample.back();
+    profile.range = (long long)profile.maxValue - profile.minValue + 1;
+    int duplicates = 0;
+    for (int s = 1; s < samples; s++) {
+        if (sample[s] == sample[s - 1]) duplicates++;
+    }
+    profile.duplicateRatio = (samples > 1) ? (float)duplicates / (samples - 1) : 0.0f;
+    return profile;
+}
+
+AlgorithmType ChooseAlgorithm(const InputProfile& profile, int n, const char** reason) {
+    const char* why;
+    AlgorithmType choice;
+
+    if (profile.sortedness >= 0.99f || profile.reversedness >= 0.99f) {
+        // A few long runs: run detection alone does almost all the work
+        choice = ALGO_POWERSORT;
+        why = "Almost fully sorted: a few natural runs";
+    } else if (profile.range <= std::max(n, 256) || (profile.duplicateRatio >= 0.5f && profile.range <= COUNTING_SORT_MAX_RANGE / 16)) {
+        // The sample's range can miss outliers; counting sort re-measures the exact range
+        choice = ALGO_COUNTINGSORT;
+        why = "Narrow value range: counting sort is linear";
+    } else if (profile.range <= (1LL << 16)) {
+        choice = ALGO_RADIXSORT;
+        why = "Range fits in 16 bits: few radix passes";
+    } else if (profile.sortedness >= 0.9f || profile.reversedness >= 0.9f || profile.estimatedRuns <= n / 64) {
+        choice = ALGO_POWERSORT;
+        why = "Nearly sorted: merging natural runs";
+    } else {
+        choice = ALGO_QUICKSORT;
+        why = "No exploitable structure: quicksort";
+    }
+
+    if (reason) *reason = why;
+    return choice;
+}
@@ -0,0 +1,373 @@
+#include "benchmark.h"
+#include "autoselect.h"
+#include "selection.h"
+#include "stringsort.h"
+#include "searchlayout.h"
+#include "graph.h"
+#include "profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>  // For rand()
+
+static const int benchmarkSizes[BENCHMARK_SIZE_COUNT] = { 1000, 10000, 100000 };
+static const int lookupSizes[LOOKUP_BENCHMARK_SIZE_COUNT] = { 1 << 12, 1 << 16, 1 << 20, 1 << 22 };
+static const int graphSizes[GRAPH_BENCHMARK_SIZE_COUNT] = { 1 << 16, 1 << 20 };
+static const int heapSizes[HEAP_BENCHMARK_SIZE_COUNT] = { 1 << 14, 1 << 17, 1 << 20 };
+static const float selectionFractions[SELECTION_BENCHMARK_RANK_COUNT] = { 0.001f, 0.01f, 0.1f, 0.5f, 0.9f };
+
+static bool IsQuadratic(AlgorithmType algorithm) {
+    return algorithm == ALGO_BUBBLESORT || algorithm == ALGO_COCKTAILSORT || algorithm == ALGO_ODDEVENTRANSPOSITION ||
+           algorithm == ALGO_INSERTIONSORT || algorithm == ALGO_BINARYINSERTIONSORT;
+}
+
+bool IsSelectionAlgorithm(AlgorithmType algorithm) {
+    return algorithm == ALGO_QUICKSELECT || algorithm == ALGO_FLOYDRIVEST || algorithm == ALGO_HEAPTOPK;
+}
+
+bool IsStringAlgorithm(AlgorithmType algorithm) {
+    return algorithm == ALGO_MULTIKEYQUICKSORT || algorithm == ALGO_MSDRADIXSORT;
+}
+
+bool IsGraphAlgorithm(AlgorithmType algorithm) {
+    return algorithm == ALGO_BFS || algorithm == ALGO_DIJKSTRA;
+}
+
+// Best of BENCHMARK_REPETITIONS calls of `run` (returns false if it could not run, which
+// ends the timing). `prepare` resets the input before each call, outside the timed region.
+// The fastest time and the counters of that call go to seconds and sample.
+template <typename Prepare, typename Run>
+static bool TimeEngine(PerfCounterSet& counters, Prepare prepare, Run run, double& seconds, PerfSample& sample) {
+    seconds = -1.0;
+    for (int rep = 0; rep < BENCHMARK_REPETITIONS; rep++) {
+        PROFILE_ZONE("Benchmark run");
+        prepare();
+        PerfSample repSample;
+
+        StartPerfCounters(counters);
+        auto start = std::chrono::steady_clock::now();
+        bool ran = run();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        StopPerfCounters(counters, repSample);
+
+        if (!ran) return false;
+        if (seconds < 0.0 || elapsed.count() < seconds) {
+            seconds = elapsed.count();
+            sample = repSample;
+        }
+    }
+    return true;
+}
+
+// `algorithm`'s full-speed engine on copies of `input`, configured by `options`. Sweeps
+// over an option (k, heap arity, prefetch) set it on the state for each run and restore
+// the user's choice afterwards. Returns false if the algorithm has no full-speed engine.
+static bool TimeFullSpeedEngine(AlgorithmType algorithm, const VisualizationState& options, const std::vector<int>& input,
+                                std::vector<int>& work, PerfCounterSet& counters, VisualizationState::BenchmarkResult& result) {
+    return TimeEngine(counters, [&] { work = input; },
+                      [&] {
+                          long long comparisons = 0;
+                          long long bytesMoved = 0;
+                          return RunFullSpeedEngine(algorithm, options, work, &comparisons, &bytesMoved);
+                      },
+                      result.seconds, result.counters);
+}
+
+void RunBenchmarkSweep(VisualizationState& state) {
+    state.benchmarkResults.clear();
+
+    // One set of counters for the whole sweep; the fds are reset before every run
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    std::vector<int> input;
+    std::vector<int> work;
+    for (int d = 0; d < DATA_DISTRIBUTION_COUNT; d++) {
+        for (int s = 0; s < BENCHMARK_SIZE_COUNT; s++) {
+            int size = benchmarkSizes[s];
+            input.resize(size);
+            GenerateArrayData(input, (DataDistribution)d);
+
+            AlgorithmType algorithm = state.currentAlgorithm;
+            if (state.autoSelect) {
+                const char* reason = "";
+                algorithm = ChooseAlgorithm(ProfileInput(input), size, &reason);
+            }
+            if (IsQuadratic(algorithm) && size > BENCHMARK_QUADRATIC_MAX_SIZE) continue;
+
+            VisualizationState::BenchmarkResult result = {};
+            result.algorithm = algorithm;
+            result.distribution = (DataDistribution)d;
+            result.size = size;
+            result.rank = -1;
+            if (!TimeFullSpeedEngine(algorithm, state, input, work, counters, result)) {
+                ClosePerfCounters(counters);
+                return; // No full-speed engine: nothing to benchmark
+            }
+            state.benchmarkResults.push_back(result);
+        }
+    }
+
+    ClosePerfCounters(counters);
+}
+
+void RunSelectionBenchmark(VisualizationState& state) {
+    // The quicksort baseline is QuickSortFull, which stays n log n on Few-Unique and the
+    // other duplicate-heavy distributions, so it needs no size cap here
+    static const AlgorithmType engines[] = { ALGO_QUICKSELECT, ALGO_FLOYDRIVEST, ALGO_HEAPTOPK, ALGO_QUICKSORT };
+    state.benchmarkResults.clear();
+
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    std::vector<int> input(SELECTION_BENCHMARK_SIZE);
+    std::vector<int> work;
+    GenerateArrayData(input, state.distribution);
+
+    float selectFraction = state.selectFraction;
+    for (int f = 0; f < SELECTION_BENCHMARK_RANK_COUNT; f++) {
+        state.selectFraction = selectionFractions[f];
+        for (AlgorithmType algorithm : engines) {
+            VisualizationState::BenchmarkResult result = {};
+            result.algorithm = algorithm;
+            result.distribution = state.distribution;
+            result.size = SELECTION_BENCHMARK_SIZE;
+            result.rank = SelectionRank(state.selectFraction, SELECTION_BENCHMARK_SIZE);
+            TimeFullSpeedEngine(algorithm, state, input, work, counters, result);
+            state.benchmarkResults.push_back(result);
+        }
+    }
+    state.selectFraction = selectFraction;
+
+    ClosePerfCounters(counters);
+}
+
+// String engines of the sweep; the last two are std::sort baselines
+typedef enum {
+    STRING_ENGINE_MULTIKEY,
+    STRING_ENGINE_MSD_RADIX,
+    STRING_ENGINE_STD_HANDLES, // std::sort over the arena handles (cached-prefix compare)
+    STRING_ENGINE_STD_STRING,  // std::sort over std::vector<std::string>
+    STRING_ENGINE_COUNT
+} StringEngine;
+
+void RunStringBenchmark(VisualizationState& state) {
+    state.benchmarkResults.clear();
+
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    StringArena input;
+    StringArena work;
+    std::vector<std::string> inputStrings;
+    std::vector<std::string> workStrings;
+    for (int kind = 0; kind < STRING_KEY_KIND_COUNT; kind++) {
+        for (int s = 0; s < BENCHMARK_SIZE_COUNT; s++) {
+            int size = benchmarkSizes[s];
+            GenerateStrings(input, size, (StringKeyKind)kind);
+            inputStrings.clear();
+            for (const StringHandle& h : input.handles) inputStrings.push_back(GetStringKey(input, h));
+
+            for (int engine = 0; engine < STRING_ENGINE_COUNT; engine++) {
+                VisualizationState::BenchmarkResult result = {};
+                result.algorithm = (engine == STRING_ENGINE_MSD_RADIX) ? ALGO_MSDRADIXSORT : ALGO_MULTIKEYQUICKSORT;
+                if (engine == STRING_ENGINE_STD_HANDLES) result.engineName = "std::sort handles";
+                if (engine == STRING_ENGINE_STD_STRING) result.engineName = "std::sort string";
+                result.inputName = GetStringKeyKindName((StringKeyKind)kind);
+                result.size = size;
+                result.rank = -1;
+
+                auto prepare = [&] {
+                    work = input;
+                    workStrings = inputStrings;
+                };
+                auto run = [&] {
+                    long long comparisons = 0;
+                    long long bytesMoved = 0;
+                    switch (engine) {
+                        case STRING_ENGINE_MULTIKEY:
+                            MultikeyQuicksortFull(work, &comparisons);
+                            break;
+                        case STRING_ENGINE_MSD_RADIX:
+                            MsdRadixSortFull(work, &comparisons, &bytesMoved);
+                            break;
+                        case STRING_ENGINE_STD_HANDLES:
+                            std::sort(work.handles.begin(), work.handles.end(),
+                                      [&work](const StringHandle& a, const StringHandle& b) { return StringLess(work, a, b); });
+                            break;
+                        default:
+                            std::sort(workStrings.begin(), workStrings.end());
+                            break;
+                    }
+                    return true;
+                };
+                TimeEngine(counters, prepare, run, result.seconds, result.counters);
+                state.benchmarkResults.push_back(result);
+            }
+        }
+    }
+
+    ClosePerfCounters(counters);
+}
+
+// Times every layout on `layouts` and appends one row per layout and prefetch setting
+static void TimeLookups(VisualizationState& state, const SearchLayouts& layouts, const std::vector<int>& queries,
+                        std::vector<int>& results, PerfCounterSet& counters) {
+    for (int kind = 0; kind < SEARCH_LAYOUT_COUNT; kind++) {
+        for (int prefetch = 0; prefetch < 2; prefetch++) {
+            if (kind == SEARCH_BINARY && prefetch) continue; // The branchy search has no prefetching variant
+            LookupResult result = {};
+            result.layout = (SearchLayoutKind)kind;
+            result.prefetch = prefetch != 0;
+            result.size = layouts.n;
+            double seconds = -1.0;
+            TimeEngine(counters, [] {},
+                       [&] {
+                           RunSearchQueries(layouts, result.layout, result.prefetch, queries.data(), (int)queries.size(), results.data());
+                           return true;
+                       },
+                       seconds, result.counters);
+            result.nsPerQuery = seconds * 1e9 / queries.size();
+            state.lookupResults.push_back(result);
+        }
+    }
+}
+
+void RunLookupBenchmark(VisualizationState& state) {
+    state.lookupResults.clear();
+    if (state.searchLayouts.n == 0) return;
+
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    // Queries cover the key range plus a little on both sides, so some miss at each end
+    std::vector<int> queries(LOOKUP_BENCHMARK_QUERIES);
+    std::vector<int> results(LOOKUP_BENCHMARK_QUERIES);
+    const std::vector<int>& sorted = state.searchLayouts.sorted;
+    int low = sorted.front() - 2;
+    int span = sorted.back() + 2 - low + 1;
+    for (int& q : queries) q = low + rand() % span;
+    TimeLookups(state, state.searchLayouts, queries, results, counters);
+
+    // Larger arrays of distinct odd keys: half the queries hit, half fall between keys
+    SearchLayouts layouts;
+    std::vector<int> keys;
+    for (int s = 0; s < LOOKUP_BENCHMARK_SIZE_COUNT; s++) {
+        int size = lookupSizes[s];
+        keys.resize(size);
+        for (int i = 0; i < size; i++) keys[i] = 2 * i + 1;
+        BuildSearchLayouts(layouts, keys, false);
+        for (int& q : queries) q = (int)(((unsigned int)rand() * (RAND_MAX + 1u) + (unsigned int)rand()) % (unsigned int)(2 * size + 2));
+        TimeLookups(state, layouts, queries, results, counters);
+    }
+
+    ClosePerfCounters(counters);
+}
+
+// Graph engines of the sweep
+typedef enum {
+    GRAPH_ENGINE_BFS_TOP_DOWN,
+    GRAPH_ENGINE_BFS_DIRECTION_OPTIMIZING,
+    GRAPH_ENGINE_DIJKSTRA_BINARY,
+    GRAPH_ENGINE_DIJKSTRA_RADIX,
+    GRAPH_ENGINE_COUNT
+} GraphEngine;
+
+void RunGraphBenchmark(VisualizationState& state) {
+    static const char* engineNames[GRAPH_ENGINE_COUNT] = { "BFS top-down", "BFS direction-opt", "Dijkstra binary heap", "Dijkstra radix heap" };
+    state.benchmarkResults.clear();
+
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    CsrGraph graph;
+    BfsSearch bfs;
+    DijkstraSearch dijkstra;
+    for (int kind = 0; kind < GRAPH_FILE; kind++) {
+        for (int s = 0; s < GRAPH_BENCHMARK_SIZE_COUNT; s++) {
+            GenerateGraph(graph, (GraphKind)kind, graphSizes[s]);
+            int source = PickGraphSource(graph);
+            for (int engine = 0; engine < GRAPH_ENGINE_COUNT; engine++) {
+                VisualizationState::BenchmarkResult result = {};
+                result.algorithm = (engine <= GRAPH_ENGINE_BFS_DIRECTION_OPTIMIZING) ? ALGO_BFS : ALGO_DIJKSTRA;
+                result.engineName = engineNames[engine];
+                result.inputName = GetGraphKindName((GraphKind)kind);
+                result.size = (int)graph.targets.size(); // Counters per edge
+                result.rank = -1;
+
+                // Allocation is outside the timed region; only the traversal counts
+                auto prepare = [&] {
+                    if (result.algorithm == ALGO_BFS) StartBfs(bfs, graph, source, engine == GRAPH_ENGINE_BFS_DIRECTION_OPTIMIZING);
+                    else StartDijkstra(dijkstra, graph, source, engine == GRAPH_ENGINE_DIJKSTRA_RADIX ? DIJKSTRA_RADIX_HEAP : DIJKSTRA_BINARY_HEAP);
+                };
+                auto run = [&] {
+                    if (result.algorithm == ALGO_BFS) {
+                        while (BfsLevel(bfs, graph, nullptr)) {}
+                    } else {
+                        while (DijkstraSettleNext(dijkstra, graph, nullptr)) {}
+                    }
+                    return true;
+                };
+                TimeEngine(counters, prepare, run, result.seconds, result.counters);
+                state.benchmarkResults.push_back(result);
+            }
+        }
+    }
+
+    ClosePerfCounters(counters);
+}
+
+void RunHeapBenchmark(VisualizationState& state) {
+    static const int arities[] = { 2, 4, 8 };
+    static const char* engineNames[][2] = { { "Binary heap", "Binary heap + pf" },
+                                            { "4-ary heap", "4-ary heap + pf" },
+                                            { "8-ary heap", "8-ary heap + pf" } };
+    state.benchmarkResults.clear();
+
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+
+    std::vector<int> input;
+    std::vector<int> work;
+    int heapArity = state.heapArity;
+    bool heapPrefetch = state.heapPrefetch;
+    for (int s = 0; s < HEAP_BENCHMARK_SIZE_COUNT; s++) {
+        int size = heapSizes[s];
+        input.resize(size);
+        GenerateArrayData(input, state.distribution);
+
+        for (int a = 0; a < (int)(sizeof(arities) / sizeof(arities[0])); a++) {
+            for (int prefetch = 0; prefetch < 2; prefetch++) {
+                state.heapArity = arities[a];
+                state.heapPrefetch = prefetch != 0;
+                VisualizationState::BenchmarkResult result = {};
+                result.algorithm = ALGO_HEAPSORT;
+                result.engineName = engineNames[a][prefetch];
+                result.distribution = state.distribution;
+                result.size = size;
+                result.rank = -1;
+                TimeFullSpeedEngine(ALGO_HEAPSORT, state, input, work, counters, result);
+                state.benchmarkResults.push_back(result);
+            }
+        }
+
+        // Baseline: the standard library's binary heap
+        VisualizationState::BenchmarkResult result = {};
+        result.algorithm = ALGO_HEAPSORT;
+        result.engineName = "std::sort_heap";
+        result.distribution = state.distribution;
+        result.size = size;
+        result.rank = -1;
+        TimeEngine(counters, [&] { work = input; },
+                   [&] {
+                       std::make_heap(work.begin(), work.end());
+                       std::sort_heap(work.begin(), work.end());
+                       return true;
+                   },
+                   result.seconds, result.counters);
+        state.benchmarkResults.push_back(result);
+    }
+    state.heapArity = heapArity;
+    state.heapPrefetch = heapPrefetch;
+
+    ClosePerfCounters(counters);
+}
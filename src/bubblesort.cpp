@@ -8,6 +8,7 @@ bool StepBubbleSort(VisualizationState& state) {
     if (state.primaryIndex == -1) { // Initialize loops
         state.primaryIndex = 0; // i = 0
         state.secondaryIndex = 0; // j = 0
+        state.swappedThisPass = false;
     }
 
     int i = state.primaryIndex;
@@ -24,17 +25,124 @@ bool StepBubbleSort(VisualizationState& state) {
     // Perform one comparison/swap
     if (j < n - i - 1) {
         state.tertiaryIndex = j + 1; // Highlight comparison element
+        state.comparisons++;
+        TraceRead(state, j);
+        TraceRead(state, j + 1);
         if (state.array[j] > state.array[j + 1]) {
             std::swap(state.array[j], state.array[j + 1]);
-            // Optionally add a flag for swap visualization
+            TraceWrite(state, j);
+            TraceWrite(state, j + 1);
+            state.swaps++;
+            state.bytesMoved += 2 * sizeof(int);
+            state.swappedThisPass = true;
         }
         state.secondaryIndex++; // Move j forward
     } else {
-        // Inner loop finished, move to next outer loop iteration
+        // Inner loop finished; a pass without swaps means the array is sorted
+        if (state.earlyExit && !state.swappedThisPass) {
+            state.status = VIZ_STATE_FINISHED;
+            state.primaryIndex = -1;
+            state.secondaryIndex = -1;
+            state.tertiaryIndex = -1;
+            return false;
+        }
+        // Move to next outer loop iteration
         state.primaryIndex++;
         state.secondaryIndex = 0; // Reset j
         state.tertiaryIndex = -1; // Clear comparison highlight
+        state.swappedThisPass = false;
     }
 
     return true; // Still sorting
-}
\ No newline at end of file
+}
+
+// Cocktail shaker sort: bubble passes alternate direction, so small elements near
+// the end ("turtles") move to the front in one backward pass instead of n forward ones.
+// passLow/passHigh = unsorted range, secondaryIndex = j, passDirection = current direction
+bool StepCocktailSort(VisualizationState& state) {
+    if (state.passLow >= state.passHigh) {
+        state.status = VIZ_STATE_FINISHED;
+        state.secondaryIndex = -1;
+        state.tertiaryIndex = -1;
+        return false; // Sort finished
+    }
+
+    int j = state.secondaryIndex;
+    bool forward = (state.passDirection > 0);
+    bool passDone = forward ? (j >= state.passHigh) : (j < state.passLow);
+
+    if (!passDone) {
+        state.tertiaryIndex = j + 1; // Highlight comparison element
+        state.comparisons++;
+        TraceRead(state, j);
+        TraceRead(state, j + 1);
+        if (state.array[j] > state.array[j + 1]) {
+            std::swap(state.array[j], state.array[j + 1]);
+            TraceWrite(state, j);
+            TraceWrite(state, j + 1);
+            state.swaps++;
+            state.bytesMoved += 2 * sizeof(int);
+            state.swappedThisPass = true;
+        }
+        state.secondaryIndex += forward ? 1 : -1;
+        return true;
+    }
+
+    // End of a pass: the largest (forward) or smallest (backward) element is in place
+    if (forward) state.passHigh--;
+    else state.passLow++;
+
+    if ((state.earlyExit && !state.swappedThisPass) || state.passLow >= state.passHigh) {
+        state.passLow = state.passHigh; // Everything is sorted
+        state.status = VIZ_STATE_FINISHED;
+        state.secondaryIndex = -1;
+        state.tertiaryIndex = -1;
+        return false;
+    }
+
+    state.passDirection = -state.passDirection;
+    state.secondaryIndex = forward ? state.passHigh - 1 : state.passLow;
+    state.tertiaryIndex = -1;
+    state.swappedThisPass = false;
+    return true;
+}
+
+void BubbleSortFull(std::vector<int>& arr, bool earlyExit) {
+    int n = (int)arr.size();
+    for (int i = 0; i < n - 1; i++) {
+        bool swapped = false;
+        for (int j = 0; j < n - i - 1; j++) {
+            if (arr[j] > arr[j + 1]) {
+                std::swap(arr[j], arr[j + 1]);
+                swapped = true;
+            }
+        }
+        if (earlyExit && !swapped) break;
+    }
+}
+
+void CocktailSortFull(std::vector<int>& arr, bool earlyExit) {
+    int low = 0;
+    int high = (int)arr.size() - 1;
+    while (low < high) {
+        bool swapped = false;
+        for (int j = low; j < high; j++) {
+            if (arr[j] > arr[j + 1]) {
+                std::swap(arr[j], arr[j + 1]);
+                swapped = true;
+            }
+        }
+        high--;
+        if (earlyExit && !swapped) break;
+
+        swapped = false;
+        for (int j = high - 1; j >= low; j--) {
+            if (arr[j] > arr[j + 1]) {
+                std::swap(arr[j], arr[j + 1]);
+                swapped = true;
+            }
+        }
+        low++;
+        if (earlyExit && !swapped) break;
+    }
+}
@@ -0,0 +1,90 @@
+#include "cachesim.h"
+
+static const CachePreset cachePresets[] = {
+    // Scaled down 32x from a desktop part so the demo array sizes overflow each level
+    { "Scaled 1/32", { { "L1", 1 << 10, 64, 8 }, { "L2", 32 << 10, 64, 16 }, { "LLC", 512 << 10, 64, 16 } } },
+    { "Desktop",     { { "L1", 32 << 10, 64, 8 }, { "L2", 1 << 20, 64, 16 }, { "LLC", 16 << 20, 64, 16 } } },
+    { "Tiny",        { { "L1", 256, 32, 2 },      { "L2", 4 << 10, 64, 4 },  { "LLC", 64 << 10, 64, 8 } } },
+};
+
+// Simulated base addresses; far enough apart that regions never share a line
+static const uint64_t regionBase[MEM_REGION_COUNT] = { 0x10000000ull, 0x50000000ull, 0x90000000ull };
+
+int GetCachePresetCount(void) {
+    return (int)(sizeof(cachePresets) / sizeof(cachePresets[0]));
+}
+
+const CachePreset& GetCachePreset(int index) {
+    return cachePresets[index];
+}
+
+static int Log2(int value) {
+    int shift = 0;
+    while ((1 << (shift + 1)) <= value) shift++;
+    return shift;
+}
+
+void InitCacheSimulator(CacheSimulator& sim, int presetIndex) {
+    const CachePreset& preset = GetCachePreset(presetIndex);
+    sim.presetIndex = presetIndex;
+    sim.levelCount = CACHE_MAX_LEVELS;
+    for (int l = 0; l < sim.levelCount; l++) {
+        CacheLevel& level = sim.levels[l];
+        level.config = preset.levels[l];
+        level.sets = level.config.sizeBytes / (level.config.lineBytes * level.config.ways);
+        if (level.sets < 1) level.sets = 1;
+        level.lineShift = Log2(level.config.lineBytes);
+    }
+    ResetCacheSimulator(sim);
+}
+
+void ResetCacheSimulator(CacheSimulator& sim) {
+    for (int l = 0; l < sim.levelCount; l++) {
+        CacheLevel& level = sim.levels[l];
+        size_t entries = (size_t)level.sets * level.config.ways;
+        level.tags.assign(entries, UINT64_MAX);
+        level.lastUse.assign(entries, 0);
+        level.hits = 0;
+        level.misses = 0;
+    }
+    sim.clock = 0;
+    sim.accesses = 0;
+    sim.reads = 0;
+    sim.writes = 0;
+}
+
+// Look the line up in one level; on a miss the LRU way is replaced
+static bool AccessLevel(CacheLevel& level, uint64_t address, uint64_t now) {
+    uint64_t line = address >> level.lineShift;
+    int set = (int)(line % (uint64_t)level.sets);
+    size_t first = (size_t)set * level.config.ways;
+
+    size_t victim = first;
+    for (int w = 0; w < level.config.ways; w++) {
+        size_t slot = first + w;
+        if (level.tags[slot] == line) {
+            level.lastUse[slot] = now;
+            level.hits++;
+            return true;
+        }
+        if (level.lastUse[slot] < level.lastUse[victim]) victim = slot;
+    }
+    level.tags[victim] = line;
+    level.lastUse[victim] = now;
+    level.misses++;
+    return false;
+}
+
+int SimulateCacheAccess(CacheSimulator& sim, MemoryRegion region, int index, bool isWrite) {
+    uint64_t address = regionBase[region] + (uint64_t)index * sizeof(int);
+    uint64_t now = ++sim.clock;
+    sim.accesses++;
+    if (isWrite) sim.writes++;
+    else sim.reads++;
+
+    // Write-allocate: writes are looked up like reads
+    for (int l = 0; l < sim.levelCount; l++) {
+        if (AccessLevel(sim.levels[l], address, now)) return l;
+    }
+    return sim.levelCount;
+}
@@ -0,0 +1,93 @@
+#include "countingsort.h"
+#include <algorithm> // For std::minmax_element
+
+bool CountingSortFull(std::vector<int>& arr, long long* bytesMoved) {
+    if (arr.size() < 2) return true;
+
+    auto bounds = std::minmax_element(arr.begin(), arr.end());
+    int minValue = *bounds.first;
+    long long range = (long long)*bounds.second - minValue + 1;
+    if (range > COUNTING_SORT_MAX_RANGE) return false;
+
+    std::vector<int> counts((size_t)range, 0);
+    for (int value : arr) counts[value - minValue]++;
+
+    size_t out = 0;
+    for (long long v = 0; v < range; v++) {
+        int value = (int)(v + minValue);
+        for (int c = counts[(size_t)v]; c > 0; c--) arr[out++] = value;
+    }
+    if (bytesMoved) *bytesMoved += (long long)arr.size() * sizeof(int);
+    return true;
+}
+
+// sortPhase 0: find the value range, 1: count one element per step,
+// 2: write one output element per step.
+// primaryIndex = element being counted / output position, secondaryIndex = current bucket
+bool StepCountingSort(VisualizationState& state) {
+    if (state.countingFallback) return StepRadixSort(state);
+    int n = state.size;
+
+    if (state.sortPhase == 0) {
+        if (n == 0) {
+            state.status = VIZ_STATE_FINISHED;
+            return false;
+        }
+        auto bounds = std::minmax_element(state.array.begin(), state.array.end());
+        state.countMin = *bounds.first;
+        state.comparisons += n;
+        TraceRange(state, MEM_REGION_ARRAY, 0, n, false);
+        if ((long long)*bounds.second - state.countMin + 1 > COUNTING_SORT_MAX_RANGE) {
+            // Too wide for one counter per value: this run continues as a radix sort
+            // (the selected algorithm stays counting sort for the next reset)
+            state.countingFallback = true;
+            state.radixShift = 0;
+            return true;
+        }
+        state.counts.assign((size_t)((long long)*bounds.second - state.countMin + 1), 0);
+        state.primaryIndex = 0;
+        state.sortPhase = 1;
+        return true;
+    }
+
+    if (state.sortPhase == 1) {
+        int bucket = state.array[state.primaryIndex] - state.countMin;
+        state.counts[bucket]++;
+        TraceRead(state, state.primaryIndex);
+        TraceAccess(state, MEM_REGION_COUNTS, bucket, false);
+        TraceAccess(state, MEM_REGION_COUNTS, bucket, true);
+        state.tertiaryIndex = state.primaryIndex;
+        state.primaryIndex++;
+        if (state.primaryIndex >= n) {
+            state.sortPhase = 2;
+            state.primaryIndex = 0;
+            state.secondaryIndex = 0;
+            state.tertiaryIndex = -1;
+        }
+        return true;
+    }
+
+    // Write phase: skip empty buckets, emit one value
+    int bucket = state.secondaryIndex;
+    while (bucket < (int)state.counts.size() && state.counts[bucket] == 0) {
+        TraceAccess(state, MEM_REGION_COUNTS, bucket, false);
+        bucket++;
+    }
+    if (bucket >= (int)state.counts.size() || state.primaryIndex >= n) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.secondaryIndex = -1;
+        return false; // Sort finished
+    }
+    state.array[state.primaryIndex] = bucket + state.countMin;
+    state.bytesMoved += sizeof(int);
+    state.counts[bucket]--;
+    TraceAccess(state, MEM_REGION_COUNTS, bucket, false);
+    TraceAccess(state, MEM_REGION_COUNTS, bucket, true);
+    TraceWrite(state, state.primaryIndex);
+    state.secondaryIndex = bucket;
+    state.highlightStart = 0;
+    state.highlightEnd = state.primaryIndex;
+    state.primaryIndex++;
+    return true;
+}
@@ -0,0 +1,139 @@
+#include "eventstream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static char streamStatus[96] = "off";
+static char streamName[64] = EVENT_STREAM_NAME;
+
+uint64_t EventStreamClockNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* GetEventStreamStatus(const EventStream& stream) {
+    if (stream.active) {
+        snprintf(streamStatus, sizeof(streamStatus), "%s: %llu events", streamName, (unsigned long long)stream.next);
+    }
+    return streamStatus;
+}
+
+uint64_t PublishSnapshot(EventStream& stream, const int* values, int count) {
+    EventStreamHeader* header = stream.header;
+    if (count > EVENT_STREAM_SNAPSHOT_CAPACITY) count = EVENT_STREAM_SNAPSHOT_CAPACITY;
+    if (count < 0) count = 0;
+
+    header->snapshotSequence.store(++stream.snapshots, std::memory_order_relaxed); // Odd: copy in progress
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(stream.snapshot, values, (size_t)count * sizeof(int32_t));
+    header->snapshotLength.store(count, std::memory_order_relaxed);
+    header->snapshotSequence.store(++stream.snapshots, std::memory_order_release);
+    return stream.snapshots;
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+
+// Header, then the ring and the snapshot area, each starting on a page
+static size_t RoundUpToPage(size_t bytes) {
+    return (bytes + 4095) & ~(size_t)4095;
+}
+
+bool OpenEventStream(EventStream& stream, const char* name) {
+    CloseEventStream(stream);
+    snprintf(streamName, sizeof(streamName), "%s", name);
+
+    size_t eventOffset = RoundUpToPage(sizeof(EventStreamHeader));
+    size_t snapshotOffset = eventOffset + RoundUpToPage((size_t)EVENT_STREAM_CAPACITY * sizeof(EventRecord));
+    size_t size = snapshotOffset + RoundUpToPage((size_t)EVENT_STREAM_SNAPSHOT_CAPACITY * sizeof(int32_t));
+
+    // A stale object left by a crashed run is replaced, so readers never see its sequence numbers
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        snprintf(streamStatus, sizeof(streamStatus), "shm_open: %s", strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        snprintf(streamStatus, sizeof(streamStatus), "ftruncate: %s", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        snprintf(streamStatus, sizeof(streamStatus), "mmap: %s", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+
+    // ftruncate zero-fills, so every slot sequence and counter already reads 0
+    EventStreamHeader* header = (EventStreamHeader*)mapping;
+    header->version = EVENT_STREAM_VERSION;
+    header->headerSize = (uint32_t)sizeof(EventStreamHeader);
+    header->recordSize = (uint32_t)sizeof(EventRecord);
+    header->eventCapacity = EVENT_STREAM_CAPACITY;
+    header->snapshotCapacity = EVENT_STREAM_SNAPSHOT_CAPACITY;
+    header->eventOffset = eventOffset;
+    header->snapshotOffset = snapshotOffset;
+    header->writerPid = (uint32_t)getpid();
+    header->writerActive.store(1, std::memory_order_relaxed);
+    header->magic.store(EVENT_STREAM_MAGIC, std::memory_order_release);
+
+    stream.fd = fd;
+    stream.mapping = mapping;
+    stream.mappingSize = size;
+    stream.header = header;
+    stream.events = (EventRecord*)((char*)mapping + eventOffset);
+    stream.snapshot = (int32_t*)((char*)mapping + snapshotOffset);
+    stream.next = 0;
+    stream.snapshots = 0;
+    stream.active = true;
+    return true;
+}
+
+void CloseEventStream(EventStream& stream) {
+    if (stream.mapping) {
+        stream.header->writerActive.store(0, std::memory_order_release);
+        munmap(stream.mapping, stream.mappingSize);
+        close(stream.fd);
+        shm_unlink(streamName);
+        snprintf(streamStatus, sizeof(streamStatus), "off");
+    }
+    stream.active = false;
+    stream.fd = -1;
+    stream.mapping = nullptr;
+    stream.mappingSize = 0;
+    stream.header = nullptr;
+    stream.events = nullptr;
+    stream.snapshot = nullptr;
+}
+
+#else // No POSIX shared memory: the stream never opens
+
+bool OpenEventStream(EventStream& stream, const char* name) {
+    (void)name;
+    CloseEventStream(stream);
+    snprintf(streamStatus, sizeof(streamStatus), "the event stream needs POSIX shared memory");
+    return false;
+}
+
+void CloseEventStream(EventStream& stream) {
+    stream.active = false;
+    stream.fd = -1;
+    stream.mapping = nullptr;
+    stream.mappingSize = 0;
+    stream.header = nullptr;
+    stream.events = nullptr;
+    stream.snapshot = nullptr;
+}
+
+#endif
@@ -0,0 +1,477 @@
+#include "externalsort.h"
+#include "visualization_state.h"
+#include "profiler.h" // For ProfilerNow
+#include <algorithm>
+#include <climits>    // For LLONG_MAX
+#include <sys/types.h> // For off_t (fseeko)
+
+const char* GetExternalSortPhaseName(ExternalSortPhase phase) {
+    switch (phase) {
+        case EXTSORT_IDLE:    return "Idle";
+        case EXTSORT_FILLING: return "Loading heap";
+        case EXTSORT_FORMING: return "Forming runs";
+        case EXTSORT_MERGING: return "Merging";
+        case EXTSORT_DONE:    return "Done";
+        case EXTSORT_FAILED:  return "Failed";
+        default:              return "Unknown";
+    }
+}
+
+int ExternalSortFanout(int memoryCap) {
+    return std::max(2, memoryCap / (2 * EXTSORT_BLOCK_ELEMENTS) - 1);
+}
+
+static void FailExternalSort(ExternalSortJob& job, const char* error) {
+    job.phase = EXTSORT_FAILED;
+    job.error = error;
+}
+
+// Seek to element `element` with a 64-bit offset: run files pass 2 GiB long before
+// memory does, and fseek's long is 32 bits on Windows
+static bool SeekElement(FILE* file, long long element) {
+    long long offset = element * (long long)sizeof(int);
+#if defined(_WIN32)
+    return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+// --- Async block I/O ---
+// One thread per job takes the blocks from a queue in order. Readers of the same file
+// share its FILE*; only this thread seeks it while the job runs. A writer owns its file
+// for the pass.
+
+static int TransferBlock(ExternalIoRequest& request) {
+    if (request.offset < 0) return (int)fwrite(request.buffer, sizeof(int), (size_t)request.count, request.file);
+    if (!SeekElement(request.file, request.offset)) return 0;
+    return (int)fread(request.buffer, sizeof(int), (size_t)request.count, request.file);
+}
+
+// Serves requests until stopped; the queue is drained first, so no promise is left unset
+static void RunIoThread(ExternalSortJob* job) {
+    std::unique_lock<std::mutex> lock(job->ioLock);
+    for (;;) {
+        job->ioWake.wait(lock, [job] { return job->ioStop || !job->ioQueue.empty(); });
+        if (job->ioQueue.empty()) return; // Stopped
+        ExternalIoRequest request = std::move(job->ioQueue.front());
+        job->ioQueue.pop_front();
+        lock.unlock();
+        request.done.set_value(TransferBlock(request));
+        lock.lock();
+    }
+}
+
+static std::future<int> SubmitBlock(ExternalSortJob& job, FILE* file, long long offset, int* buffer, int count) {
+    ExternalIoRequest request = { file, offset, buffer, count, std::promise<int>() };
+    std::future<int> done = request.done.get_future();
+    {
+        std::lock_guard<std::mutex> guard(job.ioLock);
+        job.ioQueue.push_back(std::move(request));
+    }
+    job.ioWake.notify_one();
+    return done;
+}
+
+static void StartIoThread(ExternalSortJob& job) {
+    job.ioStop = false;
+    job.ioThread = std::thread(RunIoThread, &job);
+}
+
+static void StopIoThread(ExternalSortJob& job) {
+    if (!job.ioThread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(job.ioLock);
+        job.ioStop = true;
+    }
+    job.ioWake.notify_one();
+    job.ioThread.join();
+}
+
+// Wait for a block; the time spent blocked is I/O the computation did not hide
+static int WaitForBlock(ExternalSortJob& job, std::future<int>& pending) {
+    uint64_t start = ProfilerNow();
+    int done = pending.get();
+    job.ioWaitTicks += ProfilerNow() - start;
+    return done;
+}
+
+static void RequestBlock(ExternalSortJob& job, ExternalReader& reader, int buffer) {
+    int count = (int)std::min<long long>(EXTSORT_BLOCK_ELEMENTS, reader.remaining);
+    reader.requested = count;
+    if (count == 0) return; // Leaves `pending` invalid: the run is fully requested
+    reader.pending = SubmitBlock(job, reader.file, reader.next, reader.buffers[buffer].data(), count);
+    reader.next += count;
+    reader.remaining -= count;
+}
+
+static int WaitForRead(ExternalSortJob& job, ExternalReader& reader) {
+    if (!reader.pending.valid()) return 0;
+    int got = WaitForBlock(job, reader.pending);
+    job.bytesRead += (long long)got * sizeof(int);
+    if (got != reader.requested) FailExternalSort(job, "Reading a temporary file failed");
+    return got;
+}
+
+static void OpenReader(ExternalSortJob& job, ExternalReader& reader, FILE* file, ExternalRun run) {
+    reader.file = file;
+    reader.next = run.start;
+    reader.remaining = run.length;
+    reader.buffers[0].resize(EXTSORT_BLOCK_ELEMENTS);
+    reader.buffers[1].resize(EXTSORT_BLOCK_ELEMENTS);
+    reader.active = 0;
+    reader.position = 0;
+    RequestBlock(job, reader, 0);
+    reader.counts[0] = WaitForRead(job, reader);
+    reader.counts[1] = 0;
+    RequestBlock(job, reader, 1);
+}
+
+// Next element of the run; swaps buffers and requests the following block at the end of one
+static bool ReaderNext(ExternalSortJob& job, ExternalReader& reader, int& value) {
+    if (reader.position == reader.counts[reader.active]) {
+        if (!reader.pending.valid()) return false;
+        int other = reader.active ^ 1;
+        reader.counts[other] = WaitForRead(job, reader);
+        reader.active = other;
+        reader.position = 0;
+        RequestBlock(job, reader, other ^ 1);
+        if (reader.counts[other] == 0) return false;
+    }
+    value = reader.buffers[reader.active][reader.position++];
+    return true;
+}
+
+static void FlushWriter(ExternalSortJob& job) {
+    ExternalWriter& writer = job.writer;
+    if (writer.pending.valid()) {
+        int written = WaitForBlock(job, writer.pending);
+        job.bytesWritten += (long long)written * sizeof(int);
+        if (written != writer.requested) FailExternalSort(job, "Writing a temporary file failed");
+    }
+    if (writer.count == 0) return;
+    writer.requested = writer.count;
+    writer.pending = SubmitBlock(job, writer.file, -1, writer.buffers[writer.active].data(), writer.count);
+    writer.active ^= 1;
+    writer.count = 0;
+}
+
+static void OpenWriter(ExternalSortJob& job, FILE* file) {
+    ExternalWriter& writer = job.writer;
+    writer.file = file;
+    writer.buffers[0].resize(EXTSORT_BLOCK_ELEMENTS);
+    writer.buffers[1].resize(EXTSORT_BLOCK_ELEMENTS);
+    writer.active = 0;
+    writer.count = 0;
+    SeekElement(file, 0);
+    job.outputPosition = 0;
+}
+
+static void CloseWriter(ExternalSortJob& job) {
+    FlushWriter(job); // Sends the partial block
+    FlushWriter(job); // Waits for it
+    fflush(job.writer.file);
+}
+
+// Append to the current output run; the bar sampling this file position follows it
+static void WriterPut(ExternalSortJob& job, int value, std::vector<int>* view, long long stride) {
+    ExternalWriter& writer = job.writer;
+    writer.buffers[writer.active][writer.count++] = value;
+    if (view && job.outputPosition % stride == 0) {
+        long long bar = job.outputPosition / stride;
+        if (bar < (long long)view->size()) (*view)[(size_t)bar] = value;
+    }
+    job.outputPosition++;
+    job.nextRuns.back().length++;
+    if (writer.count == EXTSORT_BLOCK_ELEMENTS) FlushWriter(job);
+}
+
+// --- Loser tree ---
+
+// Source a wins against source b; ties go to the earlier run, so the merge is stable
+static bool Beats(const LoserTree& tree, int a, int b) {
+    if (tree.exhausted[a]) return false;
+    if (tree.exhausted[b]) return true;
+    return tree.heads[a] < tree.heads[b] || (tree.heads[a] == tree.heads[b] && a < b);
+}
+
+// Leaf s sits below node (s + k) / 2. Every source climbs until it finds an empty node
+// to wait at; the second arrival plays, leaves the loser and carries on upwards.
+static void BuildLoserTree(LoserTree& tree) {
+    tree.nodes.assign(tree.k, -1);
+    for (int s = 0; s < tree.k; s++) {
+        int winner = s;
+        for (int node = (s + tree.k) / 2; node > 0 && winner >= 0; node /= 2) {
+            if (tree.nodes[node] < 0) {
+                tree.nodes[node] = winner;
+                winner = -1;
+            } else if (Beats(tree, tree.nodes[node], winner)) {
+                std::swap(tree.nodes[node], winner);
+            }
+        }
+        if (winner >= 0) tree.nodes[0] = winner;
+    }
+}
+
+// Source s got a new head: replay its matches up to the root
+static void ReplayLoserTree(LoserTree& tree, int s) {
+    int winner = s;
+    for (int node = (s + tree.k) / 2; node > 0; node /= 2) {
+        if (Beats(tree, tree.nodes[node], winner)) std::swap(tree.nodes[node], winner);
+    }
+    tree.nodes[0] = winner;
+}
+
+// --- Replacement selection ---
+// Heap entries order by run first, so elements that arrive smaller than the last one
+// written wait for the next run; on random input runs average twice the heap size.
+
+static uint64_t HeapEntry(int run, int key) {
+    return ((uint64_t)run << 32) | (uint32_t)((uint32_t)key ^ 0x80000000u);
+}
+
+static void HeapSiftUp(std::vector<uint64_t>& heap, int node) {
+    uint64_t entry = heap[node];
+    while (node > 0 && heap[(node - 1) / 2] > entry) {
+        heap[node] = heap[(node - 1) / 2];
+        node = (node - 1) / 2;
+    }
+    heap[node] = entry;
+}
+
+static void HeapSiftDown(std::vector<uint64_t>& heap, int heapSize, int node) {
+    uint64_t entry = heap[node];
+    for (;;) {
+        int child = 2 * node + 1;
+        if (child >= heapSize) break;
+        if (child + 1 < heapSize && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= entry) break;
+        heap[node] = heap[child];
+        node = child;
+    }
+    heap[node] = entry;
+}
+
+// --- Passes ---
+
+// The target file now holds nextRuns; it becomes the source of the next merge pass
+static void FinishPass(ExternalSortJob& job) {
+    CloseWriter(job);
+    if (job.phase == EXTSORT_FAILED) return;
+    job.runs.swap(job.nextRuns);
+    job.nextRuns.clear();
+    if (job.pass == 0) job.initialRuns = (int)job.runs.size();
+    job.pass++;
+    job.sourceFile = job.targetFile;
+    if (job.runs.size() <= 1) {
+        job.phase = EXTSORT_DONE;
+        return;
+    }
+    job.targetFile = (job.targetFile == 1) ? 2 : 1;
+    OpenWriter(job, job.files[job.targetFile]);
+    job.groupStart = 0;
+    job.groupSize = 0;
+    job.phase = EXTSORT_MERGING;
+}
+
+static void StartMergeGroup(ExternalSortJob& job) {
+    job.groupSize = std::min(job.fanout, (int)job.runs.size() - job.groupStart);
+    job.readers.clear();
+    job.readers.resize(job.groupSize);
+    LoserTree& tree = job.tree;
+    tree.k = job.groupSize;
+    tree.heads.assign(tree.k, 0);
+    tree.exhausted.assign(tree.k, 0);
+    for (int s = 0; s < tree.k; s++) {
+        OpenReader(job, job.readers[s], job.files[job.sourceFile], job.runs[job.groupStart + s]);
+        tree.exhausted[s] = !ReaderNext(job, job.readers[s], tree.heads[s]);
+    }
+    BuildLoserTree(tree);
+    job.nextRuns.push_back({ job.outputPosition, 0 });
+}
+
+bool AdvanceExternalSort(ExternalSortJob& job, long long budget, std::vector<int>* view) {
+    if (job.phase == EXTSORT_IDLE || job.phase == EXTSORT_DONE || job.phase == EXTSORT_FAILED) return false;
+    uint64_t start = ProfilerNow();
+    long long stride = view && !view->empty() ? std::max<long long>(1, job.totalElements / (long long)view->size()) : 1;
+
+    while (budget > 0 && (job.phase == EXTSORT_FILLING || job.phase == EXTSORT_FORMING || job.phase == EXTSORT_MERGING)) {
+        if (job.phase == EXTSORT_FILLING) {
+            if (!job.input.file) OpenReader(job, job.input, job.files[0], { 0, job.totalElements });
+            int value;
+            bool more = true;
+            while (budget > 0 && job.heapSize < job.heapCapacity && (more = ReaderNext(job, job.input, value))) {
+                job.heap[job.heapSize] = HeapEntry(0, value);
+                HeapSiftUp(job.heap, job.heapSize++);
+                budget--;
+            }
+            if (job.phase == EXTSORT_FAILED) break;
+            if (!more || job.heapSize == job.heapCapacity) {
+                OpenWriter(job, job.files[job.targetFile]);
+                job.currentRun = -1;
+                job.phase = EXTSORT_FORMING;
+            }
+        } else if (job.phase == EXTSORT_FORMING) {
+            if (job.heapSize == 0) {
+                FinishPass(job);
+                continue;
+            }
+            uint64_t top = job.heap[0];
+            int run = (int)(top >> 32);
+            int value = (int)((uint32_t)top ^ 0x80000000u);
+            if (run != job.currentRun) {
+                job.nextRuns.push_back({ job.outputPosition, 0 });
+                job.currentRun = run;
+            }
+            WriterPut(job, value, view, stride);
+            int incoming;
+            if (ReaderNext(job, job.input, incoming)) {
+                job.heap[0] = HeapEntry(incoming >= value ? run : run + 1, incoming);
+            } else {
+                job.heap[0] = job.heap[--job.heapSize];
+            }
+            if (job.heapSize > 0) HeapSiftDown(job.heap, job.heapSize, 0);
+            budget--;
+        } else {
+            if (job.groupSize == 0) StartMergeGroup(job);
+            LoserTree& tree = job.tree;
+            int winner = tree.nodes[0];
+            if (tree.exhausted[winner]) {
+                job.groupStart += job.groupSize;
+                job.groupSize = 0;
+                job.readers.clear();
+                if (job.groupStart >= (int)job.runs.size()) FinishPass(job);
+                continue;
+            }
+            WriterPut(job, tree.heads[winner], view, stride);
+            tree.exhausted[winner] = !ReaderNext(job, job.readers[winner], tree.heads[winner]);
+            ReplayLoserTree(tree, winner);
+            budget--;
+        }
+    }
+
+    job.busyTicks += ProfilerNow() - start;
+    return job.phase == EXTSORT_FILLING || job.phase == EXTSORT_FORMING || job.phase == EXTSORT_MERGING;
+}
+
+// --- Job lifetime ---
+
+static void WaitForPending(std::future<int>& pending) {
+    if (pending.valid()) pending.wait();
+}
+
+void ReleaseExternalSort(ExternalSortJob& job) {
+    // Blocks in flight still use the buffers and files
+    WaitForPending(job.input.pending);
+    for (ExternalReader& reader : job.readers) WaitForPending(reader.pending);
+    WaitForPending(job.writer.pending);
+    StopIoThread(job);
+    for (int f = 0; f < 3; f++) {
+        if (job.files[f]) fclose(job.files[f]);
+        job.files[f] = nullptr;
+    }
+
+    job.phase = EXTSORT_IDLE;
+    job.error = "";
+    job.runs.clear();
+    job.nextRuns.clear();
+    job.pass = 0;
+    job.groupStart = 0;
+    job.groupSize = 0;
+    job.outputPosition = 0;
+    job.heap.clear();
+    job.heap.shrink_to_fit();
+    job.heapSize = 0;
+    job.currentRun = -1;
+    job.input = ExternalReader();
+    job.readers.clear();
+    job.writer = ExternalWriter();
+    job.initialRuns = 0;
+    job.bytesRead = 0;
+    job.bytesWritten = 0;
+    job.ioWaitTicks = 0;
+    job.busyTicks = 0;
+}
+
+bool StartExternalSort(ExternalSortJob& job, const int* data, long long count, std::vector<int>* view) {
+    ReleaseExternalSort(job);
+    job.totalElements = count;
+    job.memoryCap = std::max(job.memoryCap, EXTSORT_MIN_MEMORY);
+    job.fanout = ExternalSortFanout(job.memoryCap);
+    job.heapCapacity = job.memoryCap - 4 * EXTSORT_BLOCK_ELEMENTS; // Two input and two output buffers
+    job.heap.resize(job.heapCapacity);
+    job.sourceFile = 0;
+    job.targetFile = 1;
+    StartIoThread(job);
+
+    for (int f = 0; f < 3; f++) {
+        job.files[f] = std::tmpfile(); // Removed automatically when closed
+        if (!job.files[f]) {
+            FailExternalSort(job, "Could not create a temporary file");
+            return false;
+        }
+    }
+    // Writing the data set is setup, not part of the sort's I/O (an empty one may have no data pointer)
+    if (count > 0 && ((long long)fwrite(data, sizeof(int), (size_t)count, job.files[0]) != count || fflush(job.files[0]) != 0)) {
+        FailExternalSort(job, "Writing the data set failed");
+        return false;
+    }
+
+    if (view && !view->empty()) {
+        long long stride = std::max<long long>(1, count / (long long)view->size());
+        for (size_t i = 0; i < view->size(); i++) {
+            long long position = (long long)i * stride;
+            (*view)[i] = position < count ? data[position] : 0;
+        }
+    }
+
+    job.phase = (count > 0) ? EXTSORT_FILLING : EXTSORT_DONE;
+    return true;
+}
+
+bool ExternalSortFull(std::vector<int>& arr, int memoryCap, long long* bytesMoved) {
+    ExternalSortJob job{};
+    job.memoryCap = memoryCap;
+    if (StartExternalSort(job, arr.data(), (long long)arr.size(), nullptr)) {
+        AdvanceExternalSort(job, LLONG_MAX, nullptr);
+        FILE* result = job.files[job.sourceFile];
+        if (job.phase == EXTSORT_DONE && !arr.empty() &&
+            (!SeekElement(result, 0) || fread(arr.data(), sizeof(int), arr.size(), result) != arr.size())) {
+            FailExternalSort(job, "Reading the sorted file back failed");
+        }
+    }
+    bool sorted = job.phase == EXTSORT_DONE;
+    if (!sorted) TraceLog(LOG_WARNING, "External sort: %s", job.error);
+    if (bytesMoved) *bytesMoved += job.bytesRead + job.bytesWritten;
+    ReleaseExternalSort(job);
+    return sorted;
+}
+
+// One step = 1/EXTSORT_STEPS_PER_PASS of a pass over the data. The bars sample the
+// file being written; primaryIndex follows the write position and the highlighted
+// range covers the runs being merged.
+bool StepExternalSort(VisualizationState& state) {
+    ExternalSortJob& job = state.externalSort;
+    long long budget = std::max<long long>(EXTSORT_BLOCK_ELEMENTS, job.totalElements / EXTSORT_STEPS_PER_PASS);
+    bool running = AdvanceExternalSort(job, budget, &state.array);
+    state.bytesMoved = job.bytesRead + job.bytesWritten;
+    if (!running) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+        return false;
+    }
+
+    long long stride = std::max<long long>(1, job.totalElements / state.size);
+    state.primaryIndex = (int)std::min<long long>(job.outputPosition / stride, state.size - 1);
+    if (job.phase == EXTSORT_MERGING && job.groupSize > 0) {
+        const ExternalRun& last = job.runs[job.groupStart + job.groupSize - 1];
+        state.highlightStart = (int)(job.runs[job.groupStart].start / stride);
+        state.highlightEnd = (int)std::min<long long>((last.start + last.length - 1) / stride, state.size - 1);
+    } else {
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+    }
+    return true;
+}
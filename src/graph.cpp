@@ -0,0 +1,463 @@
+#include "graph.h"
+#include "visualization_state.h"
+#include <algorithm>
+#include <climits>  // For INT_MAX
+#include <cmath>    // For std::sqrt, std::ceil
+#include <cstdio>   // For fopen, fgets
+#include <cstdlib>  // For rand(), strtol
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // For _BitScanReverse64
+#endif
+
+const char* GetGraphKindName(GraphKind kind) {
+    switch (kind) {
+        case GRAPH_GRID:   return "Grid";
+        case GRAPH_RANDOM: return "Random";
+        case GRAPH_RMAT:   return "R-MAT";
+        case GRAPH_FILE:   return "File";
+        default:           return "Unknown";
+    }
+}
+
+const char* GetDijkstraQueueName(DijkstraQueue queue) {
+    switch (queue) {
+        case DIJKSTRA_BINARY_HEAP: return "Binary heap";
+        case DIJKSTRA_RADIX_HEAP:  return "Radix heap";
+        default:                   return "Unknown";
+    }
+}
+
+// --- Building ---
+
+// Uniform in [0, bound), also for bounds beyond a 15-bit RAND_MAX
+static int RandomBelow(int bound) {
+    unsigned int r = (unsigned int)rand() * (RAND_MAX + 1u) + (unsigned int)rand();
+    return (int)(r % (unsigned int)bound);
+}
+
+static int RandomWeight() {
+    return 1 + rand() % GRAPH_MAX_WEIGHT;
+}
+
+// xorshift64*: the million-edge generators draw far too many numbers for rand()
+static uint64_t NextRandom(uint64_t& seed) {
+    seed ^= seed >> 12;
+    seed ^= seed << 25;
+    seed ^= seed >> 27;
+    return seed * 2685821657736338717ULL;
+}
+
+static void RandomLayout(CsrGraph& graph, int vertexCount) {
+    graph.layoutX.resize(vertexCount);
+    graph.layoutY.resize(vertexCount);
+    for (int v = 0; v < vertexCount; v++) {
+        graph.layoutX[v] = (float)rand() / RAND_MAX;
+        graph.layoutY[v] = (float)rand() / RAND_MAX;
+    }
+}
+
+void BuildCsrGraph(CsrGraph& graph, int vertexCount, const std::vector<GraphEdge>& edges) {
+    graph.vertexCount = vertexCount;
+    graph.offsets.assign(vertexCount + 1, 0);
+    for (const GraphEdge& e : edges) {
+        if (e.from == e.to) continue;
+        graph.offsets[e.from + 1]++;
+        graph.offsets[e.to + 1]++;
+    }
+    for (int v = 0; v < vertexCount; v++) graph.offsets[v + 1] += graph.offsets[v];
+
+    graph.targets.resize(graph.offsets[vertexCount]);
+    graph.weights.resize(graph.offsets[vertexCount]);
+    std::vector<int> fill(graph.offsets.begin(), graph.offsets.end() - 1);
+    for (const GraphEdge& e : edges) {
+        if (e.from == e.to) continue;
+        int forward = fill[e.from]++;
+        graph.targets[forward] = e.to;
+        graph.weights[forward] = e.weight;
+        int backward = fill[e.to]++;
+        graph.targets[backward] = e.from;
+        graph.weights[backward] = e.weight;
+    }
+}
+
+void GenerateGraph(CsrGraph& graph, GraphKind kind, int vertexCount) {
+    int n = std::max(1, vertexCount);
+    std::vector<GraphEdge> edges;
+
+    if (kind == GRAPH_GRID) {
+        int side = (int)std::ceil(std::sqrt((double)n));
+        int rows = (n + side - 1) / side;
+        graph.layoutX.resize(n);
+        graph.layoutY.resize(n);
+        edges.reserve(2 * (size_t)n);
+        for (int v = 0; v < n; v++) {
+            int column = v % side;
+            graph.layoutX[v] = (column + 0.5f) / side;
+            graph.layoutY[v] = (v / side + 0.5f) / rows;
+            if (column + 1 < side && v + 1 < n) edges.push_back({ v, v + 1, RandomWeight() });
+            if (v + side < n) edges.push_back({ v, v + side, RandomWeight() });
+        }
+        BuildCsrGraph(graph, n, edges);
+        return;
+    }
+
+    RandomLayout(graph, n);
+    long long edgeCount = (long long)n * GRAPH_AVERAGE_DEGREE / 2;
+    edges.reserve((size_t)edgeCount);
+    uint64_t seed = ((uint64_t)(unsigned int)RandomBelow(INT_MAX) << 32) | (unsigned int)rand() | 1;
+    if (kind == GRAPH_RMAT) {
+        // Each bit of both endpoints picks a quadrant of the adjacency matrix; ids are
+        // then shuffled so the hubs are not all packed at the start of the arrays
+        int scale = 0;
+        while ((1LL << scale) < n) scale++;
+        std::vector<int> relabel(n);
+        for (int v = 0; v < n; v++) relabel[v] = v;
+        for (int v = n - 1; v > 0; v--) std::swap(relabel[v], relabel[RandomBelow(v + 1)]);
+        while ((long long)edges.size() < edgeCount) {
+            int from = 0;
+            int to = 0;
+            // Quadrants a, b, c, d = 0.57, 0.19, 0.19, 0.05 in 128ths: [0, 73) neither bit,
+            // [73, 97) `to`, [97, 121) `from`, [121, 128) both. Branch-free: the choice is random.
+            for (int bit = 0; bit < scale; bit++) {
+                int r = (int)(NextRandom(seed) >> 57);
+                from |= (r >= 97) << bit;
+                to |= ((r >= 73) & ((r < 97) | (r >= 121))) << bit;
+            }
+            if (from >= n || to >= n) continue;
+            int weight = 1 + (int)(NextRandom(seed) % GRAPH_MAX_WEIGHT);
+            edges.push_back({ relabel[from], relabel[to], weight });
+        }
+    } else {
+        for (long long e = 0; e < edgeCount; e++) {
+            uint64_t r = NextRandom(seed);
+            int from = (int)((r & 0xFFFFFFFF) % (uint64_t)n);
+            int to = (int)((r >> 32) % (uint64_t)n);
+            edges.push_back({ from, to, 1 + (int)(NextRandom(seed) % GRAPH_MAX_WEIGHT) });
+        }
+    }
+    BuildCsrGraph(graph, n, edges);
+}
+
+bool LoadEdgeList(CsrGraph& graph, const char* path) {
+    if (!path) return false;
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+
+    std::vector<GraphEdge> edges;
+    int maxVertex = -1;
+    char line[256];
+    long long lineNumber = 0;
+    while (fgets(line, sizeof(line), file)) {
+        lineNumber++;
+        const char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '%' || *p == 'c' || *p == 'p' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        int base = 0;
+        if (*p == 'a') { // DIMACS arc, 1-based
+            p++;
+            base = 1;
+        }
+        char* end;
+        long from = strtol(p, &end, 10);
+        if (end == p) continue;
+        p = end;
+        long to = strtol(p, &end, 10);
+        if (end == p) continue;
+        p = end;
+        long weight = strtol(p, &end, 10);
+        if (end == p) weight = RandomWeight();
+        from -= base;
+        to -= base;
+        if (from < 0 || to < 0 || from >= INT_MAX || to >= INT_MAX) continue;
+        if (weight < 0 || weight > INT_MAX) {
+            TraceLog(LOG_WARNING, "Edge list '%s': weight %ld out of range (0..%d) on line %lld", path, weight, INT_MAX, lineNumber);
+            fclose(file);
+            return false;
+        }
+        edges.push_back({ (int)from, (int)to, (int)weight });
+        maxVertex = std::max(maxVertex, (int)std::max(from, to));
+    }
+    fclose(file);
+    if (edges.empty()) return false;
+
+    // The CSR arrays are sized by the largest id. When the ids are sparser than the edges
+    // could make them, renumber them in order, so one huge id cannot size the graph.
+    int vertexCount = maxVertex + 1;
+    if ((long long)vertexCount > 2 * (long long)edges.size()) {
+        std::vector<int> ids;
+        ids.reserve(2 * edges.size());
+        for (const GraphEdge& e : edges) {
+            ids.push_back(e.from);
+            ids.push_back(e.to);
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        for (GraphEdge& e : edges) {
+            e.from = (int)(std::lower_bound(ids.begin(), ids.end(), e.from) - ids.begin());
+            e.to = (int)(std::lower_bound(ids.begin(), ids.end(), e.to) - ids.begin());
+        }
+        TraceLog(LOG_INFO, "Edge list '%s': ids up to %d renumbered to %d vertices", path, maxVertex, (int)ids.size());
+        vertexCount = (int)ids.size();
+    }
+
+    RandomLayout(graph, vertexCount);
+    BuildCsrGraph(graph, vertexCount, edges);
+    return true;
+}
+
+int PickGraphSource(const CsrGraph& graph) {
+    for (int attempt = 0; attempt < 64; attempt++) {
+        int v = RandomBelow(graph.vertexCount);
+        if (GraphDegree(graph, v) > 0) return v;
+    }
+    int best = 0;
+    for (int v = 1; v < graph.vertexCount; v++) {
+        if (GraphDegree(graph, v) > GraphDegree(graph, best)) best = v;
+    }
+    return best;
+}
+
+// --- BFS (Beamer's direction-optimizing traversal) ---
+// Top-down walks the frontier's rows and claims unreached neighbours. Bottom-up walks
+// the rows of the unreached vertices and stops at the first neighbour in the frontier,
+// which wins once the frontier holds a large share of the remaining edges.
+
+void StartBfs(BfsSearch& search, const CsrGraph& graph, int source, bool directionOptimizing) {
+    int n = graph.vertexCount;
+    search.directionOptimizing = directionOptimizing;
+    search.bottomUp = false;
+    search.level = 0;
+    search.depth.assign(n, -1);
+    search.parent.assign(n, -1);
+    search.frontier.clear();
+    search.next.clear();
+    search.frontierBits.assign((n + 63) / 64, 0);
+    search.frontierEdges = 0;
+    search.unexploredEdges = (long long)graph.targets.size();
+    search.previousFrontierSize = 0;
+    search.topDownLevels = 0;
+    search.bottomUpLevels = 0;
+    if (source < 0 || source >= n) return;
+    search.depth[source] = 0;
+    search.parent[source] = source;
+    search.frontier.push_back(source);
+    search.frontierEdges = GraphDegree(graph, source);
+    search.unexploredEdges -= search.frontierEdges;
+}
+
+bool BfsLevel(BfsSearch& search, const CsrGraph& graph, long long* edgesChecked) {
+    if (search.frontier.empty()) return false;
+    const int* offsets = graph.offsets.data();
+    const int* targets = graph.targets.data();
+    int* depth = search.depth.data();
+    int n = graph.vertexCount;
+    int frontierSize = (int)search.frontier.size();
+
+    if (search.directionOptimizing) {
+        if (!search.bottomUp) {
+            search.bottomUp = search.frontierEdges > search.unexploredEdges / BFS_ALPHA;
+        } else if (frontierSize < n / BFS_BETA && frontierSize < search.previousFrontierSize) {
+            search.bottomUp = false;
+        }
+    }
+
+    int nextDepth = search.level + 1;
+    long long checked = 0;
+    long long nextEdges = 0;
+    search.next.clear();
+    if (!search.bottomUp) {
+        for (int v : search.frontier) {
+            for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                int u = targets[e];
+                if (depth[u] < 0) {
+                    depth[u] = nextDepth;
+                    search.parent[u] = v;
+                    search.next.push_back(u);
+                    nextEdges += offsets[u + 1] - offsets[u];
+                }
+            }
+            checked += offsets[v + 1] - offsets[v];
+        }
+        search.topDownLevels++;
+    } else {
+        uint64_t* bits = search.frontierBits.data();
+        std::fill(search.frontierBits.begin(), search.frontierBits.end(), 0);
+        for (int v : search.frontier) bits[v >> 6] |= 1ULL << (v & 63);
+        for (int u = 0; u < n; u++) {
+            if (depth[u] >= 0) continue;
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                int v = targets[e];
+                checked++;
+                if ((bits[v >> 6] >> (v & 63)) & 1) {
+                    depth[u] = nextDepth;
+                    search.parent[u] = v;
+                    search.next.push_back(u);
+                    nextEdges += offsets[u + 1] - offsets[u];
+                    break;
+                }
+            }
+        }
+        search.bottomUpLevels++;
+    }
+
+    search.unexploredEdges -= nextEdges;
+    search.frontierEdges = nextEdges;
+    search.previousFrontierSize = frontierSize;
+    search.frontier.swap(search.next);
+    search.level = nextDepth;
+    if (edgesChecked) *edgesChecked += checked;
+    return !search.frontier.empty();
+}
+
+// --- Dijkstra ---
+
+// Index of the highest set bit plus one (0 for 0)
+static inline int BitLength(uint64_t x) {
+    if (x == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    return 64 - __builtin_clzll(x);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (int)index + 1;
+#else
+    int length = 0;
+    while (x) {
+        x >>= 1;
+        length++;
+    }
+    return length;
+#endif
+}
+
+static void HeapPush(std::vector<DijkstraEntry>& heap, DijkstraEntry entry) {
+    heap.push_back(entry);
+    size_t i = heap.size() - 1;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent].distance <= entry.distance) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = entry;
+}
+
+static DijkstraEntry HeapPop(std::vector<DijkstraEntry>& heap) {
+    DijkstraEntry top = heap[0];
+    DijkstraEntry entry = heap.back();
+    heap.pop_back();
+    size_t n = heap.size();
+    if (n == 0) return top;
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && heap[child + 1].distance < heap[child].distance) child++;
+        if (entry.distance <= heap[child].distance) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = entry;
+    return top;
+}
+
+static void QueuePush(DijkstraSearch& search, uint64_t distance, int vertex) {
+    DijkstraEntry entry = { distance, vertex };
+    if (search.queue == DIJKSTRA_BINARY_HEAP) HeapPush(search.heap, entry);
+    else search.buckets[BitLength(distance ^ search.radixLast)].push_back(entry);
+    search.queued++;
+}
+
+// Radix heap: when bucket 0 runs dry, the first non-empty bucket is emptied into the
+// lower ones around its minimum, which becomes the new last key. An entry only ever
+// moves to lower buckets, so each is redistributed at most 64 times.
+static DijkstraEntry QueuePop(DijkstraSearch& search) {
+    search.queued--;
+    if (search.queue == DIJKSTRA_BINARY_HEAP) return HeapPop(search.heap);
+
+    std::vector<DijkstraEntry>* buckets = search.buckets;
+    if (buckets[0].empty()) {
+        int b = 1;
+        while (buckets[b].empty()) b++;
+        uint64_t minimum = buckets[b][0].distance;
+        for (const DijkstraEntry& entry : buckets[b]) minimum = std::min(minimum, entry.distance);
+        search.radixLast = minimum;
+        for (const DijkstraEntry& entry : buckets[b]) buckets[BitLength(entry.distance ^ search.radixLast)].push_back(entry);
+        buckets[b].clear();
+    }
+    DijkstraEntry entry = buckets[0].back();
+    buckets[0].pop_back();
+    return entry;
+}
+
+void StartDijkstra(DijkstraSearch& search, const CsrGraph& graph, int source, DijkstraQueue queue) {
+    int n = graph.vertexCount;
+    search.queue = queue;
+    search.distance.assign(n, GRAPH_UNREACHED);
+    search.parent.assign(n, -1);
+    search.settled.assign(n, 0);
+    search.heap.clear();
+    for (std::vector<DijkstraEntry>& bucket : search.buckets) bucket.clear();
+    search.radixLast = 0;
+    search.queued = 0;
+    search.current = -1;
+    search.settledCount = 0;
+    search.staleEntries = 0;
+    if (source < 0 || source >= n) return;
+    search.distance[source] = 0;
+    search.parent[source] = source;
+    QueuePush(search, 0, source);
+}
+
+bool DijkstraSettleNext(DijkstraSearch& search, const CsrGraph& graph, long long* edgesChecked) {
+    const int* offsets = graph.offsets.data();
+    const int* targets = graph.targets.data();
+    const int* weights = graph.weights.data();
+    int64_t* distance = search.distance.data();
+    while (search.queued > 0) {
+        int v = QueuePop(search).vertex;
+        // A vertex pushed again after a decrease leaves stale entries behind; the
+        // queue is monotone, so they all surface after the vertex was settled
+        if (search.settled[v]) {
+            search.staleEntries++;
+            continue;
+        }
+        search.settled[v] = 1;
+        search.current = v;
+        search.settledCount++;
+        int64_t d = distance[v];
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int u = targets[e];
+            int64_t candidate = d + weights[e];
+            if (candidate < distance[u]) {
+                distance[u] = candidate;
+                search.parent[u] = v;
+                QueuePush(search, (uint64_t)candidate, u);
+            }
+        }
+        if (edgesChecked) *edgesChecked += offsets[v + 1] - offsets[v];
+        return true;
+    }
+    search.current = -1;
+    return false;
+}
+
+// --- Step engines ---
+// BFS: one level per step. Dijkstra: one settled vertex per step. The graph is drawn
+// in place of the bars; comparisons count the row entries examined.
+
+bool StepBfs(VisualizationState& state) {
+    if (!BfsLevel(state.bfs, state.graph, &state.comparisons)) {
+        state.status = VIZ_STATE_FINISHED;
+        return false;
+    }
+    return true;
+}
+
+bool StepDijkstra(VisualizationState& state) {
+    if (!DijkstraSettleNext(state.dijkstra, state.graph, &state.comparisons)) {
+        state.status = VIZ_STATE_FINISHED;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,242 @@
+#include "heapsort.h"
+#include "visualization_state.h"
+#include "simd_support.h" // ALGOWIZZ_PREFETCH
+#include <cstdint>
+#include <cstring>
+
+int NextHeapArity(int arity) {
+    return (arity >= 8) ? 2 : arity * 2;
+}
+
+// --- Full-speed engine ---
+
+// Larger child of a group; a full group is a fixed-count scan the compiler unrolls
+template <int D>
+static inline int MaxChild(const int* heap, int first, int size, long long& compares) {
+    int best = first;
+    if (first + D <= size) {
+        int bestValue = heap[first];
+        for (int k = 1; k < D; k++) {
+            int value = heap[first + k];
+            if (value > bestValue) {
+                best = first + k;
+                bestValue = value;
+            }
+        }
+        compares += D - 1;
+    } else {
+        for (int c = first + 1; c < size; c++) best = (heap[c] > heap[best]) ? c : best;
+        compares += size - first - 1;
+    }
+    return best;
+}
+
+// Top-down sift, for the heap construction (most nodes are near the leaves there)
+template <int D>
+static void SiftDown(int* heap, int size, int node, long long& compares, long long& moves) {
+    int start = node;
+    int value = heap[node];
+    for (;;) {
+        int first = D * node + 1;
+        if (first >= size) break;
+        int best = MaxChild<D>(heap, first, size, compares);
+        compares++;
+        if (heap[best] <= value) break;
+        heap[node] = heap[best];
+        moves++;
+        node = best;
+    }
+    if (node != start) { // A key that did not move costs no write
+        heap[node] = value;
+        moves++;
+    }
+}
+
+// Move the maximum of heap[0..size) to heap[size - 1] and restore the heap on the rest
+template <int D, bool Prefetch>
+static void ExtractMax(int* heap, int size, long long& compares, long long& moves) {
+    int last = heap[size - 1];
+    heap[size - 1] = heap[0];
+    size--;
+
+    // The hole drops to a leaf along the larger children
+    int hole = 0;
+    for (;;) {
+        int first = D * hole + 1;
+        if (first >= size) break;
+        int grandchildren = D * first + 1;
+        if (Prefetch && grandchildren < size) {
+            // Every line the grandchildren touch; heap + 1 is aligned, so index i is on line (i - 1) / 16
+            int lastGrandchild = (grandchildren + D * D <= size ? grandchildren + D * D : size) - 1;
+            for (int line = (grandchildren - 1) / 16; line <= (lastGrandchild - 1) / 16; line++) ALGOWIZZ_PREFETCH(heap + 1 + line * 16);
+        }
+        int best = MaxChild<D>(heap, first, size, compares);
+        heap[hole] = heap[best];
+        moves++;
+        hole = best;
+    }
+    moves += 2; // The root into the sorted tail, and `last` into its final place
+
+    // The displaced element climbs back to its place
+    while (hole > 0) {
+        int parent = (hole - 1) / D;
+        compares++;
+        if (heap[parent] >= last) break;
+        heap[hole] = heap[parent];
+        moves++;
+        hole = parent;
+    }
+    heap[hole] = last;
+}
+
+template <int D>
+static void HeapSortArity(int* heap, int n, bool prefetch, long long& compares, long long& moves) {
+    for (int node = (n - 2) / D; node >= 0; node--) SiftDown<D>(heap, n, node, compares, moves);
+    for (int size = n; size > 1; size--) {
+        if (prefetch) ExtractMax<D, true>(heap, size, compares, moves);
+        else ExtractMax<D, false>(heap, size, compares, moves);
+    }
+}
+
+void HeapSortFull(std::vector<int>& arr, int arity, bool prefetch, long long* comparisons, long long* bytesMoved) {
+    int n = (int)arr.size();
+    if (n < 2) return;
+
+    // Copy into storage where heap + 1 sits on a line boundary (the copies are part of the run)
+    std::vector<int> storage((size_t)n + 16);
+    uintptr_t address = (uintptr_t)(storage.data() + 1);
+    int* heap = storage.data() + ((64 - address % 64) % 64) / sizeof(int);
+    memcpy(heap, arr.data(), (size_t)n * sizeof(int));
+
+    long long compares = 0;
+    long long moves = 0;
+    switch (arity) {
+        case 2: HeapSortArity<2>(heap, n, prefetch, compares, moves); break;
+        case 8: HeapSortArity<8>(heap, n, prefetch, compares, moves); break;
+        default: HeapSortArity<4>(heap, n, prefetch, compares, moves); break;
+    }
+    memcpy(arr.data(), heap, (size_t)n * sizeof(int));
+    if (comparisons) *comparisons += compares;
+    if (bytesMoved) *bytesMoved += moves * (long long)sizeof(int);
+}
+
+// --- Step engine ---
+// Same algorithm on state.array with any arity, tracing every access and recording the
+// nodes the last sift went through (state.heapPath) for the tree overlay.
+
+static int TracedMaxChild(VisualizationState& state, int first, int size) {
+    const int* a = state.array.data();
+    int end = first + state.heapArity < size ? first + state.heapArity : size;
+    int best = first;
+    TraceRead(state, first);
+    for (int c = first + 1; c < end; c++) {
+        TraceRead(state, c);
+        state.comparisons++;
+        if (a[c] > a[best]) best = c;
+    }
+    return best;
+}
+
+static void TracedSiftDown(VisualizationState& state, int size, int node) {
+    int* a = state.array.data();
+    int d = state.heapArity;
+    int value = a[node];
+    TraceRead(state, node);
+    state.heapPath.clear();
+    state.heapPath.push_back(node);
+    for (;;) {
+        int first = d * node + 1;
+        if (first >= size) break;
+        int best = TracedMaxChild(state, first, size);
+        state.comparisons++;
+        if (a[best] <= value) break;
+        a[node] = a[best];
+        TraceWrite(state, node);
+        state.bytesMoved += sizeof(int);
+        node = best;
+        state.heapPath.push_back(node);
+    }
+    if (node != state.heapPath.front()) { // As in SiftDown: a key that did not move costs no write
+        a[node] = value;
+        TraceWrite(state, node);
+        state.bytesMoved += sizeof(int);
+    }
+    state.primaryIndex = node;
+}
+
+static void TracedExtractMax(VisualizationState& state, int size) {
+    int* a = state.array.data();
+    int d = state.heapArity;
+    TraceRead(state, size - 1);
+    TraceRead(state, 0);
+    int last = a[size - 1];
+    a[size - 1] = a[0];
+    TraceWrite(state, size - 1);
+    state.swaps++;
+    state.bytesMoved += 2 * sizeof(int);
+    size--;
+
+    state.heapPath.clear();
+    int hole = 0;
+    state.heapPath.push_back(hole);
+    for (;;) {
+        int first = d * hole + 1;
+        if (first >= size) break;
+        int best = TracedMaxChild(state, first, size);
+        a[hole] = a[best];
+        TraceWrite(state, hole);
+        state.bytesMoved += sizeof(int);
+        hole = best;
+        state.heapPath.push_back(hole);
+    }
+    while (hole > 0) {
+        int parent = (hole - 1) / d;
+        TraceRead(state, parent);
+        state.comparisons++;
+        if (a[parent] >= last) break;
+        a[hole] = a[parent];
+        TraceWrite(state, hole);
+        state.bytesMoved += sizeof(int);
+        hole = parent;
+    }
+    a[hole] = last;
+    TraceWrite(state, hole);
+    state.primaryIndex = hole; // Where the displaced element settled
+}
+
+// sortPhase 0: build the heap, one sift-down per step from the last internal node back
+//              to the root (tertiaryIndex = node sifted next, primaryIndex = where the
+//              last one settled)
+// sortPhase 1: one extraction per step; the heap is [0, secondaryIndex] and everything
+//              after it is sorted
+bool StepHeapSort(VisualizationState& state) {
+    int n = state.size;
+    state.highlightStart = 0;
+
+    if (state.sortPhase == 0) {
+        if (state.tertiaryIndex < 0) {
+            state.sortPhase = 1;
+            state.secondaryIndex = n - 1;
+            state.highlightEnd = n - 1;
+            return true;
+        }
+        TracedSiftDown(state, n, state.tertiaryIndex);
+        state.tertiaryIndex--;
+        state.highlightEnd = n - 1;
+        return true;
+    }
+
+    int end = state.secondaryIndex;
+    if (end <= 0) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.secondaryIndex = -1;
+        state.tertiaryIndex = -1;
+        state.heapPath.clear();
+        return false; // Sort finished
+    }
+    TracedExtractMax(state, end + 1);
+    state.secondaryIndex = end - 1;
+    state.highlightEnd = end - 1;
+    return true;
+}
@@ -1,15 +1,16 @@
 #include "insertionsort.h"
 #include <algorithm> // for std::swap (or just manual swap)
+#include <cstring>   // for std::memmove
 
 // primaryIndex = i (main loop index, end of sorted portion)
 // secondaryIndex = j (comparison index moving backwards)
-// tertiaryIndex = key (value being inserted) - store index instead
+// tertiaryIndex = index of the key element, heldValue = key value
+// (the key's slot is overwritten by the first shift, so its value is held in the state)
 
 bool StepInsertionSort(VisualizationState& state) {
     if (state.primaryIndex == -1) { // Initialize loops
         state.primaryIndex = 1; // i starts from 1
-        state.tertiaryIndex = state.array[1]; // Store the key value conceptually
-        state.secondaryIndex = 0; // j starts from i - 1
+        state.secondaryIndex = -2; // Signal key prep needed
          state.highlightStart = 0; // Sorted portion
          state.highlightEnd = 0;
     }
@@ -30,27 +31,36 @@ bool StepInsertionSort(VisualizationState& state) {
 
     // Insertion logic for one step
     // In a step-by-step manner, we handle one comparison or shift per step.
-    // state.tertiaryIndex holds the *value* conceptually, but we need 'key' var locally.
-    // Let's adjust state: primaryIndex = i, secondaryIndex = j, tertiaryIndex = index of key element
 
     if (state.secondaryIndex == -2) { // State indicating key is being prepared
         state.tertiaryIndex = i; // Index of the element to insert
+        state.heldValue = state.array[i];
+        TraceRead(state, i);
         state.secondaryIndex = i - 1; // Start comparison from j = i - 1
          state.highlightStart = 0; // Mark sorted part
          state.highlightEnd = i-1;
     }
 
     j = state.secondaryIndex;
-    int keyIndex = state.tertiaryIndex;
-    int keyVal = state.array[keyIndex]; // Get value using index
+    int keyVal = state.heldValue;
 
+    if (j >= 0) {
+        state.comparisons++;
+        TraceRead(state, j);
+    }
     if (j >= 0 && state.array[j] > keyVal) {
         // Shift element
         state.array[j + 1] = state.array[j];
+        TraceWrite(state, j + 1);
+        state.bytesMoved += sizeof(int);
         state.secondaryIndex--; // Move j backwards for next comparison/shift
     } else {
-        // Found insertion point or reached beginning
-        state.array[j + 1] = keyVal; // Insert key
+        // Found insertion point or reached beginning; a key that did not move stays put
+        if (j + 1 < i) {
+            state.array[j + 1] = keyVal; // Insert key
+            TraceWrite(state, j + 1);
+            state.bytesMoved += sizeof(int);
+        }
 
         // Move to the next element
         state.primaryIndex++;
@@ -71,4 +81,104 @@ bool StepInsertionSort(VisualizationState& state) {
     }
 
     return true; // Still sorting or just finished the last step
-}
\ No newline at end of file
+}
+
+int BranchlessUpperBound(const int* arr, int n, int key, long long* comparisons) {
+    if (n <= 0) return 0;
+
+    // Halve the window each round; `base` only moves forward, chosen without a branch
+    const int* base = arr;
+    long long probes = 1;
+    while (n > 1) {
+        int half = n / 2;
+        base = (base[half - 1] <= key) ? base + half : base;
+        n -= half;
+        probes++;
+    }
+    if (comparisons) *comparisons += probes;
+    return (int)(base - arr) + (*base <= key);
+}
+
+// Binary insertion: one element is inserted per step. The insertion point is found
+// with a branchless binary search and the sorted run is moved with one block shift.
+// primaryIndex = i (next element to insert), tertiaryIndex = where it landed
+bool StepBinaryInsertionSort(VisualizationState& state) {
+    int i = state.primaryIndex;
+    int n = state.size;
+
+    if (i < 1) i = state.primaryIndex = 1;
+    if (i >= n) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.tertiaryIndex = -1;
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+        return false; // Sort finished
+    }
+
+    int key = state.array[i];
+    TraceRead(state, i);
+    int pos = BranchlessUpperBound(state.array.data(), i, key, &state.comparisons);
+    if (state.memoryTrace) {
+        // Replay the probe sequence of the search for the cache simulator
+        int base = 0;
+        for (int len = i; len > 1; ) {
+            int half = len / 2;
+            TraceRead(state, base + half - 1);
+            if (state.array[base + half - 1] <= key) base += half;
+            len -= half;
+        }
+        if (i > 0) TraceRead(state, base);
+    }
+    if (pos < i) {
+        std::memmove(&state.array[pos + 1], &state.array[pos], (size_t)(i - pos) * sizeof(int));
+        state.array[pos] = key;
+        state.bytesMoved += (long long)(i - pos + 1) * sizeof(int);
+        TraceRange(state, MEM_REGION_ARRAY, pos, i, false);
+        TraceRange(state, MEM_REGION_ARRAY, pos, i + 1, true);
+    }
+
+    state.tertiaryIndex = pos;    // Inserted element
+    state.secondaryIndex = i;     // End of the shifted block
+    state.highlightStart = 0;     // Sorted portion
+    state.highlightEnd = i;
+    state.primaryIndex++;
+    return true;
+}
+
+void InsertionSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved) {
+    long long compares = 0;
+    long long moved = 0;
+    int n = (int)arr.size();
+    for (int i = 1; i < n; i++) {
+        int key = arr[i];
+        int j = i - 1;
+        while (j >= 0) {
+            compares++;
+            if (arr[j] <= key) break;
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        if (j + 1 < i) { // Same count as the binary version: nothing for a key already in place
+            arr[j + 1] = key;
+            moved += (long long)(i - j) * sizeof(int);
+        }
+    }
+    if (comparisons) *comparisons += compares;
+    if (bytesMoved) *bytesMoved += moved;
+}
+
+void BinaryInsertionSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved) {
+    long long moved = 0;
+    int n = (int)arr.size();
+    for (int i = 1; i < n; i++) {
+        int key = arr[i];
+        int pos = BranchlessUpperBound(arr.data(), i, key, comparisons);
+        if (pos < i) {
+            std::memmove(&arr[pos + 1], &arr[pos], (size_t)(i - pos) * sizeof(int));
+            arr[pos] = key;
+            moved += (long long)(i - pos + 1) * sizeof(int);
+        }
+    }
+    if (bytesMoved) *bytesMoved += moved;
+}
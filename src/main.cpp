@@ -1,7 +1,8 @@
 #include "raylib.h"
-#include "resource_dir.h"   // utility header for SearchAndSetResourceDir
 #include "visualization_state.h" // Include the new state management
 #include "ui_components.h"     // Include the button component
+#include "profiler.h"          // Frame zones and the flame strip
+#include "resources.h"         // Embedded textures and the startup report
 
 #include <string> // For std::string
 
@@ -21,14 +22,54 @@ typedef enum {
 static const int screenWidth = 1200; // Increased width
 static const int screenHeight = 800; // Increased height
 
+// Algorithms offered on the main menu, in display order
+typedef struct {
+    const char* label;
+    AlgorithmType algorithm;
+} MenuEntry;
+
+static const MenuEntry algorithmMenu[] = {
+    { "Quicksort", ALGO_QUICKSORT },
+    { "Bubble Sort", ALGO_BUBBLESORT },
+    { "Insertion Sort", ALGO_INSERTIONSORT },
+    { "Bitonic Network", ALGO_BITONICSORT },
+    { "Odd-Even Merge Net", ALGO_ODDEVENMERGESORT },
+    { "Odd-Even Transposition", ALGO_ODDEVENTRANSPOSITION },
+    { "Cocktail Shaker", ALGO_COCKTAILSORT },
+    { "Binary Insertion", ALGO_BINARYINSERTIONSORT },
+    { "Shell Sort", ALGO_SHELLSORT },
+    { "Powersort", ALGO_POWERSORT },
+    { "Counting Sort", ALGO_COUNTINGSORT },
+    { "LSD Radix Sort", ALGO_RADIXSORT },
+    { "Heapsort (d-ary)", ALGO_HEAPSORT },
+    { "Quickselect", ALGO_QUICKSELECT },
+    { "Floyd-Rivest Select", ALGO_FLOYDRIVEST },
+    { "Heap Top-k", ALGO_HEAPTOPK },
+    { "External Merge Sort", ALGO_EXTERNALSORT },
+    { "Multikey Quicksort", ALGO_MULTIKEYQUICKSORT },
+    { "MSD Radix (Strings)", ALGO_MSDRADIXSORT },
+    { "Streaming Ingest", ALGO_STREAMING },
+    { "BFS (Graph)", ALGO_BFS },
+    { "Dijkstra (Graph)", ALGO_DIJKSTRA },
+    { "Auto", ALGO_AUTO },
+};
+static const int algorithmMenuCount = sizeof(algorithmMenu) / sizeof(algorithmMenu[0]);
+
 static GameScreen currentScreen = SCREEN_MAIN_MENU;
 static VisualizationState vizState = {}; // Global state for visualization
 
 // UI Elements
-static Texture2D buttonTexture;
+static Texture2D buttonTexture;   // id 0 (buttons drawn as plain rectangles) until the upload lands
 static NPatchInfo buttonNpatchInfo;
+static bool resourcesReady = false;
+static bool firstFrameDrawn = false;
+static bool startupReported = false;
 static Font mainFont; // Optional: Load a custom font
 
+// Profiler overlay (F3) and the result of the last trace export (F4)
+static const char* traceExportPath = "algowizz_trace.json";
+static std::string traceExportMessage;
+
 //----------------------------------------------------------------------------------
 // Module Functions Declaration
 //----------------------------------------------------------------------------------
@@ -41,9 +82,12 @@ static void UpdateVisualizationScreen(void);
 static void DrawVisualizationScreen(void);
 static void UpdateSettingsScreen(void);
 static void DrawSettingsScreen(void);
+static void UpdateProfilerKeys(void);
+static void DrawFlameStrip(void);
 
 // Initialization
 static void InitializeApp(void);
+static void UpdateResourceUploads(void);
 static void CleanupApp(void);
 
 
@@ -76,45 +120,52 @@ void InitializeApp(void) {
     SetTargetFPS(60);
     SetExitKey(KEY_NULL); // Disable default ESC exit, handle manually
 
-    // Utility function from resource_dir.h to find the resources folder
-    SearchAndSetResourceDir("resources");
+    MarkStartupPhase("window");
 
-    // Load resources
-    buttonTexture = LoadTexture("rec.png"); // Make sure rec.png is in resources
-    if (buttonTexture.id == 0) {
-        // Handle error - texture not loaded (draw default rects?)
-        TraceLog(LOG_WARNING, "Failed to load button texture 'rec.png'");
-        // Use basic colors if texture fails
-    }
+    // Resources are embedded in the binary; images decode on a worker while the first frames draw
+    StartResourceLoading();
 
-    // Define the N-Patch info for the button texture
-    // Assuming rec.png is a simple 3x3 grid for stretching
-    // Adjust these values based on your actual rec.png image borders
+    // Optional: Load custom font
+    // A .ttf dropped into resources is embedded too: LoadFontFromMemory(r->fileType, r->data, r->size, ...)
+    // with r = FindEmbeddedResource("your_font.ttf"). raylib's default font is already built in.
+
+    // Initialize Visualization State
+    InitializeVisualizationState(vizState, 50); // Default size 50
+}
+
+// Main thread, once per frame until the textures are on the GPU
+void UpdateResourceUploads(void) {
+    if (resourcesReady || !UploadLoadedResources()) return;
+    resourcesReady = true;
+    MarkStartupPhase("textures");
+
+    // rec.png is a 3x3 grid for stretching; adjust the borders to the image
+    buttonTexture = GetResourceTexture("rec.png");
     buttonNpatchInfo = {
         (Rectangle){ 0.0f, 0.0f, (float)buttonTexture.width, (float)buttonTexture.height },
         8, 8, 8, 8, // Left, top, right, bottom border sizes in pixels
         NPATCH_NINE_PATCH // Layout type
     };
-
-    // Optional: Load custom font
-    // mainFont = LoadFont("your_font.ttf"); // Make sure font is in resources
-
-    // Initialize Visualization State
-    InitializeVisualizationState(vizState, 50); // Default size 50
 }
 
 void CleanupApp(void) {
-    UnloadTexture(buttonTexture);
+    UnloadResources(); // Owns buttonTexture
     // UnloadFont(mainFont); // If loaded
     if (!vizState.array.empty()) {
         // vector manages its own memory, no MemFree needed unless using raw pointers
     }
+    ReleaseExternalSort(vizState.externalSort); // Waits for I/O in flight, removes the temp files
+    CloseEventStream(vizState.eventStream);      // Removes the shared-memory object
     CloseWindow();
 }
 
 
 void UpdateDrawFrame(void)
 {
+    ProfilerMarkFrame();
+    UpdateProfilerKeys();
+    UpdateResourceUploads();
+
     // Update based on the current screen
     switch (currentScreen) {
         case SCREEN_MAIN_MENU:
@@ -149,7 +200,68 @@ void UpdateDrawFrame(void)
     // Optional: Draw FPS
     DrawFPS(10, 10);
 
-    EndDrawing();
+    if (IsProfilerEnabled()) DrawFlameStrip();
+
+    {
+        PROFILE_ZONE("EndDrawing"); // Includes the wait for vsync
+        EndDrawing();
+    }
+
+    if (!startupReported) {
+        if (!firstFrameDrawn) MarkStartupPhase("first frame");
+        firstFrameDrawn = true;
+        if (resourcesReady) MarkStartupPhase("interactive");
+        startupReported = resourcesReady;
+    }
+}
+
+// --- Profiler ---
+void UpdateProfilerKeys(void) {
+    if (IsKeyPressed(KEY_F3)) {
+        SetProfilerEnabled(!IsProfilerEnabled());
+        traceExportMessage.clear();
+    }
+    if (IsKeyPressed(KEY_F4) && IsProfilerEnabled()) {
+        int events = ExportChromeTrace(traceExportPath);
+        traceExportMessage = (events >= 0) ? TextFormat("Wrote %d events to %s", events, traceExportPath)
+                                           : TextFormat("Could not write %s", traceExportPath);
+    }
+}
+
+// Zones of the previous frame, one row per nesting level, scaled to the frame length
+void DrawFlameStrip(void) {
+    static std::vector<ProfileEvent> zones;
+    uint64_t frameBegin = 0, frameEnd = 0;
+    if (!GetLastFrameZones(zones, frameBegin, frameEnd) || frameEnd <= frameBegin) return;
+
+    static const Color zoneColors[] = { ORANGE, SKYBLUE, LIME, PINK, GOLD, VIOLET, BEIGE, MAROON };
+    const int zoneColorCount = sizeof(zoneColors) / sizeof(zoneColors[0]);
+    const float rowHeight = 12;
+    const float stripX = 10;
+    const float stripWidth = screenWidth - 20;
+    const float stripY = screenHeight - 120;
+    double frameTicks = (double)(frameEnd - frameBegin);
+
+    DrawRectangle(0, (int)stripY - 16, screenWidth, (int)(rowHeight * 4 + 20), { 0, 0, 0, 180 });
+    DrawText(TextFormat("Frame %.2f ms   F4: export %s   %s   Startup: %s", ProfilerTicksToMs(frameEnd - frameBegin),
+                        traceExportPath, traceExportMessage.c_str(), GetStartupReport()),
+             (int)stripX, (int)stripY - 14, 10, LIGHTGRAY);
+    for (const ProfileEvent& zone : zones) {
+        if (zone.depth >= 4) continue;
+        Rectangle rect = {
+            stripX + (float)((zone.begin - frameBegin) / frameTicks) * stripWidth,
+            stripY + zone.depth * rowHeight,
+            (float)((zone.end - zone.begin) / frameTicks) * stripWidth,
+            rowHeight - 1
+        };
+        if (rect.width < 1) rect.width = 1;
+        // Color by name so a zone keeps its color from frame to frame
+        size_t hash = 0;
+        for (const char* c = zone.name; *c; c++) hash = hash * 31 + (unsigned char)*c;
+        DrawRectangleRec(rect, zoneColors[hash % zoneColorCount]);
+        const char* label = TextFormat("%s %.2f", zone.name, ProfilerTicksToMs(zone.end - zone.begin));
+        if (MeasureText(label, 10) + 4 < rect.width) DrawText(label, (int)rect.x + 2, (int)rect.y + 1, 10, BLACK);
+    }
 }
 
 // --- Main Menu Screen ---
@@ -158,12 +270,22 @@ void UpdateMainMenuScreen(void) {
      if (IsKeyPressed(KEY_Q)) exit(0); // Quick exit with Q
 }
 
-void DrawMainMenuScreen(void) {
+// Main menu widgets: the title, one button per algorithm, then Settings and Exit
+#define MENU_TITLE 0
+#define MENU_FIRST_ALGORITHM 1
+#define MENU_SETTINGS (MENU_FIRST_ALGORITHM + algorithmMenuCount)
+#define MENU_EXIT (MENU_SETTINGS + 1)
+static UiPanel menuPanel;
+
+// The menu never changes, so it is laid out once
+static void LayoutMainMenu(void) {
+    InitUiPanel(menuPanel, MENU_EXIT + 1);
+
     // Title
     const char* title = "Algowizz++";
     int titleFontSize = 60;
     int titleWidth = MeasureText(title, titleFontSize); // Use mainFont if loaded
-    DrawText(title, (screenWidth - titleWidth) / 2, 80, titleFontSize, WHITE); // Use mainFont if loaded
+    SetUiLabel(menuPanel, MENU_TITLE, (float)((screenWidth - titleWidth) / 2), 80, title, titleFontSize, WHITE);
 
     // Button properties
     float buttonWidth = 250;
@@ -178,58 +300,46 @@ void DrawMainMenuScreen(void) {
     Color btnPressed = GRAY;
     Color textColor = BLACK;
 
-    // Algorithm Buttons
-    NButton quicksortButton = {
-        { centerX - buttonWidth / 2, startY, buttonWidth, buttonHeight },
-        "Quicksort", buttonTexture, buttonNpatchInfo,
-        btnNormal, btnHover, btnPressed, textColor, 20
-    };
-    if (DrawNButton(quicksortButton)) {
-        vizState.currentAlgorithm = ALGO_QUICKSORT;
-        ResetVisualizationState(vizState); // Prepare state for this algo
-        currentScreen = SCREEN_VISUALIZATION;
+    // Algorithm Buttons, four columns
+    int columns = 4;
+    float gridWidth = columns * buttonWidth + (columns - 1) * buttonSpacing;
+    for (int i = 0; i < algorithmMenuCount; i++) {
+        int row = i / columns;
+        int column = i % columns;
+        SetUiButton(menuPanel, MENU_FIRST_ALGORITHM + i,
+                    { centerX - gridWidth / 2 + column * (buttonWidth + buttonSpacing), startY + (buttonHeight + buttonSpacing) * row, buttonWidth, buttonHeight },
+                    algorithmMenu[i].label, btnNormal, btnHover, btnPressed, textColor, 20);
     }
-
-     NButton bubbleButton = {
-         { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * 1, buttonWidth, buttonHeight },
-         "Bubble Sort", buttonTexture, buttonNpatchInfo,
-         btnNormal, btnHover, btnPressed, textColor, 20
-     };
-     if (DrawNButton(bubbleButton)) {
-         vizState.currentAlgorithm = ALGO_BUBBLESORT;
-         ResetVisualizationState(vizState);
-         currentScreen = SCREEN_VISUALIZATION;
-     }
-
-      NButton insertionButton = {
-         { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * 2, buttonWidth, buttonHeight },
-         "Insertion Sort", buttonTexture, buttonNpatchInfo,
-         btnNormal, btnHover, btnPressed, textColor, 20
-     };
-      if (DrawNButton(insertionButton)) {
-          vizState.currentAlgorithm = ALGO_INSERTIONSORT;
-          ResetVisualizationState(vizState);
-          currentScreen = SCREEN_VISUALIZATION;
-      }
+    int menuRows = (algorithmMenuCount + columns - 1) / columns;
 
     // Settings Button (placeholder)
-     NButton settingsButton = {
-         { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * 3, buttonWidth, buttonHeight },
-         "Settings", buttonTexture, buttonNpatchInfo,
-         btnNormal, btnHover, btnPressed, textColor, 20
-     };
-     if (DrawNButton(settingsButton)) {
-         currentScreen = SCREEN_SETTINGS;
-     }
-
+    SetUiButton(menuPanel, MENU_SETTINGS,
+                { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * menuRows, buttonWidth, buttonHeight },
+                "Settings", btnNormal, btnHover, btnPressed, textColor, 20);
 
     // Exit Button
-    NButton exitButton = {
-        { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * 4 + 40, buttonWidth, buttonHeight }, // Extra space before exit
-        "Exit", buttonTexture, buttonNpatchInfo,
-        btnNormal, {255, 100, 100, 255} , {200, 80, 80, 255}, textColor, 20 // Red hover/press for exit
-    };
-    if (DrawNButton(exitButton)) {
+    SetUiButton(menuPanel, MENU_EXIT,
+                { centerX - buttonWidth / 2, startY + (buttonHeight + buttonSpacing) * (menuRows + 1) + 40, buttonWidth, buttonHeight }, // Extra space before exit
+                "Exit", btnNormal, {255, 100, 100, 255}, {200, 80, 80, 255}, textColor, 20); // Red hover/press for exit
+}
+
+void DrawMainMenuScreen(void) {
+    if (menuPanel.widgets.empty()) LayoutMainMenu();
+    SetUiPanelTexture(menuPanel, buttonTexture, buttonNpatchInfo); // The texture arrives after the first frames
+    UpdateUiPanel(menuPanel);
+    DrawUiPanel(menuPanel);
+
+    for (int i = 0; i < algorithmMenuCount; i++) {
+        if (IsUiWidgetClicked(menuPanel, MENU_FIRST_ALGORITHM + i)) {
+            vizState.currentAlgorithm = algorithmMenu[i].algorithm;
+            ResetVisualizationState(vizState); // Prepare state for this algo
+            currentScreen = SCREEN_VISUALIZATION;
+        }
+    }
+    if (IsUiWidgetClicked(menuPanel, MENU_SETTINGS)) {
+        currentScreen = SCREEN_SETTINGS;
+    }
+    if (IsUiWidgetClicked(menuPanel, MENU_EXIT)) {
        CloseWindow(); // Trigger the main loop exit condition
        // Note: CleanupApp() will be called after the loop breaks
     }
@@ -242,17 +352,20 @@ void UpdateVisualizationScreen(void) {
         // Optional: Pause before going back?
         vizState.status = VIZ_STATE_IDLE;
         vizState.currentAlgorithm = ALGO_NONE; // Deselect algo when going back
+        vizState.autoSelect = false;
         currentScreen = SCREEN_MAIN_MENU;
         return; // Prevent further updates this frame
     }
+    if (IsKeyPressed(KEY_F5)) SetEventStreamEnabled(vizState, !vizState.eventStream.active);
 
     // Update the core visualization state machine
+    PROFILE_ZONE("UpdateVisualization");
     UpdateVisualization(vizState, GetFrameTime());
 }
 
 void DrawVisualizationScreen(void) {
     // Define areas
-    Rectangle controlPanelRect = { 0, 0, (float)screenWidth, 60 }; // Top panel for controls
+    Rectangle controlPanelRect = { 0, 0, (float)screenWidth, 100 }; // Top panel for controls (two rows)
     Rectangle vizPanelRect = { 0, controlPanelRect.height, (float)screenWidth, (float)screenHeight - controlPanelRect.height }; // Rest of screen for bars
 
     // Draw Backgrounds for panels (optional)
@@ -260,24 +373,29 @@ void DrawVisualizationScreen(void) {
     DrawRectangleRec(vizPanelRect, { 50, 50, 50, 255 });     // Slightly lighter for viz area
 
     // Draw the visualization bars
-    DrawVisualizationPanel(vizState, vizPanelRect);
+    {
+        PROFILE_ZONE("DrawVisualizationPanel");
+        DrawVisualizationPanel(vizState, vizPanelRect);
+    }
 
     // Draw the control panel UI elements
-    DrawControlPanel(vizState, controlPanelRect, buttonTexture, buttonNpatchInfo);
+    {
+        PROFILE_ZONE("DrawControlPanel");
+        DrawControlPanel(vizState, controlPanelRect, buttonTexture, buttonNpatchInfo);
+    }
 
     // Draw Algorithm Title
-    const char* algoTitle = "Select Algorithm";
-    switch(vizState.currentAlgorithm) {
-        case ALGO_QUICKSORT: algoTitle = "Quicksort"; break;
-        case ALGO_BUBBLESORT: algoTitle = "Bubble Sort"; break;
-        case ALGO_INSERTIONSORT: algoTitle = "Insertion Sort"; break;
-        default: break;
-    }
+    const char* algoTitle = vizState.autoSelect ? TextFormat("Auto: %s", GetAlgorithmName(vizState.currentAlgorithm))
+                                                : GetAlgorithmName(vizState.currentAlgorithm);
      DrawText(algoTitle, (int)controlPanelRect.x + 15, screenHeight - 30, 20, LIGHTGRAY); // Bottom left corner
-     DrawText(TextFormat("Array Size: %d", vizState.size), screenWidth - 150, screenHeight - 30, 20, LIGHTGRAY); // Bottom Right
+     DrawText(TextFormat("Array Size: %d", vizState.size), screenWidth - 200, screenHeight - 30, 20, LIGHTGRAY); // Bottom Right
+     DrawText(TextFormat("Steps: %lld   Comparisons: %lld   Swaps: %lld   Bytes moved: %lld",
+                         vizState.stepCount, vizState.comparisons, vizState.swaps, vizState.bytesMoved),
+              300, screenHeight - 28, 16, LIGHTGRAY); // Bottom center
 
      // Draw instructions
-     DrawText("ESC/Backspace: Back to Menu", 10, screenHeight - 50, 10, GRAY);
+     DrawText(TextFormat("ESC/Backspace: Back to Menu   F3: Profiler   F5: Event stream (%s)", GetEventStreamStatus(vizState.eventStream)),
+              10, screenHeight - 50, 10, GRAY);
 }
 
 // --- Settings Screen (Placeholder) ---
@@ -0,0 +1,161 @@
+#include "oddevensort.h"
+#include "simd_support.h"
+#include "profiler.h"
+#include <algorithm> // For std::swap, std::min
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Scalar phase over the pairs whose lower index lies in [begin, end)
+static long long OddEvenRangeScalar(int* arr, int n, int begin, int end) {
+    long long swaps = 0;
+    for (int i = begin; i < end && i + 1 < n; i += 2) {
+        if (arr[i] > arr[i + 1]) {
+            std::swap(arr[i], arr[i + 1]);
+            swaps++;
+        }
+    }
+    return swaps;
+}
+
+#if ALGOWIZZ_X86
+// Eight lanes hold four pairs: swap neighbours, then even lanes keep the minimum
+// and odd lanes the maximum.
+ALGOWIZZ_TARGET_AVX2
+static long long OddEvenRangeAVX2(int* arr, int n, int begin, int end) {
+    long long changedLanes = 0;
+    int i = begin;
+    for (; i + 8 <= end && i + 8 <= n; i += 8) {
+        __m256i values = _mm256_loadu_si256((const __m256i*)(arr + i));
+        __m256i neighbours = _mm256_shuffle_epi32(values, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256i result = _mm256_blend_epi32(_mm256_min_epi32(values, neighbours), _mm256_max_epi32(values, neighbours), 0xAA);
+        _mm256_storeu_si256((__m256i*)(arr + i), result);
+
+        int unchanged = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(result, values)));
+        for (int bits = ~unchanged & 0xFF; bits; bits &= bits - 1) changedLanes++;
+    }
+    // A swapped pair changes two lanes (equal elements never count as a swap)
+    return changedLanes / 2 + OddEvenRangeScalar(arr, n, i, end);
+}
+#endif
+
+static long long OddEvenRange(int* arr, int n, int begin, int end) {
+#if ALGOWIZZ_X86
+    if (CpuSupportsAVX2()) return OddEvenRangeAVX2(arr, n, begin, end);
+#endif
+    return OddEvenRangeScalar(arr, n, begin, end);
+}
+
+// Split [parity, n) into per-thread chunks whose starts keep the phase parity
+static void GetThreadChunk(int n, int parity, int threads, int t, int& begin, int& end) {
+    int pairs = (n - parity) / 2;
+    int perThread = (pairs + threads - 1) / threads;
+    begin = parity + 2 * std::min(pairs, t * perThread);
+    end = parity + 2 * std::min(pairs, (t + 1) * perThread);
+}
+
+int GetOddEvenThreadCount(int n) {
+    if (n < ODDEVEN_PARALLEL_THRESHOLD) return 1;
+    int hardware = (int)std::thread::hardware_concurrency();
+    return std::max(1, std::min(hardware, n / (ODDEVEN_PARALLEL_THRESHOLD / 4)));
+}
+
+long long OddEvenPhase(int* arr, int n, int parity) {
+    return OddEvenRange(arr, n, parity, n);
+}
+
+// Reusable barrier for the persistent workers (std::barrier needs C++20)
+class PhaseBarrier {
+public:
+    explicit PhaseBarrier(int count) : threshold(count), waiting(0), generation(0) {}
+
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        int arrivedGeneration = generation;
+        if (++waiting == threshold) {
+            waiting = 0;
+            generation++;
+            condition.notify_all();
+        } else {
+            condition.wait(lock, [&] { return generation != arrivedGeneration; });
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    int threshold;
+    int waiting;
+    int generation;
+};
+
+void OddEvenTranspositionSortFull(std::vector<int>& arr, bool earlyExit) {
+    int n = (int)arr.size();
+    if (n < 2) return;
+
+    int threads = GetOddEvenThreadCount(n);
+    if (threads == 1) {
+        for (int phase = 0; phase < n; phase += 2) {
+            long long swaps = OddEvenRange(arr.data(), n, 0, n) + OddEvenRange(arr.data(), n, 1, n);
+            if (earlyExit && swaps == 0) break;
+        }
+        return;
+    }
+
+    // A round is an even phase followed by an odd phase. Swap counts alternate
+    // between two slots so a slot is only reset once every thread has read it.
+    PhaseBarrier barrier(threads);
+    std::atomic<long long> roundSwaps[2];
+    roundSwaps[0] = 0;
+    roundSwaps[1] = 0;
+    int* data = arr.data();
+
+    auto worker = [&](int t) {
+        PROFILE_ZONE("Odd-even worker");
+        for (int round = 0; 2 * round < n; round++) {
+            std::atomic<long long>& slot = roundSwaps[round & 1];
+            for (int parity = 0; parity < 2; parity++) {
+                int begin, end;
+                GetThreadChunk(n, parity, threads, t, begin, end);
+                long long swaps = OddEvenRange(data, n, begin, end);
+                if (swaps) slot += swaps;
+                barrier.Wait();
+                if (parity == 0 && t == 0) roundSwaps[(round + 1) & 1] = 0;
+            }
+            if (earlyExit && slot.load() == 0) break; // Every thread sees the same total
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) workers.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& w : workers) w.join();
+}
+
+// Each step runs one full phase: every disjoint adjacent pair of the current parity
+// is compared at once. oddEvenPhase = phases completed, quietPhases = phases without swaps
+bool StepOddEvenTranspositionSort(VisualizationState& state) {
+    int n = state.size;
+    bool sorted = (state.oddEvenPhase >= n) || (state.earlyExit && state.quietPhases >= 2);
+    if (sorted) {
+        state.status = VIZ_STATE_FINISHED;
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+        return false; // Sort finished
+    }
+
+    int parity = state.oddEvenPhase & 1;
+    long long swaps = OddEvenPhase(state.array.data(), n, parity);
+    state.comparisons += (n - parity) / 2;
+    TraceRange(state, MEM_REGION_ARRAY, parity, n, false);
+    TraceRange(state, MEM_REGION_ARRAY, parity, n, true);
+    state.swaps += swaps;
+    state.bytesMoved += swaps * 2 * (long long)sizeof(int);
+    state.quietPhases = (swaps == 0) ? state.quietPhases + 1 : 0;
+    state.oddEvenPhase++;
+
+    state.highlightStart = 0;
+    state.highlightEnd = n - 1;
+    return true;
+}
@@ -0,0 +1,124 @@
+#include "perfcounters.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+static char perfStatus[96] = "not opened yet";
+
+const char* GetPerfCounterName(PerfCounterKind kind) {
+    switch (kind) {
+        case PERF_CYCLES:        return "cycles";
+        case PERF_INSTRUCTIONS:  return "instructions";
+        case PERF_BRANCH_MISSES: return "branch-misses";
+        case PERF_CACHE_MISSES:  return "cache-misses";
+        default:                 return "?";
+    }
+}
+
+const char* GetPerfCounterStatus(void) {
+    return perfStatus;
+}
+
+#if defined(__linux__)
+
+static const unsigned long long perfEventConfig[PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+// Each counter is opened on its own rather than as a group, so one unsupported
+// event does not take the others down with it
+static int OpenPerfEvent(unsigned long long config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;        // Count the odd-even worker threads too
+    attr.exclude_kernel = 1; // Allowed without privileges at perf_event_paranoid 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0 /* this thread */, -1 /* any cpu */, -1, 0);
+}
+
+bool OpenPerfCounters(PerfCounterSet& set) {
+    int opened = 0;
+    int firstError = 0;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        set.fds[i] = OpenPerfEvent(perfEventConfig[i]);
+        if (set.fds[i] >= 0) opened++;
+        else if (firstError == 0) firstError = errno;
+    }
+    if (opened > 0) snprintf(perfStatus, sizeof(perfStatus), "%d/%d counters", opened, PERF_COUNTER_COUNT);
+    else snprintf(perfStatus, sizeof(perfStatus), "perf_event_open: %s", strerror(firstError));
+    return opened > 0;
+}
+
+void ClosePerfCounters(PerfCounterSet& set) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (set.fds[i] >= 0) close(set.fds[i]);
+        set.fds[i] = -1;
+    }
+}
+
+void StartPerfCounters(PerfCounterSet& set) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (set.fds[i] < 0) continue;
+        ioctl(set.fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(set.fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void StopPerfCounters(PerfCounterSet& set, PerfSample& sample) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (set.fds[i] >= 0) ioctl(set.fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        sample.values[i] = 0;
+        sample.valid[i] = false;
+        if (set.fds[i] < 0) continue;
+
+        // value, time enabled, time running
+        unsigned long long data[3] = { 0, 0, 0 };
+        if (read(set.fds[i], data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) continue;
+        double scale = (data[1] > data[2]) ? (double)data[1] / (double)data[2] : 1.0;
+        sample.values[i] = (long long)((double)data[0] * scale);
+        sample.valid[i] = true;
+    }
+}
+
+#else // No perf_event_open: every counter is unavailable
+
+bool OpenPerfCounters(PerfCounterSet& set) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) set.fds[i] = -1;
+    snprintf(perfStatus, sizeof(perfStatus), "hardware counters need Linux perf_event_open");
+    return false;
+}
+
+void ClosePerfCounters(PerfCounterSet& set) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) set.fds[i] = -1;
+}
+
+void StartPerfCounters(PerfCounterSet& set) {
+    (void)set;
+}
+
+void StopPerfCounters(PerfCounterSet& set, PerfSample& sample) {
+    (void)set;
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        sample.values[i] = 0;
+        sample.valid[i] = false;
+    }
+}
+
+#endif
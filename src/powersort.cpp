@@ -0,0 +1,273 @@
+#include "powersort.h"
+#include "insertionsort.h" // For BranchlessUpperBound
+#include <algorithm>       // For std::reverse, std::upper_bound, std::lower_bound
+#include <cstring>         // For std::memmove
+
+int ComputeMinRun(int n) {
+    if (n < 64) return std::max(4, n / 6);
+    // Take the six most significant bits of n, plus one if any remaining bit is set
+    int r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+int DetectRun(int* arr, int n, int start, int minRun, long long* comparisons, long long* bytesMoved) {
+    int end = start + 1;
+    long long compares = 0;
+    if (end < n) {
+        compares++;
+        if (arr[end] < arr[start]) {
+            // Strictly descending (so reversing keeps equal elements stable)
+            while (end + 1 < n && (compares++, arr[end + 1] < arr[end])) end++;
+            end++;
+            std::reverse(arr + start, arr + end);
+            if (bytesMoved) *bytesMoved += (long long)(end - start) * sizeof(int);
+        } else {
+            while (end + 1 < n && (compares++, arr[end + 1] >= arr[end])) end++;
+            end++;
+        }
+    }
+    if (comparisons) *comparisons += compares;
+
+    // Short run: extend it to minRun with binary insertion
+    int forcedEnd = std::min(n, start + minRun);
+    for (; end < forcedEnd; end++) {
+        int key = arr[end];
+        int pos = start + BranchlessUpperBound(arr + start, end - start, key, comparisons);
+        if (pos < end) {
+            std::memmove(arr + pos + 1, arr + pos, (size_t)(end - pos) * sizeof(int));
+            arr[pos] = key;
+            if (bytesMoved) *bytesMoved += (long long)(end - pos + 1) * sizeof(int);
+        }
+    }
+    return end - start;
+}
+
+int NodePower(int n, int beginA, int beginB, int endB) {
+    // Midpoints of both runs as fractions of n, scaled by 2n to stay integral:
+    // a = (2 * beginA + lengthA) / 2n, b = (2 * beginB + lengthB) / 2n.
+    // The power is the first binary digit at which a and b differ.
+    long long l2 = (long long)beginA + beginB;
+    long long r2 = (long long)beginB + endB;
+    int power = 0;
+    while (true) {
+        power++;
+        if (l2 >= n) {
+            l2 -= n;
+            r2 -= n;
+        } else if (r2 >= n) {
+            return power;
+        }
+        l2 *= 2;
+        r2 *= 2;
+    }
+}
+
+// Number of leading elements of base[0, len) that are <= key (exponential then binary search)
+static int GallopRight(int key, const int* base, int len, long long& compares) {
+    int bound = 1;
+    while (bound <= len && (compares++, base[bound - 1] <= key)) bound *= 2;
+    int lo = bound / 2;
+    int hi = std::min(bound, len);
+    const int* found = std::upper_bound(base + lo, base + hi, key);
+    for (int span = hi - lo; span > 0; span /= 2) compares++;
+    return (int)(found - base);
+}
+
+// Number of leading elements of base[0, len) that are < key
+static int GallopLeft(int key, const int* base, int len, long long& compares) {
+    int bound = 1;
+    while (bound <= len && (compares++, base[bound - 1] < key)) bound *= 2;
+    int lo = bound / 2;
+    int hi = std::min(bound, len);
+    const int* found = std::lower_bound(base + lo, base + hi, key);
+    for (int span = hi - lo; span > 0; span /= 2) compares++;
+    return (int)(found - base);
+}
+
+void MergeRunsGalloping(int* arr, int lo, int mid, int hi, std::vector<int>& tmp, int& minGallop,
+                        long long* comparisons, long long* bytesMoved) {
+    long long compares = 0;
+    long long moved = 0;
+
+    // Elements of A that are <= B[0] and elements of B that are >= A's last are already in place
+    lo += GallopRight(arr[mid], arr + lo, mid - lo, compares);
+    if (lo < mid) hi = mid + GallopLeft(arr[mid - 1], arr + mid, hi - mid, compares);
+
+    if (lo < mid && mid < hi) {
+        int lengthA = mid - lo;
+        tmp.assign(arr + lo, arr + mid);
+        moved += (long long)lengthA * sizeof(int);
+
+        int i = 0;   // Next element of A (in tmp)
+        int j = mid; // Next element of B (in place)
+        int k = lo;  // Output position; always < j while A has elements left
+        while (i < lengthA && j < hi) {
+            // One element at a time until one side keeps winning
+            int winsA = 0;
+            int winsB = 0;
+            while (i < lengthA && j < hi && winsA < minGallop && winsB < minGallop) {
+                compares++;
+                if (arr[j] < tmp[i]) {
+                    arr[k++] = arr[j++];
+                    winsB++;
+                    winsA = 0;
+                } else {
+                    arr[k++] = tmp[i++];
+                    winsA++;
+                    winsB = 0;
+                }
+                moved += sizeof(int);
+            }
+
+            // Galloping: copy whole blocks while the searches keep paying off
+            while (i < lengthA && j < hi) {
+                int countA = GallopRight(arr[j], tmp.data() + i, lengthA - i, compares);
+                std::memmove(arr + k, tmp.data() + i, (size_t)countA * sizeof(int));
+                i += countA;
+                k += countA;
+                moved += (long long)countA * sizeof(int);
+                if (i >= lengthA) break;
+
+                arr[k++] = arr[j++];
+                moved += sizeof(int);
+                if (j >= hi) break;
+
+                int countB = GallopLeft(tmp[i], arr + j, hi - j, compares);
+                std::memmove(arr + k, arr + j, (size_t)countB * sizeof(int));
+                j += countB;
+                k += countB;
+                moved += (long long)countB * sizeof(int);
+                if (j >= hi) break;
+
+                arr[k++] = tmp[i++];
+                moved += sizeof(int);
+
+                if (countA < POWERSORT_MIN_GALLOP && countB < POWERSORT_MIN_GALLOP) {
+                    minGallop++; // Galloping didn't pay off; make it harder to enter again
+                    break;
+                }
+                if (minGallop > 1) minGallop--;
+            }
+        }
+
+        // Whatever is left of A goes to the end; leftovers of B are already in place
+        std::memmove(arr + k, tmp.data() + i, (size_t)(lengthA - i) * sizeof(int));
+        moved += (long long)(lengthA - i) * sizeof(int);
+    }
+
+    if (comparisons) *comparisons += compares;
+    if (bytesMoved) *bytesMoved += moved;
+}
+
+void PowersortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved) {
+    int n = (int)arr.size();
+    if (n < 2) return;
+
+    struct Run { int start; int length; int power; };
+    std::vector<Run> stack;
+    std::vector<int> tmp;
+    int minRun = ComputeMinRun(n);
+    int minGallop = POWERSORT_MIN_GALLOP;
+    int* data = arr.data();
+
+    Run a = { 0, DetectRun(data, n, 0, minRun, comparisons, bytesMoved), 0 };
+    while (a.start + a.length < n) {
+        int startB = a.start + a.length;
+        Run b = { startB, DetectRun(data, n, startB, minRun, comparisons, bytesMoved), 0 };
+        int power = NodePower(n, a.start, b.start, b.start + b.length);
+        while (!stack.empty() && stack.back().power > power) {
+            Run top = stack.back();
+            stack.pop_back();
+            MergeRunsGalloping(data, top.start, a.start, a.start + a.length, tmp, minGallop, comparisons, bytesMoved);
+            a = { top.start, top.length + a.length, 0 };
+        }
+        a.power = power;
+        stack.push_back(a);
+        a = b;
+    }
+    while (!stack.empty()) {
+        Run top = stack.back();
+        stack.pop_back();
+        MergeRunsGalloping(data, top.start, a.start, a.start + a.length, tmp, minGallop, comparisons, bytesMoved);
+        a = { top.start, top.length + a.length, 0 };
+    }
+}
+
+// One step is one of: detect a run, merge the top of the stack into the active run,
+// or push the active run. activeRun = run A (length 0 before the first run is found),
+// pendingRun = run B waiting for the stack to settle (length 0 if none).
+// Run detection reads the run; reversing or extending it with insertion sort also writes it
+static void TraceDetectedRun(VisualizationState& state, int start, int length, long long bytesBefore) {
+    TraceRange(state, MEM_REGION_ARRAY, start, start + length, false);
+    if (state.bytesMoved != bytesBefore) TraceRange(state, MEM_REGION_ARRAY, start, start + length, true);
+}
+
+bool StepPowersort(VisualizationState& state) {
+    int n = state.size;
+    int* data = state.array.data();
+    VisualizationState::SortedRun& a = state.activeRun;
+    VisualizationState::SortedRun& b = state.pendingRun;
+
+    if (a.length == 0) { // First run
+        long long bytesBefore = state.bytesMoved;
+        a.start = 0;
+        a.length = (n > 0) ? DetectRun(data, n, 0, state.minRun, &state.comparisons, &state.bytesMoved) : 0;
+        TraceDetectedRun(state, a.start, a.length, bytesBefore);
+        state.highlightStart = a.start;
+        state.highlightEnd = a.start + a.length - 1;
+        if (n > 0) return true;
+    }
+
+    int endA = a.start + a.length;
+    bool moreRuns = endA < n;
+
+    if (moreRuns && b.length == 0) { // Detect run B and its boundary power
+        long long bytesBefore = state.bytesMoved;
+        b.start = endA;
+        b.length = DetectRun(data, n, b.start, state.minRun, &state.comparisons, &state.bytesMoved);
+        TraceDetectedRun(state, b.start, b.length, bytesBefore);
+        b.power = NodePower(n, a.start, b.start, b.start + b.length);
+        state.highlightStart = b.start;
+        state.highlightEnd = b.start + b.length - 1;
+        return true;
+    }
+
+    // Merge while the stack top has a higher power than the new boundary (or finally, all of it)
+    if (!state.runStack.empty() && (!moreRuns || state.runStack.back().power > b.power)) {
+        VisualizationState::SortedRun top = state.runStack.back();
+        state.runStack.pop_back();
+        // The left run goes through the merge buffer, minus the prefix that is already in
+        // place (elements <= the right run's first); the whole range is read and rewritten
+        int buffered = (int)(data + a.start - std::upper_bound(data + top.start, data + a.start, data[a.start]));
+        MergeRunsGalloping(data, top.start, a.start, endA, state.scratchBuffer, state.minGallop,
+                           &state.comparisons, &state.bytesMoved);
+        TraceRange(state, MEM_REGION_AUX, 0, buffered, true);
+        TraceRange(state, MEM_REGION_ARRAY, top.start, endA, false);
+        TraceRange(state, MEM_REGION_AUX, 0, buffered, false);
+        TraceRange(state, MEM_REGION_ARRAY, top.start, endA, true);
+        a.start = top.start;
+        a.length += top.length;
+        state.highlightStart = a.start;
+        state.highlightEnd = a.start + a.length - 1;
+        return true;
+    }
+
+    if (moreRuns) { // Stack is settled: push A, B becomes the active run
+        a.power = b.power;
+        state.runStack.push_back(a);
+        a = b;
+        b.length = 0;
+        state.highlightStart = a.start;
+        state.highlightEnd = a.start + a.length - 1;
+        return true;
+    }
+
+    state.status = VIZ_STATE_FINISHED;
+    state.highlightStart = -1;
+    state.highlightEnd = -1;
+    return false; // Sort finished
+}
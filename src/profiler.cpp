@@ -0,0 +1,241 @@
+#include "profiler.h"
+#include "simd_support.h" // For ALGOWIZZ_X86
+#include <algorithm> // For std::min
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+#if ALGOWIZZ_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
+#define PROFILER_FRAME_HISTORY 1024
+
+// One buffer per thread. Only the owning thread writes events; `head` is published
+// with release ordering after each write, so readers copy [head - N, head) and then
+// drop whatever the writer may have overwritten meanwhile. Buffers are never freed:
+// a thread that exits hands its slot to the next new thread, and its old events stay
+// readable until they are overwritten.
+struct ThreadBuffer {
+    std::atomic<uint64_t> head;
+    std::atomic<bool> inUse;
+    int slot;  // Index in threadBuffers, used as the trace thread id
+    int depth;
+    ProfileEvent events[PROFILER_EVENTS_PER_THREAD];
+};
+
+static std::atomic<bool> profilerEnabled(false);
+static std::atomic<ThreadBuffer*> threadBuffers[PROFILER_MAX_THREADS];
+static std::atomic<int> threadBufferCount(0);
+
+// Frame marks, written by the drawing thread only
+static uint64_t frameMarks[PROFILER_FRAME_HISTORY];
+static std::atomic<uint64_t> frameMarkCount(0);
+static std::atomic<int> frameThreadSlot(-1);
+
+// Releases the slot when the owning thread exits
+struct ThreadBufferOwner {
+    ThreadBuffer* buffer = nullptr;
+    ~ThreadBufferOwner() {
+        if (buffer) buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+static thread_local ThreadBufferOwner localBuffer;
+
+static ThreadBuffer* AcquireThreadBuffer(void) {
+    // Reuse a slot released by an exited thread first
+    int count = threadBufferCount.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        ThreadBuffer* candidate = threadBuffers[i].load(std::memory_order_acquire);
+        bool expected = false;
+        if (candidate && candidate->inUse.compare_exchange_strong(expected, true)) {
+            candidate->depth = 0;
+            return candidate;
+        }
+    }
+
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->head.store(0);
+    buffer->inUse.store(true);
+    buffer->depth = 0;
+
+    for (int slot = 0; slot < PROFILER_MAX_THREADS; slot++) {
+        ThreadBuffer* empty = nullptr;
+        buffer->slot = slot;
+        if (threadBuffers[slot].compare_exchange_strong(empty, buffer, std::memory_order_acq_rel)) {
+            // Slots fill in order, so the count only ever covers published buffers
+            threadBufferCount.fetch_add(1, std::memory_order_release);
+            return buffer;
+        }
+    }
+    delete buffer; // Too many threads: this one is not profiled
+    return nullptr;
+}
+
+static ThreadBuffer* GetThreadBuffer(void) {
+    if (!localBuffer.buffer) localBuffer.buffer = AcquireThreadBuffer();
+    return localBuffer.buffer;
+}
+
+void SetProfilerEnabled(bool enabled) {
+    profilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsProfilerEnabled(void) {
+    return profilerEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t ProfilerNow(void) {
+#if ALGOWIZZ_X86
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Timestamp counter frequency, measured once by spinning against steady_clock
+static double MeasureTicksPerMs(void) {
+#if ALGOWIZZ_X86
+    auto start = std::chrono::steady_clock::now();
+    uint64_t startTicks = __rdtsc();
+    std::chrono::duration<double, std::milli> elapsed;
+    do {
+        elapsed = std::chrono::steady_clock::now() - start;
+    } while (elapsed.count() < 20.0);
+    return (double)(__rdtsc() - startTicks) / elapsed.count();
+#else
+    return 1e6; // Nanoseconds
+#endif
+}
+
+double ProfilerTicksToMs(uint64_t ticks) {
+    static const double ticksPerMs = MeasureTicksPerMs();
+    return (double)ticks / ticksPerMs;
+}
+
+ProfileZone::ProfileZone(const char* zoneName) : name(zoneName), begin(0) {
+    if (!profilerEnabled.load(std::memory_order_relaxed)) return;
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (!buffer || buffer->depth >= PROFILER_MAX_DEPTH) return;
+    buffer->depth++;
+    begin = ProfilerNow();
+}
+
+ProfileZone::~ProfileZone() {
+    if (begin == 0) return;
+    uint64_t end = ProfilerNow();
+    ThreadBuffer* buffer = localBuffer.buffer;
+    buffer->depth--;
+
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    ProfileEvent& event = buffer->events[head & (PROFILER_EVENTS_PER_THREAD - 1)];
+    event.name = name;
+    event.begin = begin;
+    event.end = end;
+    event.depth = buffer->depth;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void ProfilerMarkFrame(void) {
+    if (!profilerEnabled.load(std::memory_order_relaxed)) return;
+    ThreadBuffer* buffer = GetThreadBuffer();
+    if (buffer) frameThreadSlot.store(buffer->slot, std::memory_order_relaxed);
+    uint64_t count = frameMarkCount.load(std::memory_order_relaxed);
+    frameMarks[count % PROFILER_FRAME_HISTORY] = ProfilerNow();
+    frameMarkCount.store(count + 1, std::memory_order_release);
+}
+
+// Copy the events still held by one buffer, oldest first
+static void SnapshotBuffer(const ThreadBuffer* buffer, std::vector<ProfileEvent>& out) {
+    uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t first = (head > PROFILER_EVENTS_PER_THREAD) ? head - PROFILER_EVENTS_PER_THREAD : 0;
+    size_t base = out.size();
+    for (uint64_t i = first; i < head; i++) out.push_back(buffer->events[i & (PROFILER_EVENTS_PER_THREAD - 1)]);
+
+    // Entries the writer lapped while we were copying are unreliable
+    uint64_t newHead = buffer->head.load(std::memory_order_acquire);
+    uint64_t safeFirst = (newHead > PROFILER_EVENTS_PER_THREAD) ? newHead - PROFILER_EVENTS_PER_THREAD : 0;
+    if (safeFirst > first) {
+        size_t drop = (size_t)std::min<uint64_t>(safeFirst - first, head - first);
+        out.erase(out.begin() + base, out.begin() + base + drop);
+    }
+}
+
+bool GetLastFrameZones(std::vector<ProfileEvent>& events, uint64_t& frameBegin, uint64_t& frameEnd) {
+    events.clear();
+    uint64_t count = frameMarkCount.load(std::memory_order_acquire);
+    if (count < 2 || !localBuffer.buffer) return false;
+    frameBegin = frameMarks[(count - 2) % PROFILER_FRAME_HISTORY];
+    frameEnd = frameMarks[(count - 1) % PROFILER_FRAME_HISTORY];
+
+    // Own buffer, so no concurrent writer. Events are stored in end order: walk back
+    // from the newest until zones end before the frame started.
+    const ThreadBuffer* buffer = localBuffer.buffer;
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    uint64_t first = (head > PROFILER_EVENTS_PER_THREAD) ? head - PROFILER_EVENTS_PER_THREAD : 0;
+    for (uint64_t i = head; i > first; i--) {
+        const ProfileEvent& event = buffer->events[(i - 1) & (PROFILER_EVENTS_PER_THREAD - 1)];
+        if (event.end < frameBegin) break;
+        if (event.begin >= frameBegin && event.end <= frameEnd) events.push_back(event);
+    }
+    return true;
+}
+
+// Names are string literals from this codebase, but keep the JSON valid regardless
+static void WriteJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+int ExportChromeTrace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) return -1;
+
+    // Timestamps are relative to the oldest frame mark still held (or the first event)
+    uint64_t markCount = frameMarkCount.load(std::memory_order_acquire);
+    uint64_t firstMark = (markCount > PROFILER_FRAME_HISTORY) ? markCount - PROFILER_FRAME_HISTORY : 0;
+
+    std::vector<std::vector<ProfileEvent>> perThread(threadBufferCount.load(std::memory_order_acquire));
+    uint64_t origin = UINT64_MAX;
+    for (size_t t = 0; t < perThread.size(); t++) {
+        SnapshotBuffer(threadBuffers[t].load(std::memory_order_acquire), perThread[t]);
+        for (const ProfileEvent& event : perThread[t]) origin = std::min(origin, event.begin);
+    }
+    for (uint64_t m = firstMark; m < markCount; m++) origin = std::min(origin, frameMarks[m % PROFILER_FRAME_HISTORY]);
+    if (origin == UINT64_MAX) origin = 0;
+
+    int mainSlot = frameThreadSlot.load(std::memory_order_relaxed);
+    int written = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t t = 0; t < perThread.size(); t++) {
+        fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                written ? ",\n" : "", (int)t, (int)t == mainSlot ? "Main" : "Thread", (int)t);
+        written++;
+        for (const ProfileEvent& event : perThread[t]) {
+            fprintf(file, ",\n{\"ph\":\"X\",\"name\":");
+            WriteJsonString(file, event.name);
+            fprintf(file, ",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", (int)t,
+                    ProfilerTicksToMs(event.begin - origin) * 1000.0, ProfilerTicksToMs(event.end - event.begin) * 1000.0);
+            written++;
+        }
+    }
+    for (uint64_t m = firstMark; m < markCount; m++) {
+        fprintf(file, "%s{\"ph\":\"i\",\"s\":\"g\",\"name\":\"Frame\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", written ? ",\n" : "",
+                mainSlot < 0 ? 0 : mainSlot, ProfilerTicksToMs(frameMarks[m % PROFILER_FRAME_HISTORY] - origin) * 1000.0);
+        written++;
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = (ferror(file) == 0);
+    fclose(file);
+    return ok ? written : -1;
+}
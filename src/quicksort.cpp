@@ -1,23 +1,275 @@
 #include "quicksort.h"
+#include "simd_support.h"
+#include "sortingnetwork.h"
 #include <vector>
 #include <algorithm> // For std::swap
 
-// Internal Partition Logic (modifies state indices)
-int partition(VisualizationState& state, int low, int high) {
-    int pivotValue = state.array[high];
+// --- Partition kernels ---
+
+int PartitionScalar(int* arr, int low, int high) {
+    int pivotValue = arr[high];
     int i = (low - 1); // Index of smaller element
 
+    for (int j = low; j <= high - 1; j++) {
+        if (arr[j] < pivotValue) {
+            i++;
+            std::swap(arr[i], arr[j]);
+        }
+    }
+    std::swap(arr[i + 1], arr[high]);
+    return (i + 1);
+}
+
+int PartitionBranchless(int* arr, int low, int high) {
+    int pivotValue = arr[high];
+    int i = low; // First element not known to be smaller than the pivot
+
+    // Always swap arr[i] and arr[j]; i only advances when the element was smaller.
+    // Everything in [i, j) is >= pivot, so the swap is harmless when it doesn't advance.
+    for (int j = low; j < high; j++) {
+        int value = arr[j];
+        arr[j] = arr[i];
+        arr[i] = value;
+        i += (value < pivotValue);
+    }
+    std::swap(arr[i], arr[high]);
+    return i;
+}
+
+#if ALGOWIZZ_X86
+// For each 8-bit mask, the lane indices of the set bits followed by the clear bits.
+// Permuting a vector by entry [mask] packs the selected lanes to the front.
+struct CompressTable {
+    alignas(32) int lanes[256][8];
+    int counts[256];
+
+    CompressTable() {
+        for (int mask = 0; mask < 256; mask++) {
+            int out = 0;
+            for (int lane = 0; lane < 8; lane++) {
+                if (mask & (1 << lane)) lanes[mask][out++] = lane;
+            }
+            counts[mask] = out;
+            for (int lane = 0; lane < 8; lane++) {
+                if (!(mask & (1 << lane))) lanes[mask][out++] = lane;
+            }
+        }
+    }
+};
+
+static const CompressTable& GetCompressTable(void) {
+    static const CompressTable table;
+    return table;
+}
+
+ALGOWIZZ_TARGET_AVX2
+static int PartitionAVX2Impl(int* arr, int low, int high, int* scratch) {
+    const CompressTable& table = GetCompressTable();
+    int pivotValue = arr[high];
+    int count = high - low;
+
+    // Full 8-lane stores may run up to 7 ints past the last valid element, hence the padding
+    int* smaller = scratch;
+    int* larger = scratch + count + 8;
+    int numSmaller = 0;
+    int numLarger = 0;
+
+    __m256i pivot = _mm256_set1_epi32(pivotValue);
+    int j = low;
+    for (; j + 8 <= high; j += 8) {
+        __m256i values = _mm256_loadu_si256((const __m256i*)(arr + j));
+        __m256i isSmaller = _mm256_cmpgt_epi32(pivot, values);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(isSmaller));
+        int inverse = ~mask & 0xFF;
+
+        __m256i packSmaller = _mm256_load_si256((const __m256i*)table.lanes[mask]);
+        __m256i packLarger = _mm256_load_si256((const __m256i*)table.lanes[inverse]);
+        _mm256_storeu_si256((__m256i*)(smaller + numSmaller), _mm256_permutevar8x32_epi32(values, packSmaller));
+        _mm256_storeu_si256((__m256i*)(larger + numLarger), _mm256_permutevar8x32_epi32(values, packLarger));
+        numSmaller += table.counts[mask];
+        numLarger += table.counts[inverse];
+    }
+    for (; j < high; j++) {
+        int value = arr[j];
+        if (value < pivotValue) smaller[numSmaller++] = value;
+        else larger[numLarger++] = value;
+    }
+
+    std::copy(smaller, smaller + numSmaller, arr + low);
+    int pivotIndex = low + numSmaller;
+    arr[pivotIndex] = pivotValue;
+    std::copy(larger, larger + numLarger, arr + pivotIndex + 1);
+    return pivotIndex;
+}
+#endif
+
+int PartitionAVX2(int* arr, int low, int high, int* scratch) {
+#if ALGOWIZZ_X86
+    return PartitionAVX2Impl(arr, low, high, scratch);
+#else
+    (void)scratch;
+    return PartitionBranchless(arr, low, high);
+#endif
+}
+
+PartitionKernel ResolvePartitionKernel(PartitionKernel requested) {
+    if (requested == PARTITION_AVX2 && !CpuSupportsAVX2()) {
+        return PARTITION_BRANCHLESS;
+    }
+    return requested;
+}
+
+const char* GetPartitionKernelName(PartitionKernel kernel) {
+    switch (kernel) {
+        case PARTITION_SCALAR: return "Scalar";
+        case PARTITION_BRANCHLESS: return "Branchless";
+        case PARTITION_AVX2: return "AVX2";
+        default: return "Unknown";
+    }
+}
+
+int PartitionWithKernel(int* arr, int low, int high, PartitionKernel kernel, std::vector<int>& scratch) {
+    switch (ResolvePartitionKernel(kernel)) {
+        case PARTITION_BRANCHLESS:
+            return PartitionBranchless(arr, low, high);
+        case PARTITION_AVX2: {
+            size_t needed = 2 * (size_t)(high - low + 8);
+            if (scratch.size() < needed) scratch.resize(needed);
+            return PartitionAVX2(arr, low, high, scratch.data());
+        }
+        case PARTITION_SCALAR:
+        default:
+            return PartitionScalar(arr, low, high);
+    }
+}
+
+// floor(log2(n)) + 1 frames: the pending ranges when the smaller side goes first
+int QuickSortStackCapacity(int n) {
+    int capacity = 1;
+    while (n > 1) {
+        n >>= 1;
+        capacity++;
+    }
+    return capacity;
+}
+
+// Median of arr[low], arr[mid] and arr[high] moved to arr[high], where the kernels take the pivot
+static void MoveMedianOfThreeToEnd(int* arr, int low, int high) {
+    int mid = low + (high - low) / 2;
+    int a = arr[low];
+    int b = arr[mid];
+    int c = arr[high];
+    int median = std::max(std::min(a, b), std::min(std::max(a, b), c));
+    if (median == a) std::swap(arr[low], arr[high]);
+    else if (median == b) std::swap(arr[mid], arr[high]);
+}
+
+// Moves the elements equal to `pivotValue` (the minimum of the range) to its front and
+// returns the first index after them
+static int PartitionEqual(int* arr, int low, int high, int pivotValue) {
+    int i = low;
+    for (int j = low; j <= high; j++) {
+        int value = arr[j];
+        arr[j] = arr[i];
+        arr[i] = value;
+        i += (value == pivotValue);
+    }
+    return i;
+}
+
+// Full-speed quicksort with an explicit stack. Partitions are drawn from the same
+// kernels as the visualized engine, so the two always agree on the result.
+// Ranges of up to NETWORK_BASE_CASE_MAX elements are finished with a sorting network.
+void QuickSortFull(std::vector<int>& arr, PartitionKernel kernel) {
+    if (arr.size() < 2) return;
+
+    // Deferring the larger side keeps at most log2(n) frames pending; 64 covers any int size
+    std::vector<int> scratch;
+    std::pair<int, int> stack[64];
+    int depth = 0;
+    int low = 0;
+    int high = (int)arr.size() - 1;
+
+    for (;;) {
+        if (high - low + 1 <= NETWORK_BASE_CASE_MAX) {
+            if (low < high) SortSmallWithNetwork(arr.data() + low, high - low + 1);
+            if (depth == 0) break;
+            depth--;
+            low = stack[depth].first;
+            high = stack[depth].second;
+            continue;
+        }
+
+        MoveMedianOfThreeToEnd(arr.data(), low, high);
+        // The element before a range is a former pivot, <= everything in it. A pivot equal
+        // to it is the range's minimum: set its copies aside in one pass instead of
+        // peeling them off one partition at a time (the kernels put equal keys right).
+        if (low > 0 && arr[low - 1] == arr[high]) {
+            low = PartitionEqual(arr.data(), low, high, arr[high]);
+            continue;
+        }
+
+        int pi = PartitionWithKernel(arr.data(), low, high, kernel, scratch);
+        // Loop on the smaller side, defer the larger one
+        if (pi - low < high - pi) {
+            stack[depth++] = { pi + 1, high };
+            high = pi - 1;
+        } else {
+            stack[depth++] = { low, pi - 1 };
+            low = pi + 1;
+        }
+    }
+}
+
+// Internal Partition Logic (modifies state indices)
+int partition(VisualizationState& state, int low, int high) {
     state.tertiaryIndex = high; // Highlight pivot
     state.highlightStart = low;
     state.highlightEnd = high;
+    state.comparisons += high - low;
+
+    if (ResolvePartitionKernel(state.partitionKernel) != PARTITION_SCALAR) {
+        // The vectorized and branchless kernels have no per-element state to show,
+        // so only the resulting pivot position is highlighted
+        int pi = PartitionWithKernel(state.array.data(), low, high, state.partitionKernel, state.scratchBuffer);
+        // One streaming read and write of the range; AVX2 also streams through scratch
+        TraceRange(state, MEM_REGION_ARRAY, low, high + 1, false);
+        if (ResolvePartitionKernel(state.partitionKernel) == PARTITION_AVX2) {
+            TraceRange(state, MEM_REGION_AUX, 0, high - low + 1, true);
+            TraceRange(state, MEM_REGION_AUX, 0, high - low + 1, false);
+        }
+        TraceRange(state, MEM_REGION_ARRAY, low, high + 1, true);
+        long long span = high - low + 1;
+        if (ResolvePartitionKernel(state.partitionKernel) == PARTITION_AVX2) {
+            // No swaps: every element goes out to scratch and the range is copied back
+            state.bytesMoved += (2 * span - 1) * (long long)sizeof(int);
+        } else {
+            // Branchless swaps unconditionally: once per element, then the pivot
+            state.swaps += span;
+            state.bytesMoved += 2 * span * (long long)sizeof(int);
+        }
+        state.primaryIndex = pi;
+        state.secondaryIndex = high;
+        return pi;
+    }
+
+    int pivotValue = state.array[high];
+    TraceRead(state, high);
+    int i = (low - 1); // Index of smaller element
 
     for (int j = low; j <= high - 1; j++) {
         state.primaryIndex = i; // Highlight i
         state.secondaryIndex = j; // Highlight j (comparison pointer)
 
+        TraceRead(state, j);
         if (state.array[j] < pivotValue) {
             i++;
             std::swap(state.array[i], state.array[j]);
+            TraceRead(state, i);
+            TraceWrite(state, i);
+            TraceWrite(state, j);
+            state.swaps++;
+            state.bytesMoved += 2 * sizeof(int);
             // Update state immediately after swap for visualization
             state.primaryIndex = i; // Show updated i
             // Optional: Add a micro-pause or flag here if needed for slow-mo swap viz
@@ -26,13 +278,40 @@ int partition(VisualizationState& state, int low, int high) {
         // For this simplified version, we complete the partition in one "step" phase
     }
     std::swap(state.array[i + 1], state.array[high]);
+    TraceWrite(state, i + 1);
+    TraceWrite(state, high);
+    state.bytesMoved += 2 * sizeof(int);
     return (i + 1);
 }
 
 
-// Step function for Quicksort using an explicit stack
+void PrepareQuickSort(VisualizationState& state) {
+    int capacity = QuickSortStackCapacity(state.size);
+    if ((int)state.quickSortArena.size() < capacity) state.quickSortArena.resize(capacity);
+    // The AVX2 kernel can be picked mid-run, so its scratch is sized for the whole array up front
+    size_t scratchNeeded = 2 * (size_t)(state.size + 8);
+    if (state.scratchBuffer.size() < scratchNeeded) state.scratchBuffer.resize(scratchNeeded);
+
+    state.quickSortCurrent = { 0, state.size - 1, 0, -1 };
+    state.quickSortDepth = 0;
+    state.quickSortMaxDepth = 0;
+}
+
+// Continue with the most recently deferred range, or finish
+static void PopQuickSortFrame(VisualizationState& state) {
+    if (state.quickSortDepth > 0) {
+        state.quickSortCurrent = state.quickSortArena[--state.quickSortDepth];
+        state.quickSortCurrent.stage = 0;
+    } else {
+        state.quickSortCurrent.stage = -1;
+    }
+}
+
+// Step function for Quicksort: one partition per step, then one step to split.
+// quickSortCurrent = range being worked on, quickSortArena = deferred larger sides
 bool StepQuickSort(VisualizationState& state) {
-    if (state.quickSortStack.empty()) {
+    VisualizationState::QuickSortStackFrame& current = state.quickSortCurrent;
+    if (current.stage < 0) {
         state.status = VIZ_STATE_FINISHED;
         state.primaryIndex = -1;
         state.secondaryIndex = -1;
@@ -42,64 +321,48 @@ bool StepQuickSort(VisualizationState& state) {
         return false; // Sorting finished
     }
 
-    // Get current task from stack
-    VisualizationState::QuickSortStackFrame currentFrame = state.quickSortStack.back();
-    // Don't pop yet, might need to update stage
-
-    int low = currentFrame.low;
-    int high = currentFrame.high;
+    int low = current.low;
+    int high = current.high;
+    state.highlightStart = low;
+    state.highlightEnd = high;
 
-    if (low < high) {
-        if (currentFrame.stage == 0) { // Initial call for this range
-             state.quickSortStack.back().stage = 1; // Move to partitioning stage
-            // Partitioning logic happens here conceptually.
-            // We'll call our internal partition function which runs to completion
-            // for this simplified step model.
-            state.quickSortStack.back().partitionIndex = partition(state, low, high);
-            state.quickSortStack.back().stage = 2; // Move to stage after partition
-            return true; // Step completed (partition)
+    if (current.stage == 0) {
+        if (low >= high) { // Nothing to sort in this range
+            PopQuickSortFrame(state);
+            return true;
         }
-        else if (currentFrame.stage == 2) { // After partition, push left sub-problem
-             state.quickSortStack.back().stage = 3; // Mark current frame ready for right call later
-            int pi = currentFrame.partitionIndex;
-            if (low < pi - 1) {
-                state.quickSortStack.push_back({low, pi - 1, 0, -1}); // Push left task
-            }
-             return true; // Step completed (pushed left task or skipped)
+        if (state.useNetworkBaseCase && high - low + 1 <= NETWORK_BASE_CASE_MAX) {
+            // Small range: sort it with a network in one step instead of recursing
+            SortSmallWithNetwork(state.array.data() + low, high - low + 1);
+            TraceRange(state, MEM_REGION_ARRAY, low, high + 1, false);
+            TraceRange(state, MEM_REGION_ARRAY, low, high + 1, true);
+            state.tertiaryIndex = -1;
+            PopQuickSortFrame(state);
+            return true;
         }
-         else if (currentFrame.stage == 3) { // After left sub-problem is handled (implicitly by stack), push right
-             state.quickSortStack.back().stage = 4; // Mark current frame fully processed
-             int pi = currentFrame.partitionIndex;
-             if (pi + 1 < high) {
-                 state.quickSortStack.push_back({pi + 1, high, 0, -1}); // Push right task
-             }
-             // Since stage is now 4, this frame will be popped next iteration if stack not empty
-              return true; // Step completed (pushed right task or skipped)
-         } else if (currentFrame.stage == 4) { // Frame done, pop it
-             state.quickSortStack.pop_back();
-             // Reset highlights from this frame if needed
-             if (!state.quickSortStack.empty()) {
-                 // Optionally set highlights based on the new top frame
-                 state.highlightStart = state.quickSortStack.back().low;
-                 state.highlightEnd = state.quickSortStack.back().high;
-             } else {
-                 state.highlightStart = -1;
-                 state.highlightEnd = -1;
-             }
-             return true; // Step completed (popped frame)
-         }
+        current.partitionIndex = partition(state, low, high);
+        current.stage = 1;
+        return true; // Step completed (partition)
+    }
 
+    // Split: keep going with the smaller side, defer the larger one to the arena
+    int pi = current.partitionIndex;
+    bool leftLive = low < pi - 1;
+    bool rightLive = pi + 1 < high;
+    if (leftLive && rightLive) {
+        bool leftSmaller = (pi - low) < (high - pi);
+        VisualizationState::QuickSortStackFrame larger = leftSmaller ? VisualizationState::QuickSortStackFrame{ pi + 1, high, 0, -1 }
+                                                                     : VisualizationState::QuickSortStackFrame{ low, pi - 1, 0, -1 };
+        state.quickSortArena[state.quickSortDepth++] = larger;
+        state.quickSortMaxDepth = std::max(state.quickSortMaxDepth, state.quickSortDepth);
+        current = leftSmaller ? VisualizationState::QuickSortStackFrame{ low, pi - 1, 0, -1 }
+                              : VisualizationState::QuickSortStackFrame{ pi + 1, high, 0, -1 };
+    } else if (leftLive) {
+        current = { low, pi - 1, 0, -1 };
+    } else if (rightLive) {
+        current = { pi + 1, high, 0, -1 };
     } else {
-        // low >= high, base case for this frame
-        state.quickSortStack.pop_back(); // Pop this frame
-         if (!state.quickSortStack.empty()) {
-             state.highlightStart = state.quickSortStack.back().low;
-             state.highlightEnd = state.quickSortStack.back().high;
-         } else {
-             state.highlightStart = -1;
-             state.highlightEnd = -1;
-         }
-        return true; // Step completed (popped base case frame)
-    }
-     return true; // Should have returned earlier
-}
\ No newline at end of file
+        PopQuickSortFrame(state);
+    }
+    return true;
+}
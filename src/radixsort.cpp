@@ -0,0 +1,121 @@
+#include "radixsort.h"
+#include <algorithm> // For std::min_element, std::max_element
+
+void RadixSortFull(std::vector<int>& arr, long long* bytesMoved) {
+    size_t n = arr.size();
+    if (n < 2) return;
+
+    int minValue = *std::min_element(arr.begin(), arr.end());
+    unsigned int maxKey = 0;
+    for (int value : arr) maxKey = std::max(maxKey, (unsigned int)value - (unsigned int)minValue);
+
+    std::vector<int> buffer(n);
+    int* src = arr.data();
+    int* dst = buffer.data();
+    long long moved = 0;
+
+    for (int shift = 0; shift < 32 && (maxKey >> shift) != 0; shift += 8) {
+        size_t counts[256] = {};
+        for (size_t i = 0; i < n; i++) counts[(((unsigned int)src[i] - (unsigned int)minValue) >> shift) & 0xFF]++;
+
+        // Every key has the same digit: this pass would be a plain copy
+        bool trivial = false;
+        for (size_t c : counts) if (c == n) trivial = true;
+        if (trivial) continue;
+
+        size_t offset = 0;
+        for (size_t& c : counts) {
+            size_t count = c;
+            c = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            unsigned int digit = (((unsigned int)src[i] - (unsigned int)minValue) >> shift) & 0xFF;
+            dst[counts[digit]++] = src[i];
+        }
+        moved += (long long)n * sizeof(int);
+        std::swap(src, dst);
+    }
+
+    if (src != arr.data()) {
+        std::copy(src, src + n, arr.data());
+        moved += (long long)n * sizeof(int);
+    }
+    if (bytesMoved) *bytesMoved += moved;
+}
+
+static int RadixDigit(const VisualizationState& state, int value) {
+    return (int)((((unsigned int)value - (unsigned int)state.countMin) >> state.radixShift) & ((1u << RADIX_VIZ_BITS) - 1));
+}
+
+// LSD radix sort with RADIX_VIZ_BITS-bit digits, one element scattered per step.
+// sortPhase 0: histogram + prefix sums for the current digit (one step),
+// 1: scatter element primaryIndex into scratchBuffer, 2: copy the buffer back (one step).
+// counts = next output slot per bucket, radixShift = current digit position
+bool StepRadixSort(VisualizationState& state) {
+    int n = state.size;
+
+    if (state.sortPhase == 0) {
+        if (state.radixShift == 0) {
+            if (n == 0) {
+                state.status = VIZ_STATE_FINISHED;
+                return false;
+            }
+            state.countMin = *std::min_element(state.array.begin(), state.array.end());
+            unsigned int maxKey = 0;
+            for (int value : state.array) maxKey = std::max(maxKey, (unsigned int)value - (unsigned int)state.countMin);
+            state.radixMaxKey = maxKey;
+        }
+        if (state.radixShift >= 32 || (state.radixMaxKey >> state.radixShift) == 0) {
+            state.status = VIZ_STATE_FINISHED;
+            state.primaryIndex = -1;
+            state.highlightStart = -1;
+            state.highlightEnd = -1;
+            return false; // All digits done
+        }
+
+        state.counts.assign(1 << RADIX_VIZ_BITS, 0);
+        for (int i = 0; i < n; i++) {
+            int digit = RadixDigit(state, state.array[i]);
+            state.counts[digit]++;
+            TraceRead(state, i);
+            TraceAccess(state, MEM_REGION_COUNTS, digit, true);
+        }
+        int offset = 0;
+        for (int& c : state.counts) {
+            int count = c;
+            c = offset;
+            offset += count;
+        }
+        state.scratchBuffer.assign(n, 0);
+        state.primaryIndex = 0;
+        state.sortPhase = 1;
+        return true;
+    }
+
+    if (state.sortPhase == 1) {
+        int value = state.array[state.primaryIndex];
+        int digit = RadixDigit(state, value);
+        int slot = state.counts[digit]++;
+        state.scratchBuffer[slot] = value;
+        TraceRead(state, state.primaryIndex);
+        TraceAccess(state, MEM_REGION_COUNTS, digit, true);
+        TraceAccess(state, MEM_REGION_AUX, slot, true);
+        state.bytesMoved += sizeof(int);
+        state.tertiaryIndex = state.primaryIndex;
+        state.primaryIndex++;
+        if (state.primaryIndex >= n) state.sortPhase = 2;
+        return true;
+    }
+
+    // Copy back and move to the next digit
+    std::copy(state.scratchBuffer.begin(), state.scratchBuffer.begin() + n, state.array.begin());
+    TraceRange(state, MEM_REGION_AUX, 0, n, false);
+    TraceRange(state, MEM_REGION_ARRAY, 0, n, true);
+    state.bytesMoved += (long long)n * sizeof(int);
+    state.radixShift += RADIX_VIZ_BITS;
+    state.sortPhase = 0;
+    state.tertiaryIndex = -1;
+    state.secondaryIndex = -1;
+    return true;
+}
@@ -0,0 +1,122 @@
+#include "resources.h"
+#include "embedded_resources.h" // Generated by build/premake5.lua
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#define RESOURCE_COUNT ((int)(sizeof(embeddedResources) / sizeof(embeddedResources[0])))
+#define STARTUP_MAX_PHASES 8
+
+typedef struct {
+    bool isImage;
+    Image image;       // Written by the worker, taken over by the main thread
+    Texture2D texture; // Main thread only
+} ResourceSlot;
+
+static ResourceSlot resourceSlots[RESOURCE_COUNT];
+static std::thread decodeThread;
+static std::atomic<int> decodedCount{ 0 }; // Slots [0, decodedCount) are decoded (release)
+static int uploadedCount = 0;
+
+const EmbeddedResource* FindEmbeddedResource(const char* name) {
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        if (strcmp(embeddedResources[i].name, name) == 0) return &embeddedResources[i];
+    }
+    return nullptr;
+}
+
+// Formats raylib decodes with its default build (stb_image, qoi)
+static bool IsImageType(const char* fileType) {
+    return strcmp(fileType, ".png") == 0 || strcmp(fileType, ".bmp") == 0 ||
+           strcmp(fileType, ".jpg") == 0 || strcmp(fileType, ".qoi") == 0;
+}
+
+// Worker: decode in table order, publishing each slot as soon as it is done
+static void DecodeResources(void) {
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        const EmbeddedResource& resource = embeddedResources[i];
+        if (resourceSlots[i].isImage) {
+            resourceSlots[i].image = LoadImageFromMemory(resource.fileType, resource.data, resource.size);
+        }
+        decodedCount.store(i + 1, std::memory_order_release);
+    }
+}
+
+void StartResourceLoading(void) {
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        resourceSlots[i].isImage = IsImageType(embeddedResources[i].fileType);
+        resourceSlots[i].image = {};
+        resourceSlots[i].texture = {};
+    }
+    decodedCount.store(0, std::memory_order_relaxed);
+    uploadedCount = 0;
+    decodeThread = std::thread(DecodeResources);
+}
+
+bool UploadLoadedResources(void) {
+    if (uploadedCount == RESOURCE_COUNT) return true;
+
+    int decoded = decodedCount.load(std::memory_order_acquire);
+    for (; uploadedCount < decoded; uploadedCount++) {
+        ResourceSlot& slot = resourceSlots[uploadedCount];
+        if (!slot.isImage) continue;
+        if (slot.image.data == nullptr) {
+            TraceLog(LOG_WARNING, "Could not decode embedded resource '%s'", embeddedResources[uploadedCount].name);
+            continue;
+        }
+        slot.texture = LoadTextureFromImage(slot.image);
+        UnloadImage(slot.image);
+        slot.image = {};
+    }
+    if (uploadedCount < RESOURCE_COUNT) return false;
+    decodeThread.join();
+    return true;
+}
+
+Texture2D GetResourceTexture(const char* name) {
+    const EmbeddedResource* resource = FindEmbeddedResource(name);
+    if (resource == nullptr) return Texture2D{};
+    return resourceSlots[resource - embeddedResources].texture;
+}
+
+void UnloadResources(void) {
+    if (decodeThread.joinable()) decodeThread.join();
+    for (int i = 0; i < RESOURCE_COUNT; i++) {
+        ResourceSlot& slot = resourceSlots[i];
+        if (slot.image.data != nullptr) UnloadImage(slot.image); // Decoded but never uploaded
+        if (slot.texture.id != 0) UnloadTexture(slot.texture);
+        slot.image = {};
+        slot.texture = {};
+    }
+    uploadedCount = RESOURCE_COUNT;
+}
+
+// --- Startup timing ---
+// Taken during static initialization, before main runs
+static const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+static const char* startupPhases[STARTUP_MAX_PHASES];
+static double startupMs[STARTUP_MAX_PHASES];
+static int startupPhaseCount = 0;
+static char startupReport[256] = "";
+
+void MarkStartupPhase(const char* phase) {
+    if (startupReport[0] != '\0' || startupPhaseCount == STARTUP_MAX_PHASES) return;
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - processStart;
+    startupPhases[startupPhaseCount] = phase;
+    startupMs[startupPhaseCount] = elapsed.count();
+    startupPhaseCount++;
+    if (strcmp(phase, "interactive") != 0) return;
+
+    int length = 0;
+    for (int i = 0; i < startupPhaseCount && length < (int)sizeof(startupReport); i++) {
+        length += snprintf(startupReport + length, sizeof(startupReport) - length, "%s%s %.1f ms",
+                           i > 0 ? ", " : "", startupPhases[i], startupMs[i]);
+    }
+    TraceLog(LOG_INFO, "STARTUP: %s", startupReport);
+}
+
+const char* GetStartupReport(void) {
+    return startupReport;
+}
@@ -0,0 +1,348 @@
+#include "searchlayout.h"
+#include "simd_support.h"
+#include "visualization_state.h"
+#include <algorithm>
+#include <climits>  // For INT_MAX
+#include <cstdint>  // For uintptr_t
+#include <cstdlib>  // For rand()
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // For _BitScanForward
+#endif
+
+const char* GetSearchLayoutName(SearchLayoutKind kind) {
+    switch (kind) {
+        case SEARCH_BINARY:     return "Binary";
+        case SEARCH_BRANCHLESS: return "Branchless";
+        case SEARCH_EYTZINGER:  return "Eytzinger";
+        case SEARCH_STREE:      return "S-tree";
+        default:                return "Unknown";
+    }
+}
+
+// Number of consecutive set bits starting at bit 0 (`bits` must not be all ones)
+static inline int TrailingOnes(unsigned int bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(~bits);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, ~bits);
+    return (int)index;
+#else
+    int count = 0;
+    while (bits & 1) {
+        bits >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+static int StreeChild(int node, int slot) {
+    return node * (STREE_NODE_KEYS + 1) + slot + 1;
+}
+
+// --- Building ---
+// Both trees are filled by an in-order walk, so their in-order sequence is the sorted array
+
+static void BuildEytzinger(SearchLayouts& layouts, const std::vector<int>& sorted, int& next, int k, bool withRanks) {
+    if (k > layouts.n) return;
+    BuildEytzinger(layouts, sorted, next, 2 * k, withRanks);
+    layouts.eytzingerStorage[layouts.eytzingerOffset + k] = sorted[next];
+    if (withRanks) layouts.eytzingerRank[k] = next;
+    next++;
+    BuildEytzinger(layouts, sorted, next, 2 * k + 1, withRanks);
+}
+
+static void BuildStree(SearchLayouts& layouts, const std::vector<int>& sorted, int& next, int node, bool withRanks) {
+    if (node >= layouts.streeNodes) return;
+    int* keys = layouts.streeStorage.data() + layouts.streeOffset + node * STREE_NODE_KEYS;
+    for (int slot = 0; slot < STREE_NODE_KEYS; slot++) {
+        BuildStree(layouts, sorted, next, StreeChild(node, slot), withRanks);
+        if (next < layouts.n) {
+            keys[slot] = sorted[next];
+            if (withRanks) layouts.streeRank[node * STREE_NODE_KEYS + slot] = next;
+            next++;
+        }
+    }
+    BuildStree(layouts, sorted, next, StreeChild(node, STREE_NODE_KEYS), withRanks);
+}
+
+void BuildSearchLayouts(SearchLayouts& layouts, const std::vector<int>& sorted, bool withRanks) {
+    int n = (int)sorted.size();
+    layouts.n = n;
+    layouts.sorted = sorted;
+
+    layouts.eytzingerStorage.assign((size_t)n + 1 + 16, 0);
+    uintptr_t address = (uintptr_t)layouts.eytzingerStorage.data();
+    layouts.eytzingerOffset = (int)(((64 - address % 64) % 64) / sizeof(int));
+    layouts.eytzingerRank.assign(withRanks ? n + 1 : 0, n);
+    int next = 0;
+    BuildEytzinger(layouts, sorted, next, 1, withRanks);
+
+    // Nodes start on a 64-byte boundary; one spare node lets a search read the slot
+    // after a full node without a bounds check
+    layouts.streeNodes = (n + STREE_NODE_KEYS - 1) / STREE_NODE_KEYS;
+    layouts.streeStorage.assign((size_t)(layouts.streeNodes + 2) * STREE_NODE_KEYS, INT_MAX);
+    address = (uintptr_t)layouts.streeStorage.data();
+    layouts.streeOffset = (int)(((64 - address % 64) % 64) / sizeof(int));
+    layouts.streeRank.assign(withRanks ? (size_t)(layouts.streeNodes + 1) * STREE_NODE_KEYS : 0, n);
+    next = 0;
+    BuildStree(layouts, sorted, next, 0, withRanks);
+}
+
+// --- Searches ---
+
+static void SearchBinary(const SearchLayouts& layouts, const int* queries, int count, int* results) {
+    const int* a = layouts.sorted.data();
+    int n = layouts.n;
+    for (int q = 0; q < count; q++) {
+        int low = 0;
+        int high = n;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (a[mid] < queries[q]) low = mid + 1;
+            else high = mid;
+        }
+        results[q] = low < n ? a[low] : INT_MAX;
+    }
+}
+
+// All queries of a batch have the same remaining length, so they advance level by level
+// together; the prefetch for a query's next probe is issued a whole batch ahead of it
+static void SearchBranchless(const SearchLayouts& layouts, bool prefetch, const int* queries, int count, int* results) {
+    const int* a = layouts.sorted.data();
+    int n = layouts.n;
+    if (n == 0) {
+        std::fill(results, results + count, INT_MAX);
+        return;
+    }
+    int batch = prefetch ? LOOKUP_BATCH : 1;
+    const int* base[LOOKUP_BATCH];
+    for (int start = 0; start < count; start += batch) {
+        int m = std::min(batch, count - start);
+        const int* x = queries + start;
+        for (int q = 0; q < m; q++) base[q] = a;
+        int length = n;
+        while (length > 1) {
+            int half = length / 2;
+            for (int q = 0; q < m; q++) {
+                base[q] = (base[q][half] < x[q]) ? base[q] + half : base[q];
+                if (prefetch) ALGOWIZZ_PREFETCH(base[q] + (length - half) / 2);
+            }
+            length -= half;
+        }
+        for (int q = 0; q < m; q++) {
+            int index = (int)(base[q] - a) + (*base[q] < x[q]);
+            results[start + q] = index < n ? a[index] : INT_MAX;
+        }
+    }
+}
+
+// The 16 descendants four levels down are contiguous and start on a line boundary (see
+// EytzingerSlots), so one prefetch covers them
+static void SearchEytzinger(const SearchLayouts& layouts, bool prefetch, const int* queries, int count, int* results) {
+    const int* e = EytzingerSlots(layouts);
+    int n = layouts.n;
+    for (int q = 0; q < count; q++) {
+        int x = queries[q];
+        unsigned int k = 1;
+        while ((int)k <= n) {
+            if (prefetch) ALGOWIZZ_PREFETCH(e + std::min(16 * (int)k, n));
+            k = 2 * k + (e[k] < x);
+        }
+        k >>= TrailingOnes(k) + 1; // Undo the right turns taken after the last left turn
+        results[q] = k ? e[k] : INT_MAX;
+    }
+}
+
+static int StreeRankScalar(const int* node, int x) {
+    int rank = 0;
+    for (int slot = 0; slot < STREE_NODE_KEYS; slot++) rank += node[slot] < x;
+    return rank;
+}
+
+static void SearchStreeScalar(const SearchLayouts& layouts, bool prefetch, const int* queries, int count, int* results) {
+    const int* nodes = StreeNodes(layouts);
+    int nodeCount = layouts.streeNodes;
+    int batch = prefetch ? LOOKUP_BATCH : 1;
+    int k[LOOKUP_BATCH];
+    int found[LOOKUP_BATCH];
+    for (int start = 0; start < count; start += batch) {
+        int m = std::min(batch, count - start);
+        const int* x = queries + start;
+        for (int q = 0; q < m; q++) {
+            k[q] = 0;
+            found[q] = INT_MAX;
+        }
+        for (bool active = true; active;) {
+            active = false;
+            for (int q = 0; q < m; q++) {
+                if (k[q] >= nodeCount) continue;
+                const int* node = nodes + k[q] * STREE_NODE_KEYS;
+                int rank = StreeRankScalar(node, x[q]);
+                found[q] = rank < STREE_NODE_KEYS ? node[rank] : found[q];
+                k[q] = StreeChild(k[q], rank);
+                if (prefetch && k[q] < nodeCount) ALGOWIZZ_PREFETCH(nodes + k[q] * STREE_NODE_KEYS);
+                active = true;
+            }
+        }
+        for (int q = 0; q < m; q++) results[start + q] = found[q];
+    }
+}
+
+#if ALGOWIZZ_X86
+// Same walk as SearchStreeScalar; a node is ranked with two 8-lane compares
+ALGOWIZZ_TARGET_AVX2
+static void SearchStreeAVX2(const SearchLayouts& layouts, bool prefetch, const int* queries, int count, int* results) {
+    const int* nodes = StreeNodes(layouts);
+    int nodeCount = layouts.streeNodes;
+    int batch = prefetch ? LOOKUP_BATCH : 1;
+    int k[LOOKUP_BATCH];
+    int found[LOOKUP_BATCH];
+    for (int start = 0; start < count; start += batch) {
+        int m = std::min(batch, count - start);
+        const int* x = queries + start;
+        for (int q = 0; q < m; q++) {
+            k[q] = 0;
+            found[q] = INT_MAX;
+        }
+        for (bool active = true; active;) {
+            active = false;
+            for (int q = 0; q < m; q++) {
+                if (k[q] >= nodeCount) continue;
+                const int* node = nodes + k[q] * STREE_NODE_KEYS;
+                __m256i key = _mm256_set1_epi32(x[q]);
+                __m256i low = _mm256_cmpgt_epi32(key, _mm256_load_si256((const __m256i*)node));
+                __m256i high = _mm256_cmpgt_epi32(key, _mm256_load_si256((const __m256i*)(node + 8)));
+                unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(low)) |
+                                    ((unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(high)) << 8);
+                int rank = TrailingOnes(mask); // Keys are sorted, so the smaller ones form a prefix
+                found[q] = rank < STREE_NODE_KEYS ? node[rank] : found[q];
+                k[q] = StreeChild(k[q], rank);
+                if (prefetch && k[q] < nodeCount) ALGOWIZZ_PREFETCH(nodes + k[q] * STREE_NODE_KEYS);
+                active = true;
+            }
+        }
+        for (int q = 0; q < m; q++) results[start + q] = found[q];
+    }
+}
+#endif
+
+void RunSearchQueries(const SearchLayouts& layouts, SearchLayoutKind kind, bool prefetch,
+                      const int* queries, int count, int* results) {
+    switch (kind) {
+        case SEARCH_BINARY:
+            SearchBinary(layouts, queries, count, results);
+            break;
+        case SEARCH_BRANCHLESS:
+            SearchBranchless(layouts, prefetch, queries, count, results);
+            break;
+        case SEARCH_EYTZINGER:
+            SearchEytzinger(layouts, prefetch, queries, count, results);
+            break;
+        case SEARCH_STREE:
+        default:
+#if ALGOWIZZ_X86
+            if (CpuSupportsAVX2()) {
+                SearchStreeAVX2(layouts, prefetch, queries, count, results);
+                break;
+            }
+#endif
+            SearchStreeScalar(layouts, prefetch, queries, count, results);
+            break;
+    }
+}
+
+int TraceSearch(const SearchLayouts& layouts, SearchLayoutKind kind, int query, std::vector<SearchProbe>& probes) {
+    probes.clear();
+    int n = layouts.n;
+    const int* a = layouts.sorted.data();
+    if (n == 0) return 0;
+
+    if (kind == SEARCH_BINARY) {
+        int low = 0;
+        int high = n;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            probes.push_back({ mid, mid });
+            if (a[mid] < query) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+    if (kind == SEARCH_BRANCHLESS) {
+        int base = 0;
+        int length = n;
+        while (length > 1) {
+            int half = length / 2;
+            probes.push_back({ base + half, base + half });
+            if (a[base + half] < query) base += half;
+            length -= half;
+        }
+        probes.push_back({ base, base });
+        return base + (a[base] < query);
+    }
+    if (kind == SEARCH_EYTZINGER) {
+        const int* e = EytzingerSlots(layouts);
+        unsigned int k = 1;
+        while ((int)k <= n) {
+            probes.push_back({ (int)k, layouts.eytzingerRank[k] });
+            k = 2 * k + (e[k] < query);
+        }
+        k >>= TrailingOnes(k) + 1;
+        return k ? layouts.eytzingerRank[k] : n;
+    }
+
+    const int* nodes = StreeNodes(layouts);
+    int result = n;
+    for (int k = 0; k < layouts.streeNodes;) {
+        const int* node = nodes + k * STREE_NODE_KEYS;
+        int rank = StreeRankScalar(node, query);
+        int slot = k * STREE_NODE_KEYS + std::min(rank, STREE_NODE_KEYS - 1);
+        probes.push_back({ k * STREE_NODE_KEYS, layouts.streeRank[slot] });
+        if (rank < STREE_NODE_KEYS) result = layouts.streeRank[k * STREE_NODE_KEYS + rank];
+        k = StreeChild(k, rank);
+    }
+    return result;
+}
+
+void StartLookup(VisualizationState& state) {
+    BuildSearchLayouts(state.searchLayouts, state.array, true);
+    state.lookupMode = true;
+    state.lookupCount = 0;
+    state.lookupProbes.clear();
+    state.benchmarkResults.clear(); // The sort's sweep would cover the lookup table
+    state.status = VIZ_STATE_PAUSED;
+    state.stepCount = 0;
+    state.comparisons = 0;
+    state.primaryIndex = -1;
+    state.secondaryIndex = -1;
+    state.tertiaryIndex = -1;
+    state.highlightStart = -1;
+    state.highlightEnd = -1;
+}
+
+// One traced query per step, drawn from slightly beyond the array's value range so
+// that misses at both ends show up too. primaryIndex = lower bound position.
+bool StepLookup(VisualizationState& state) {
+    if (state.lookupCount >= LOOKUP_VIZ_QUERIES || state.searchLayouts.n == 0) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.lookupProbes.clear();
+        return false;
+    }
+    const std::vector<int>& sorted = state.searchLayouts.sorted;
+    int low = sorted.front() - 2;
+    int high = sorted.back() + 2;
+    state.lookupQuery = low + rand() % (high - low + 1);
+    state.primaryIndex = TraceSearch(state.searchLayouts, state.lookupLayout, state.lookupQuery, state.lookupProbes);
+    state.comparisons += (long long)state.lookupProbes.size();
+    // The sorted layouts probe the bars themselves; the others probe their own copy
+    bool ownCopy = state.lookupLayout == SEARCH_EYTZINGER || state.lookupLayout == SEARCH_STREE;
+    for (const SearchProbe& probe : state.lookupProbes) {
+        if (ownCopy) TraceAccess(state, MEM_REGION_AUX, probe.memoryIndex, false);
+        else TraceRead(state, probe.sortedIndex);
+    }
+    state.lookupCount++;
+    return true;
+}
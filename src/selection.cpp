@@ -0,0 +1,330 @@
+#include "selection.h"
+#include <algorithm> // For std::swap, std::min, std::max
+#include <cmath>     // For the Floyd-Rivest sample bounds
+
+int SelectionRank(float fraction, int n) {
+    if (n <= 0) return 0;
+    int k = (int)(fraction * (float)(n - 1) + 0.5f);
+    return std::max(0, std::min(n - 1, k));
+}
+
+static int FloorLog2(int n) {
+    int log = 0;
+    while (n > 1) {
+        n >>= 1;
+        log++;
+    }
+    return log;
+}
+
+// --- Shared kernels ---
+
+// Dutch-flag partition of arr[low..high] around `pivot`: afterwards [low, lt) < pivot,
+// [lt, gt] == pivot and (gt, high] > pivot. Equal keys end up in the middle, so runs
+// of duplicates cannot make the window shrink one element at a time.
+static void PartitionThreeWay(int* arr, int low, int high, int pivot, int& lt, int& gt, long long* comparisons) {
+    int i = low;
+    lt = low;
+    gt = high;
+    long long compares = 0;
+    while (i <= gt) {
+        compares++;
+        if (arr[i] < pivot) {
+            std::swap(arr[lt++], arr[i++]);
+        } else if (arr[i] > pivot) {
+            compares++;
+            std::swap(arr[i], arr[gt--]);
+        } else {
+            compares++;
+            i++;
+        }
+    }
+    if (comparisons) *comparisons += compares;
+}
+
+static int MedianOfThree(const int* arr, int low, int high) {
+    int a = arr[low];
+    int b = arr[low + (high - low) / 2];
+    int c = arr[high];
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+static void SelectDeterministic(int* arr, int low, int high, int k, long long* comparisons);
+
+// Median of the medians of groups of five; the group medians are gathered at the front
+static int MedianOfMedians(int* arr, int low, int high, long long* comparisons) {
+    int groups = 0;
+    for (int g = low; g <= high; g += 5) {
+        int end = std::min(g + 4, high);
+        for (int i = g + 1; i <= end; i++) {
+            for (int j = i; j > g && arr[j - 1] > arr[j]; j--) std::swap(arr[j - 1], arr[j]);
+        }
+        if (comparisons) *comparisons += (end - g) * 2;
+        std::swap(arr[low + groups], arr[g + (end - g) / 2]);
+        groups++;
+    }
+    int mid = low + (groups - 1) / 2;
+    SelectDeterministic(arr, low, low + groups - 1, mid, comparisons);
+    return arr[mid];
+}
+
+static void SelectDeterministic(int* arr, int low, int high, int k, long long* comparisons) {
+    while (low < high) {
+        int lt, gt;
+        PartitionThreeWay(arr, low, high, MedianOfMedians(arr, low, high, comparisons), lt, gt, comparisons);
+        if (k < lt) high = lt - 1;
+        else if (k > gt) low = gt + 1;
+        else return;
+    }
+}
+
+// Floyd-Rivest bracketing partition around t = arr[k] (Hoare style). Returns j, the
+// final position of t; the caller keeps the side that still contains k.
+static int FloydRivestPartition(int* arr, int left, int right, int k, long long* comparisons) {
+    int t = arr[k];
+    int i = left;
+    int j = right;
+    long long compares = 1;
+    std::swap(arr[left], arr[k]);
+    if (arr[right] > t) std::swap(arr[right], arr[left]);
+    while (i < j) {
+        std::swap(arr[i], arr[j]);
+        i++;
+        j--;
+        while (compares++, arr[i] < t) i++;
+        while (compares++, arr[j] > t) j--;
+    }
+    if (arr[left] == t) {
+        std::swap(arr[left], arr[j]);
+    } else {
+        j++;
+        std::swap(arr[j], arr[right]);
+    }
+    if (comparisons) *comparisons += compares;
+    return j;
+}
+
+// Sub-range around k that the sample predicts holds rank k (Floyd & Rivest 1975)
+static void FloydRivestBounds(int left, int right, int k, int& newLeft, int& newRight) {
+    double n = right - left + 1;
+    double i = k - left + 1;
+    double z = std::log(n);
+    double s = 0.5 * std::exp(2.0 * z / 3.0);
+    double sd = 0.5 * std::sqrt(z * s * (n - s) / n) * (i - n / 2 < 0 ? -1.0 : 1.0);
+    newLeft = std::max(left, (int)(k - i * s / n + sd));
+    newRight = std::min(right, (int)(k + (n - i) * s / n + sd));
+}
+
+static void FloydRivestSelect(int* arr, int left, int right, int k, long long* comparisons) {
+    while (right > left) {
+        if (right - left > FLOYD_RIVEST_SAMPLE_CUTOFF) {
+            int newLeft, newRight;
+            FloydRivestBounds(left, right, k, newLeft, newRight);
+            FloydRivestSelect(arr, newLeft, newRight, k, comparisons);
+        }
+        int j = FloydRivestPartition(arr, left, right, k, comparisons);
+        if (j <= k) left = j + 1;
+        if (k <= j) right = j - 1;
+    }
+}
+
+// Max-heap sift-down over arr[0..heapSize)
+static void SiftDownMax(int* arr, int heapSize, int node, long long* comparisons) {
+    long long compares = 0;
+    int value = arr[node];
+    for (;;) {
+        int child = 2 * node + 1;
+        if (child >= heapSize) break;
+        compares++;
+        if (child + 1 < heapSize && arr[child + 1] > arr[child]) child++;
+        compares++;
+        if (arr[child] <= value) break;
+        arr[node] = arr[child];
+        node = child;
+    }
+    arr[node] = value;
+    if (comparisons) *comparisons += compares;
+}
+
+// --- Full-speed engines ---
+
+void QuickSelectFull(std::vector<int>& arr, int k, long long* comparisons) {
+    int n = (int)arr.size();
+    if (n < 2) return;
+    int* data = arr.data();
+    int low = 0;
+    int high = n - 1;
+    int roundsLeft = 2 * FloorLog2(n);
+    while (low < high) {
+        int pivot = (roundsLeft-- > 0) ? MedianOfThree(data, low, high) : MedianOfMedians(data, low, high, comparisons);
+        int lt, gt;
+        PartitionThreeWay(data, low, high, pivot, lt, gt, comparisons);
+        if (k < lt) high = lt - 1;
+        else if (k > gt) low = gt + 1;
+        else return;
+    }
+}
+
+void FloydRivestFull(std::vector<int>& arr, int k, long long* comparisons) {
+    if (arr.size() < 2) return;
+    FloydRivestSelect(arr.data(), 0, (int)arr.size() - 1, k, comparisons);
+}
+
+void HeapTopKFull(std::vector<int>& arr, int k, long long* comparisons) {
+    int n = (int)arr.size();
+    if (n < 2) return;
+    int* data = arr.data();
+    int heapSize = k + 1;
+    for (int node = heapSize / 2 - 1; node >= 0; node--) SiftDownMax(data, heapSize, node, comparisons);
+    for (int i = heapSize; i < n; i++) {
+        if (comparisons) (*comparisons)++;
+        if (data[i] < data[0]) {
+            std::swap(data[0], data[i]);
+            SiftDownMax(data, heapSize, 0, comparisons);
+        }
+    }
+    for (int end = heapSize - 1; end > 0; end--) {
+        std::swap(data[0], data[end]);
+        SiftDownMax(data, end, 0, comparisons);
+    }
+}
+
+// --- Step engines ---
+// All three highlight rank k with tertiaryIndex and the window still containing it
+// with highlightStart/End.
+
+static bool FinishSelection(VisualizationState& state) {
+    state.status = VIZ_STATE_FINISHED;
+    state.primaryIndex = -1;
+    state.secondaryIndex = -1;
+    state.highlightStart = -1;
+    state.highlightEnd = -1;
+    return false;
+}
+
+// One partition round per step. selectLow/High = window, selectRounds counts rounds
+// until introselect gives up on median-of-three
+bool StepQuickSelect(VisualizationState& state) {
+    int low = state.selectLow;
+    int high = state.selectHigh;
+    state.tertiaryIndex = state.selectRank;
+    if (low >= high) return FinishSelection(state);
+
+    int* data = state.array.data();
+    if (!state.selectFallback && state.selectRounds >= 2 * FloorLog2(state.size)) state.selectFallback = true;
+    int pivot = state.selectFallback ? MedianOfMedians(data, low, high, &state.comparisons) : MedianOfThree(data, low, high);
+
+    int lt, gt;
+    PartitionThreeWay(data, low, high, pivot, lt, gt, &state.comparisons);
+    TraceRange(state, MEM_REGION_ARRAY, low, high + 1, false);
+    TraceRange(state, MEM_REGION_ARRAY, low, high + 1, true);
+    state.selectRounds++;
+
+    // Show the band of keys equal to the pivot
+    state.primaryIndex = lt;
+    state.secondaryIndex = gt;
+    int k = state.selectRank;
+    if (k < lt) state.selectHigh = lt - 1;
+    else if (k > gt) state.selectLow = gt + 1;
+    else state.selectLow = state.selectHigh = k; // k landed among the pivot copies
+    state.highlightStart = state.selectLow;
+    state.highlightEnd = state.selectHigh;
+    return true;
+}
+
+// selectFrames emulates the recursion: a frame longer than the cutoff first pushes its
+// sampled sub-range (one step), then partitions around arr[k] once per step
+bool StepFloydRivest(VisualizationState& state) {
+    state.tertiaryIndex = state.selectRank;
+    if (state.selectFrames.empty()) return FinishSelection(state);
+
+    VisualizationState::SelectFrame& frame = state.selectFrames.back();
+    int k = state.selectRank;
+    if (frame.high <= frame.low) {
+        state.selectFrames.pop_back();
+        if (state.selectFrames.empty()) return FinishSelection(state);
+        state.highlightStart = state.selectFrames.back().low;
+        state.highlightEnd = state.selectFrames.back().high;
+        return true;
+    }
+
+    if (!frame.sampled && frame.high - frame.low > FLOYD_RIVEST_SAMPLE_CUTOFF) {
+        int newLeft, newRight;
+        FloydRivestBounds(frame.low, frame.high, k, newLeft, newRight);
+        frame.sampled = true;
+        state.selectFrames.push_back({ newLeft, newRight, false }); // frame is invalid from here
+        state.highlightStart = newLeft;
+        state.highlightEnd = newRight;
+        return true;
+    }
+
+    int j = FloydRivestPartition(state.array.data(), frame.low, frame.high, k, &state.comparisons);
+    TraceRange(state, MEM_REGION_ARRAY, frame.low, frame.high + 1, false);
+    TraceRange(state, MEM_REGION_ARRAY, frame.low, frame.high + 1, true);
+    state.primaryIndex = j;
+    if (j <= k) frame.low = j + 1;
+    if (k <= j) frame.high = j - 1;
+    frame.sampled = false;
+    state.highlightStart = frame.low;
+    state.highlightEnd = frame.high;
+    return true;
+}
+
+// sortPhase 0: heapify the first k + 1 elements, one sift per step (primaryIndex = node)
+// sortPhase 1: scan the rest, one element per step (primaryIndex = i)
+// sortPhase 2: sort the heap in place, one extraction per step (secondaryIndex = heap end)
+bool StepHeapTopK(VisualizationState& state) {
+    int n = state.size;
+    int heapSize = state.selectRank + 1;
+    int* data = state.array.data();
+    state.tertiaryIndex = state.selectRank;
+    state.highlightStart = 0;
+    state.highlightEnd = (state.sortPhase == 2) ? state.secondaryIndex : heapSize - 1;
+    if (n < 2) return FinishSelection(state);
+
+    if (state.sortPhase == 0) {
+        if (state.primaryIndex < 0) {
+            state.sortPhase = 1;
+            state.primaryIndex = heapSize;
+            return true;
+        }
+        SiftDownMax(data, heapSize, state.primaryIndex, &state.comparisons);
+        TraceRange(state, MEM_REGION_ARRAY, state.primaryIndex, heapSize, false);
+        state.primaryIndex--;
+        return true;
+    }
+
+    if (state.sortPhase == 1) {
+        int i = state.primaryIndex;
+        if (i >= n) {
+            state.sortPhase = 2;
+            state.secondaryIndex = heapSize - 1;
+            state.primaryIndex = -1;
+            return true;
+        }
+        state.comparisons++;
+        TraceRead(state, i);
+        TraceRead(state, 0);
+        if (data[i] < data[0]) {
+            std::swap(data[0], data[i]);
+            state.swaps++;
+            state.bytesMoved += 2 * sizeof(int);
+            TraceWrite(state, i);
+            SiftDownMax(data, heapSize, 0, &state.comparisons);
+            TraceRange(state, MEM_REGION_ARRAY, 0, heapSize, true);
+        }
+        state.secondaryIndex = 0; // Heap root
+        state.primaryIndex++;
+        return true;
+    }
+
+    int end = state.secondaryIndex;
+    if (end <= 0) return FinishSelection(state);
+    std::swap(data[0], data[end]);
+    state.swaps++;
+    state.bytesMoved += 2 * sizeof(int);
+    SiftDownMax(data, end, 0, &state.comparisons);
+    TraceRange(state, MEM_REGION_ARRAY, 0, end + 1, true);
+    state.secondaryIndex--;
+    return true;
+}
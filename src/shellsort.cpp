@@ -0,0 +1,97 @@
+#include "shellsort.h"
+
+void BuildShellGaps(int n, std::vector<int>& gaps) {
+    static const int ciura[] = { 1, 4, 10, 23, 57, 132, 301, 701, 1750 };
+    gaps.clear();
+    for (int gap : ciura) {
+        if (gap >= n && !gaps.empty()) return;
+        gaps.push_back(gap);
+    }
+    double next = gaps.back() * 2.25;
+    while (next < n) {
+        gaps.push_back((int)next);
+        next *= 2.25;
+    }
+}
+
+// Gapped insertion sort, one comparison or shift per step, largest gap first.
+// gapIndex = current gap, primaryIndex = i, secondaryIndex = j (-2: pick the next key),
+// tertiaryIndex = j - gap (element being compared), heldValue = key
+bool StepShellSort(VisualizationState& state) {
+    int n = state.size;
+    if (state.gapIndex < 0 || n < 2) {
+        state.status = VIZ_STATE_FINISHED;
+        state.primaryIndex = -1;
+        state.secondaryIndex = -1;
+        state.tertiaryIndex = -1;
+        return false; // Sort finished
+    }
+
+    int gap = state.gapSequence[state.gapIndex];
+
+    if (state.secondaryIndex == -2) { // Prepare the next key
+        if (state.primaryIndex >= n) {
+            // This gap is done; move to the next smaller one
+            state.gapIndex--;
+            if (state.gapIndex >= 0) state.primaryIndex = state.gapSequence[state.gapIndex];
+            state.tertiaryIndex = -1;
+            return true;
+        }
+        state.heldValue = state.array[state.primaryIndex];
+        TraceRead(state, state.primaryIndex);
+        state.secondaryIndex = state.primaryIndex;
+    }
+
+    int j = state.secondaryIndex;
+    if (j >= gap) {
+        state.tertiaryIndex = j - gap;
+        state.comparisons++;
+        TraceRead(state, j - gap);
+        if (state.array[j - gap] > state.heldValue) {
+            state.array[j] = state.array[j - gap];
+            TraceWrite(state, j);
+            state.bytesMoved += sizeof(int);
+            state.secondaryIndex -= gap;
+            return true;
+        }
+    }
+
+    // Insertion point found; a key that did not move stays put
+    if (j < state.primaryIndex) {
+        state.array[j] = state.heldValue;
+        TraceWrite(state, j);
+        state.bytesMoved += sizeof(int);
+    }
+    state.primaryIndex++;
+    state.secondaryIndex = -2;
+    return true;
+}
+
+void ShellSortFull(std::vector<int>& arr, long long* comparisons, long long* bytesMoved) {
+    std::vector<int> gaps;
+    int n = (int)arr.size();
+    BuildShellGaps(n, gaps);
+
+    long long compares = 0;
+    long long moved = 0;
+    for (int g = (int)gaps.size() - 1; g >= 0; g--) {
+        int gap = gaps[g];
+        for (int i = gap; i < n; i++) {
+            int key = arr[i];
+            int j = i;
+            while (j >= gap) {
+                compares++;
+                if (arr[j - gap] <= key) break;
+                arr[j] = arr[j - gap];
+                moved += sizeof(int);
+                j -= gap;
+            }
+            if (j < i) {
+                arr[j] = key;
+                moved += sizeof(int);
+            }
+        }
+    }
+    if (comparisons) *comparisons += compares;
+    if (bytesMoved) *bytesMoved += moved;
+}
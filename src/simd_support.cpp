@@ -0,0 +1,37 @@
+#include "simd_support.h"
+
+#if ALGOWIZZ_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+static bool DetectAVX2(void) {
+#if ALGOWIZZ_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+
+        // The OS must save the YMM registers on context switch
+        unsigned long long xcr0 = _xgetbv(0);
+        if ((xcr0 & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    #endif
+#else
+    return false;
+#endif
+}
+
+bool CpuSupportsAVX2(void) {
+    static const bool supported = DetectAVX2();
+    return supported;
+}
@@ -0,0 +1,215 @@
+#include "sortingnetwork.h"
+#include "simd_support.h"
+#include <algorithm> // For std::min, std::max
+
+// Layer types stored in NetworkLayer::type
+enum {
+    LAYER_FLIP,       // Bitonic: block of `size`, element t compared with element size-1-t
+    LAYER_HALF,       // Bitonic: element t compared with t + distance inside blocks of 2*distance
+    LAYER_ODDEVEN     // Batcher: merge round `size` (p), compare distance `distance` (k)
+};
+
+// Walks the comparators of a layer as contiguous runs so the inner loops can be vectorized.
+// run(lo, hi, len) compares lo+t with hi+t; reversedRun(lo, hiEnd, len) compares lo+t with hiEnd-t.
+// Comparators whose upper index is >= n are skipped (the padding is +infinity).
+template <typename RunFn, typename ReversedRunFn>
+static void VisitLayerRuns(const VisualizationState::NetworkLayer& layer, int n, RunFn run, ReversedRunFn reversedRun) {
+    switch (layer.type) {
+        case LAYER_FLIP: {
+            int k = layer.size;
+            for (int block = 0; block < n; block += k) {
+                int hiEnd = block + k - 1;
+                int first = std::max(0, hiEnd - n + 1); // Skip pairs whose partner is padding
+                int len = k / 2 - first;
+                if (len > 0) reversedRun(block + first, hiEnd - first, len);
+            }
+            break;
+        }
+        case LAYER_HALF: {
+            int j = layer.distance;
+            for (int block = 0; block < n; block += 2 * j) {
+                int len = std::min(j, n - block - j);
+                if (len > 0) run(block, block + j, len);
+            }
+            break;
+        }
+        case LAYER_ODDEVEN: {
+            int p = layer.size;
+            int k = layer.distance;
+            for (int j = k % p; j <= n - 1 - k; j += 2 * k) {
+                int last = j + std::min(k - 1, n - j - k - 1);
+                // Only pairs inside the same 2p block are compared
+                int x = j;
+                while (x <= last) {
+                    int r = x % (2 * p);
+                    if (r < 2 * p - k) {
+                        int runEnd = std::min(last, x + (2 * p - k - 1 - r));
+                        run(x, x + k, runEnd - x + 1);
+                        x = runEnd + 1;
+                    } else {
+                        x += 2 * p - r;
+                    }
+                }
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+static inline void CompareExchange(int* arr, int lo, int hi) {
+    int a = arr[lo];
+    int b = arr[hi];
+    arr[lo] = std::min(a, b);
+    arr[hi] = std::max(a, b);
+}
+
+static void CompareExchangeRunScalar(int* arr, int lo, int hi, int len) {
+    for (int t = 0; t < len; t++) CompareExchange(arr, lo + t, hi + t);
+}
+
+static void CompareExchangeReversedRunScalar(int* arr, int lo, int hiEnd, int len) {
+    for (int t = 0; t < len; t++) CompareExchange(arr, lo + t, hiEnd - t);
+}
+
+#if ALGOWIZZ_X86
+ALGOWIZZ_TARGET_AVX2
+static void CompareExchangeRunAVX2(int* arr, int lo, int hi, int len) {
+    int t = 0;
+    for (; t + 8 <= len; t += 8) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(arr + lo + t));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(arr + hi + t));
+        _mm256_storeu_si256((__m256i*)(arr + lo + t), _mm256_min_epi32(a, b));
+        _mm256_storeu_si256((__m256i*)(arr + hi + t), _mm256_max_epi32(a, b));
+    }
+    for (; t < len; t++) CompareExchange(arr, lo + t, hi + t);
+}
+
+ALGOWIZZ_TARGET_AVX2
+static void CompareExchangeReversedRunAVX2(int* arr, int lo, int hiEnd, int len) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    int t = 0;
+    for (; t + 8 <= len; t += 8) {
+        int* hiPtr = arr + hiEnd - t - 7;
+        __m256i a = _mm256_loadu_si256((const __m256i*)(arr + lo + t));
+        __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)hiPtr), reverse);
+        _mm256_storeu_si256((__m256i*)(arr + lo + t), _mm256_min_epi32(a, b));
+        _mm256_storeu_si256((__m256i*)hiPtr, _mm256_permutevar8x32_epi32(_mm256_max_epi32(a, b), reverse));
+    }
+    for (; t < len; t++) CompareExchange(arr, lo + t, hiEnd - t);
+}
+#endif
+
+void BuildSortingNetwork(SortingNetworkKind kind, int n, std::vector<VisualizationState::NetworkLayer>& layers) {
+    layers.clear();
+    if (n < 2) return;
+
+    if (kind == NETWORK_BITONIC) {
+        int padded = 1;
+        while (padded < n) padded *= 2;
+        for (int k = 2; k <= padded; k *= 2) {
+            layers.push_back({LAYER_FLIP, k, k / 2});
+            for (int j = k / 4; j >= 1; j /= 2) {
+                layers.push_back({LAYER_HALF, 2 * j, j});
+            }
+        }
+    } else {
+        for (int p = 1; p < n; p *= 2) {
+            for (int k = p; k >= 1; k /= 2) {
+                layers.push_back({LAYER_ODDEVEN, p, k});
+            }
+        }
+    }
+}
+
+long long ApplyNetworkLayer(int* arr, int n, const VisualizationState::NetworkLayer& layer) {
+    long long comparators = 0;
+#if ALGOWIZZ_X86
+    if (CpuSupportsAVX2()) {
+        VisitLayerRuns(layer, n,
+            [arr, &comparators](int lo, int hi, int len) { CompareExchangeRunAVX2(arr, lo, hi, len); comparators += len; },
+            [arr, &comparators](int lo, int hiEnd, int len) { CompareExchangeReversedRunAVX2(arr, lo, hiEnd, len); comparators += len; });
+        return comparators;
+    }
+#endif
+    VisitLayerRuns(layer, n,
+        [arr, &comparators](int lo, int hi, int len) { CompareExchangeRunScalar(arr, lo, hi, len); comparators += len; },
+        [arr, &comparators](int lo, int hiEnd, int len) { CompareExchangeReversedRunScalar(arr, lo, hiEnd, len); comparators += len; });
+    return comparators;
+}
+
+void GetNetworkLayerPairs(const VisualizationState::NetworkLayer& layer, int n, std::vector<std::pair<int, int>>& pairs) {
+    pairs.clear();
+    VisitLayerRuns(layer, n,
+        [&pairs](int lo, int hi, int len) { for (int t = 0; t < len; t++) pairs.push_back({lo + t, hi + t}); },
+        [&pairs](int lo, int hiEnd, int len) { for (int t = 0; t < len; t++) pairs.push_back({lo + t, hiEnd - t}); });
+}
+
+// Flattened comparator lists for every block size up to NETWORK_BASE_CASE_MAX, built once
+struct SmallNetworkTable {
+    std::vector<std::pair<int, int>> pairs[NETWORK_BASE_CASE_MAX + 1];
+
+    SmallNetworkTable() {
+        std::vector<VisualizationState::NetworkLayer> layers;
+        std::vector<std::pair<int, int>> layerPairs;
+        for (int n = 2; n <= NETWORK_BASE_CASE_MAX; n++) {
+            BuildSortingNetwork(NETWORK_ODDEVEN_MERGE, n, layers);
+            for (const VisualizationState::NetworkLayer& layer : layers) {
+                GetNetworkLayerPairs(layer, n, layerPairs);
+                pairs[n].insert(pairs[n].end(), layerPairs.begin(), layerPairs.end());
+            }
+        }
+    }
+};
+
+void SortSmallWithNetwork(int* arr, int n) {
+    static const SmallNetworkTable table;
+    if (n < 2 || n > NETWORK_BASE_CASE_MAX) return;
+    // min/max compile to conditional moves, so the base case has no data-dependent branches
+    for (const std::pair<int, int>& p : table.pairs[n]) {
+        CompareExchange(arr, p.first, p.second);
+    }
+}
+
+void SortingNetworkFull(std::vector<int>& arr, SortingNetworkKind kind) {
+    std::vector<VisualizationState::NetworkLayer> layers;
+    BuildSortingNetwork(kind, (int)arr.size(), layers);
+    for (const VisualizationState::NetworkLayer& layer : layers) {
+        ApplyNetworkLayer(arr.data(), (int)arr.size(), layer);
+    }
+}
+
+const char* GetSortingNetworkName(SortingNetworkKind kind) {
+    return (kind == NETWORK_BITONIC) ? "Bitonic" : "Odd-Even Merge";
+}
+
+// Each step applies one complete layer of the network.
+// networkLayerIndex = next layer to apply
+bool StepSortingNetwork(VisualizationState& state) {
+    if (state.networkLayerIndex >= (int)state.networkLayers.size()) {
+        state.status = VIZ_STATE_FINISHED;
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+        return false; // Sort finished
+    }
+
+    const VisualizationState::NetworkLayer& layer = state.networkLayers[state.networkLayerIndex];
+    if (state.memoryTrace) {
+        // Comparators read both ends and write them back (min/max are unconditional)
+        std::vector<std::pair<int, int>> pairs;
+        GetNetworkLayerPairs(layer, state.size, pairs);
+        for (const std::pair<int, int>& p : pairs) {
+            TraceRead(state, p.first);
+            TraceRead(state, p.second);
+            TraceWrite(state, p.first);
+            TraceWrite(state, p.second);
+        }
+    }
+    state.comparisons += ApplyNetworkLayer(state.array.data(), state.size, layer);
+    state.networkLayerIndex++;
+
+    // Range highlight covers the whole array; the drawn comparators come from the last layer
+    state.highlightStart = 0;
+    state.highlightEnd = state.size - 1;
+    return true;
+}
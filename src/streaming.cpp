@@ -0,0 +1,310 @@
+#include "streaming.h"
+#include "visualization_state.h"
+#include "profiler.h"   // For ProfilerNow / ProfilerTicksToMs
+#include <algorithm>
+#include <cstring>     // For std::memmove, std::memcpy
+#include <functional>  // For std::greater
+
+const char* GetStreamStructureName(StreamStructure structure) {
+    switch (structure) {
+        case STREAM_TOPK_HEAP: return "Top-k Heap";
+        case STREAM_BTREE:     return "B+tree";
+        case STREAM_LSM:       return "LSM Runs";
+        default:               return "Unknown";
+    }
+}
+
+// --- B+tree ---
+
+static int NewBTreeNode(StreamIngest& stream, bool leaf) {
+    stream.nodes.push_back(BTreeNode());
+    BTreeNode& node = stream.nodes.back();
+    node.count = 0;
+    node.leaf = leaf;
+    node.next = -1;
+    return (int)stream.nodes.size() - 1;
+}
+
+static int KeyUpperBound(const int* keys, int count, int value) {
+    return (int)(std::upper_bound(keys, keys + count, value) - keys);
+}
+
+// Descend to the leaf, insert, then split overflowing nodes bottom-up. Node references
+// are re-fetched after every allocation because the pool may move.
+static void BTreeInsert(StreamIngest& stream, int value) {
+    int path[32];
+    int pathSlot[32];
+    int depth = 0;
+    int node = stream.root;
+    while (!stream.nodes[node].leaf) {
+        const BTreeNode& inner = stream.nodes[node];
+        int slot = KeyUpperBound(inner.keys, inner.count, value);
+        path[depth] = node;
+        pathSlot[depth] = slot;
+        depth++;
+        node = inner.children[slot];
+    }
+
+    BTreeNode* leaf = &stream.nodes[node];
+    int pos = KeyUpperBound(leaf->keys, leaf->count, value);
+    std::memmove(&leaf->keys[pos + 1], &leaf->keys[pos], (size_t)(leaf->count - pos) * sizeof(int));
+    leaf->keys[pos] = value;
+    leaf->count++;
+    stream.bytesMoved += (long long)(leaf->count - pos) * sizeof(int);
+    if (leaf->count <= BTREE_MAX_KEYS) return;
+
+    // Split the leaf: the right half moves to a new leaf and its first key is copied up.
+    // Splits only ever create right siblings, so node 0 stays the leftmost leaf.
+    int right = NewBTreeNode(stream, true);
+    leaf = &stream.nodes[node];
+    BTreeNode& rightLeaf = stream.nodes[right];
+    int half = leaf->count / 2;
+    rightLeaf.count = leaf->count - half;
+    std::memcpy(rightLeaf.keys, leaf->keys + half, (size_t)rightLeaf.count * sizeof(int));
+    leaf->count = half;
+    rightLeaf.next = leaf->next;
+    leaf->next = right;
+    stream.bytesMoved += (long long)rightLeaf.count * sizeof(int);
+    int separator = rightLeaf.keys[0];
+    int child = right;
+
+    while (depth > 0) {
+        depth--;
+        int parent = path[depth];
+        int slot = pathSlot[depth];
+        BTreeNode* p = &stream.nodes[parent];
+        std::memmove(&p->keys[slot + 1], &p->keys[slot], (size_t)(p->count - slot) * sizeof(int));
+        std::memmove(&p->children[slot + 2], &p->children[slot + 1], (size_t)(p->count - slot) * sizeof(int));
+        p->keys[slot] = separator;
+        p->children[slot + 1] = child;
+        p->count++;
+        if (p->count <= BTREE_MAX_KEYS) return;
+
+        // Split the inner node: the middle key moves up and stays in neither half
+        int sibling = NewBTreeNode(stream, false);
+        p = &stream.nodes[parent];
+        BTreeNode& q = stream.nodes[sibling];
+        int mid = p->count / 2;
+        separator = p->keys[mid];
+        q.count = p->count - mid - 1;
+        std::memcpy(q.keys, p->keys + mid + 1, (size_t)q.count * sizeof(int));
+        std::memcpy(q.children, p->children + mid + 1, (size_t)(q.count + 1) * sizeof(int));
+        p->count = mid;
+        child = sibling;
+    }
+
+    // The root itself split: the tree grows by one level
+    int newRoot = NewBTreeNode(stream, false);
+    BTreeNode& top = stream.nodes[newRoot];
+    top.count = 1;
+    top.keys[0] = separator;
+    top.children[0] = stream.root;
+    top.children[1] = child;
+    stream.root = newRoot;
+    stream.height++;
+}
+
+// --- LSM ---
+
+// Merge every run of a level that reached LSM_FANOUT runs into one run on the next
+// level, cascading down. Runs are kept ordered by level, deepest (largest) first.
+static void CompactLsm(StreamIngest& stream) {
+    for (int level = 0; ; level++) {
+        int runsAtLevel = 0;
+        for (const LsmRun& run : stream.runs) runsAtLevel += (run.level == level);
+        if (runsAtLevel < LSM_FANOUT) {
+            if (runsAtLevel == 0) return;
+            continue;
+        }
+
+        LsmRun merged = { level + 1, {} };
+        std::vector<int> temp;
+        for (size_t r = 0; r < stream.runs.size(); ) {
+            if (stream.runs[r].level != level) {
+                r++;
+                continue;
+            }
+            temp.resize(merged.keys.size() + stream.runs[r].keys.size());
+            std::merge(merged.keys.begin(), merged.keys.end(), stream.runs[r].keys.begin(), stream.runs[r].keys.end(), temp.begin());
+            merged.keys.swap(temp);
+            stream.bytesMoved += (long long)merged.keys.size() * sizeof(int);
+            stream.runs.erase(stream.runs.begin() + r);
+        }
+        stream.runs.push_back(std::move(merged));
+        std::stable_sort(stream.runs.begin(), stream.runs.end(), [](const LsmRun& a, const LsmRun& b) { return a.level > b.level; });
+        stream.compactions++;
+    }
+}
+
+static void LsmInsert(StreamIngest& stream, int value) {
+    std::vector<int>& mem = stream.memtable;
+    int pos = KeyUpperBound(mem.data(), (int)mem.size(), value);
+    mem.insert(mem.begin() + pos, value); // Capacity is reserved on reset and after each flush
+    stream.bytesMoved += (long long)((int)mem.size() - pos) * sizeof(int);
+    if ((int)mem.size() < LSM_MEMTABLE_SIZE) return;
+
+    // Flush: the memtable becomes a level-0 run
+    stream.runs.push_back({ 0, std::move(mem) });
+    mem = std::vector<int>();
+    mem.reserve(LSM_MEMTABLE_SIZE);
+    CompactLsm(stream);
+}
+
+// --- Common ---
+
+void ResetStream(StreamIngest& stream) {
+    stream.count = 0;
+    stream.bytesMoved = 0;
+    stream.heap.clear();
+    stream.nodes.clear();
+    stream.root = NewBTreeNode(stream, true);
+    stream.height = 1;
+    stream.memtable.clear();
+    stream.memtable.reserve(LSM_MEMTABLE_SIZE);
+    stream.runs.clear();
+    stream.compactions = 0;
+    stream.latencies.clear();
+    stream.p50Ns = stream.p99Ns = stream.p999Ns = 0.0;
+    stream.ingestTicks = 0;
+    stream.checkpointTicks = 0;
+    stream.checkpointStartCount = 0;
+    stream.nextCheckpoint = STREAM_FIRST_CHECKPOINT;
+    stream.checkpoints.clear();
+}
+
+void StreamInsert(StreamIngest& stream, int value) {
+    switch (stream.structure) {
+        case STREAM_TOPK_HEAP:
+            // Min-heap of the k largest: a new value only enters if it beats the smallest kept
+            if ((int)stream.heap.size() < stream.topK) {
+                stream.heap.push_back(value);
+                std::push_heap(stream.heap.begin(), stream.heap.end(), std::greater<int>());
+            } else if (stream.topK > 0 && value > stream.heap[0]) {
+                std::pop_heap(stream.heap.begin(), stream.heap.end(), std::greater<int>());
+                stream.heap.back() = value;
+                std::push_heap(stream.heap.begin(), stream.heap.end(), std::greater<int>());
+            }
+            break;
+        case STREAM_BTREE:
+            BTreeInsert(stream, value);
+            break;
+        case STREAM_LSM:
+        default:
+            LsmInsert(stream, value);
+            break;
+    }
+    stream.count++;
+}
+
+static double LatencyPercentileNs(std::vector<uint32_t>& sorted, double fraction) {
+    size_t index = (size_t)(fraction * (double)(sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return ProfilerTicksToMs(sorted[index]) * 1e6;
+}
+
+void StreamIngestBatch(StreamIngest& stream, const int* values, int count) {
+    for (int i = 0; i < count; i++) {
+        uint64_t begin = ProfilerNow();
+        StreamInsert(stream, values[i]);
+        uint64_t ticks = ProfilerNow() - begin;
+        stream.ingestTicks += ticks;
+        stream.checkpointTicks += ticks;
+
+        uint32_t sample = (uint32_t)std::min<uint64_t>(ticks, UINT32_MAX);
+        if (stream.latencies.size() < STREAM_LATENCY_WINDOW) stream.latencies.push_back(sample);
+        else stream.latencies[(size_t)(stream.count % STREAM_LATENCY_WINDOW)] = sample;
+    }
+    if (stream.latencies.empty()) return;
+
+    std::vector<uint32_t> sorted = stream.latencies;
+    stream.p50Ns = LatencyPercentileNs(sorted, 0.50);
+    stream.p99Ns = LatencyPercentileNs(sorted, 0.99);
+    stream.p999Ns = LatencyPercentileNs(sorted, 0.999);
+
+    if (stream.count >= stream.nextCheckpoint) {
+        double seconds = ProfilerTicksToMs(stream.checkpointTicks) / 1000.0;
+        StreamCheckpoint checkpoint = {
+            stream.count, stream.p50Ns, stream.p99Ns, stream.p999Ns,
+            seconds > 0.0 ? (double)(stream.count - stream.checkpointStartCount) / seconds : 0.0
+        };
+        stream.checkpoints.push_back(checkpoint);
+        stream.checkpointTicks = 0;
+        stream.checkpointStartCount = stream.count;
+        while (stream.nextCheckpoint <= stream.count) stream.nextCheckpoint *= 2;
+    }
+}
+
+// Copy `shown` evenly spaced elements of sorted[0, length) to out
+static void SampleSorted(const int* sorted, long long length, int shown, int* out) {
+    for (int j = 0; j < shown; j++) out[j] = sorted[(long long)j * length / shown];
+}
+
+void BuildStreamView(const StreamIngest& stream, std::vector<int>& view, std::vector<StreamSegment>& segments) {
+    std::fill(view.begin(), view.end(), 0);
+    segments.clear();
+    int viewSize = (int)view.size();
+
+    if (stream.structure == STREAM_TOPK_HEAP) {
+        std::vector<int> sorted = stream.heap;
+        std::sort(sorted.begin(), sorted.end());
+        int shown = std::min(viewSize, (int)sorted.size());
+        if (shown > 0) SampleSorted(sorted.data(), (long long)sorted.size(), shown, view.data());
+        return;
+    }
+
+    long long total = stream.count;
+    int shown = (int)std::min<long long>(viewSize, total);
+    if (shown == 0) return;
+
+    if (stream.structure == STREAM_BTREE) {
+        // One pass along the leaf chain, picking every (total / shown)-th key
+        long long position = 0;
+        int next = 0;
+        for (int leaf = 0; leaf != -1 && next < shown; leaf = stream.nodes[leaf].next) {
+            const BTreeNode& node = stream.nodes[leaf];
+            while (next < shown) {
+                long long target = (long long)next * total / shown;
+                if (target >= position + node.count) break;
+                view[next++] = node.keys[target - position];
+            }
+            position += node.count;
+        }
+        return;
+    }
+
+    // LSM: each run (deepest first), then the memtable, gets bars in proportion to its size
+    long long before = 0;
+    auto addSegment = [&](const std::vector<int>& keys, int level) {
+        int start = (int)(before * shown / total);
+        before += (long long)keys.size();
+        int end = (int)(before * shown / total);
+        if (end > start) {
+            SampleSorted(keys.data(), (long long)keys.size(), end - start, view.data() + start);
+            segments.push_back({ start, end - start, level });
+        }
+    };
+    for (const LsmRun& run : stream.runs) addSegment(run.keys, run.level);
+    addSegment(stream.memtable, -1);
+}
+
+// Each step is one arrival batch of arrivalRate / speed elements drawn from the
+// selected distribution; state.array shows the structure's contents afterwards
+bool StepStreamIngest(VisualizationState& state) {
+    StreamIngest& stream = state.stream;
+    if (stream.count >= STREAM_MAX_ELEMENTS) {
+        state.status = VIZ_STATE_FINISHED;
+        return false; // Stream ended
+    }
+
+    long long batch = std::max(1LL, (long long)(stream.arrivalRate / std::max(state.speed, 0.1f)));
+    batch = std::min(batch, (long long)STREAM_MAX_ELEMENTS - stream.count);
+    state.scratchBuffer.resize((size_t)batch);
+    GenerateArrayData(state.scratchBuffer, state.distribution);
+
+    long long bytesBefore = stream.bytesMoved;
+    StreamIngestBatch(stream, state.scratchBuffer.data(), (int)batch);
+    state.bytesMoved += stream.bytesMoved - bytesBefore;
+
+    BuildStreamView(stream, state.array, state.streamSegments);
+    return true;
+}
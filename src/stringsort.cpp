@@ -0,0 +1,258 @@
+#include "stringsort.h"
+#include "visualization_state.h"
+#include <algorithm>
+#include <cstdlib>  // For rand()
+#include <cstring>  // For std::memcmp
+
+const char* GetStringKeyKindName(StringKeyKind kind) {
+    switch (kind) {
+        case STRING_KEYS_WORDS: return "Words";
+        case STRING_KEYS_URLS:  return "URLs";
+        case STRING_KEYS_IDS:   return "Ids";
+        default:                return "Unknown";
+    }
+}
+
+// --- Arena ---
+
+static void AppendRandomWord(std::string& key, int minLength, int maxLength) {
+    int length = minLength + rand() % (maxLength - minLength + 1);
+    for (int c = 0; c < length; c++) key += (char)('a' + rand() % 26);
+}
+
+static void AppendKey(StringArena& arena, const std::string& key) {
+    StringHandle h;
+    h.offset = (uint32_t)arena.bytes.size();
+    h.length = (uint32_t)key.size();
+    h.prefix = 0;
+    for (int b = 0; b < STRING_PREFIX_BYTES; b++) {
+        h.prefix = (h.prefix << 8) | (b < (int)key.size() ? (unsigned char)key[b] : 0);
+    }
+    arena.bytes.insert(arena.bytes.end(), key.begin(), key.end());
+    arena.handles.push_back(h);
+}
+
+void GenerateStrings(StringArena& arena, int count, StringKeyKind kind) {
+    static const char* sections[] = { "docs/", "blog/2024/", "api/v2/users/", "static/img/" };
+    arena.bytes.clear();
+    arena.handles.clear();
+    arena.handles.reserve(count);
+    std::string key;
+    for (int i = 0; i < count; i++) {
+        key.clear();
+        if (kind == STRING_KEYS_URLS) {
+            key = "https://www.example.com/";
+            key += sections[rand() % 4];
+            AppendRandomWord(key, 4, 10);
+            key += (rand() % 2) ? ".html" : "/index";
+        } else if (kind == STRING_KEYS_IDS) {
+            for (int d = 0; d < 12; d++) key += (char)('0' + rand() % 10);
+        } else {
+            AppendRandomWord(key, 3, 12);
+        }
+        AppendKey(arena, key);
+    }
+
+    // Shared prefix and the spread of the two bytes after it, for the bar heights
+    arena.sharedPrefix = 0;
+    if (count > 0) {
+        const StringHandle& first = arena.handles[0];
+        int shared = (int)first.length;
+        for (const StringHandle& h : arena.handles) {
+            int common = 0;
+            int limit = std::min(shared, (int)h.length);
+            while (common < limit && arena.bytes[h.offset + common] == arena.bytes[first.offset + common]) common++;
+            shared = common;
+        }
+        arena.sharedPrefix = shared;
+    }
+    arena.viewMin = 0xFFFF;
+    arena.viewMax = 0;
+    for (const StringHandle& h : arena.handles) {
+        int key16 = (StringCharAt(arena, h, arena.sharedPrefix) << 8) | StringCharAt(arena, h, arena.sharedPrefix + 1);
+        arena.viewMin = std::min(arena.viewMin, key16);
+        arena.viewMax = std::max(arena.viewMax, key16);
+    }
+}
+
+std::string GetStringKey(const StringArena& arena, const StringHandle& h) {
+    return std::string(arena.bytes.data() + h.offset, h.length);
+}
+
+int StringViewValue(const StringArena& arena, const StringHandle& h) {
+    int key16 = (StringCharAt(arena, h, arena.sharedPrefix) << 8) | StringCharAt(arena, h, arena.sharedPrefix + 1);
+    return 5 + (key16 - arena.viewMin) * 99 / std::max(1, arena.viewMax - arena.viewMin);
+}
+
+void BuildStringView(const StringArena& arena, std::vector<int>& view) {
+    int n = std::min((int)view.size(), (int)arena.handles.size());
+    for (int i = 0; i < n; i++) view[i] = StringViewValue(arena, arena.handles[i]);
+}
+
+// Compare two keys known to agree on their first `depth` bytes
+static int StringCompareFrom(const StringArena& arena, const StringHandle& a, const StringHandle& b, int depth) {
+    if (depth < STRING_PREFIX_BYTES && a.prefix != b.prefix) return a.prefix < b.prefix ? -1 : 1;
+    int start = std::max(depth, STRING_PREFIX_BYTES);
+    int common = (int)std::min(a.length, b.length) - start;
+    if (common > 0) {
+        int c = std::memcmp(&arena.bytes[a.offset + start], &arena.bytes[b.offset + start], (size_t)common);
+        if (c != 0) return c;
+    }
+    return (int)a.length - (int)b.length;
+}
+
+bool StringLess(const StringArena& arena, const StringHandle& a, const StringHandle& b) {
+    return StringCompareFrom(arena, a, b, 0) < 0;
+}
+
+static void InsertionSortFrom(StringArena& arena, int low, int high, int depth, long long* comparisons) {
+    StringHandle* h = arena.handles.data();
+    long long compares = 0;
+    for (int i = low + 1; i <= high; i++) {
+        StringHandle key = h[i];
+        int j = i - 1;
+        while (j >= low && (compares++, StringCompareFrom(arena, key, h[j], depth) < 0)) {
+            h[j + 1] = h[j];
+            j--;
+        }
+        h[j + 1] = key;
+    }
+    if (comparisons) *comparisons += compares;
+}
+
+// --- Multikey quicksort (Bentley & Sedgewick) ---
+// Three-way partition on the byte at `depth`: the smaller and larger parts keep the
+// depth, the equal part moves on to the next byte.
+
+void MultikeyPartition(StringArena& arena, StringSortRange r, std::vector<StringSortRange>& pending, long long* comparisons) {
+    if (r.high - r.low < 1) return;
+    if (r.high - r.low + 1 <= STRING_INSERTION_CUTOFF) {
+        InsertionSortFrom(arena, r.low, r.high, r.depth, comparisons);
+        return;
+    }
+    StringHandle* h = arena.handles.data();
+    int d = r.depth;
+
+    // Median-of-three pivot byte
+    int a = StringCharAt(arena, h[r.low], d);
+    int b = StringCharAt(arena, h[r.low + (r.high - r.low) / 2], d);
+    int c = StringCharAt(arena, h[r.high], d);
+    int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+    int lt = r.low;
+    int gt = r.high;
+    int i = r.low;
+    long long compares = 3;
+    while (i <= gt) {
+        int ch = StringCharAt(arena, h[i], d);
+        compares++;
+        if (ch < pivot) std::swap(h[lt++], h[i++]);
+        else if (ch > pivot) std::swap(h[i], h[gt--]);
+        else i++;
+    }
+    if (comparisons) *comparisons += compares;
+
+    if (lt - 1 > r.low) pending.push_back({ r.low, lt - 1, d });
+    if (gt + 1 < r.high) pending.push_back({ gt + 1, r.high, d });
+    if (pivot != 0 && gt > lt) pending.push_back({ lt, gt, d + 1 }); // Pivot 0: equal keys, done
+}
+
+void MultikeyQuicksortFull(StringArena& arena, long long* comparisons) {
+    if (arena.handles.size() < 2) return;
+    std::vector<StringSortRange> pending;
+    pending.push_back({ 0, (int)arena.handles.size() - 1, 0 });
+    while (!pending.empty()) {
+        StringSortRange r = pending.back();
+        pending.pop_back();
+        MultikeyPartition(arena, r, pending, comparisons);
+    }
+}
+
+// --- MSD radix sort ---
+// Counting sort on the byte at `depth` (bucket 0 = key ended), through the scratch
+// buffer; every non-empty bucket except the ended keys moves on to the next byte.
+
+void MsdRadixPartition(StringArena& arena, StringSortRange r, std::vector<StringHandle>& scratch,
+                       std::vector<StringSortRange>& pending, long long* comparisons, long long* bytesMoved) {
+    int n = r.high - r.low + 1;
+    if (n < 2) return;
+    if (n < STRING_RADIX_CUTOFF) {
+        MultikeyPartition(arena, r, pending, comparisons);
+        return;
+    }
+    StringHandle* h = arena.handles.data();
+    int d = r.depth;
+    int counts[256] = { 0 };
+    for (int i = r.low; i <= r.high; i++) counts[StringCharAt(arena, h[i], d)]++;
+    if (comparisons) *comparisons += n;
+    int shared = StringCharAt(arena, h[r.low], d);
+    if (counts[shared] == n) {
+        // Every key has the same byte here (a shared prefix): nothing to move
+        if (shared != 0) pending.push_back({ r.low, r.high, d + 1 });
+        return;
+    }
+
+    int starts[256];
+    int offset = 0;
+    for (int b = 0; b < 256; b++) {
+        starts[b] = offset;
+        offset += counts[b];
+    }
+    if ((int)scratch.size() < n) scratch.resize(n);
+    for (int i = r.low; i <= r.high; i++) scratch[starts[StringCharAt(arena, h[i], d)]++] = h[i];
+    std::copy(scratch.begin(), scratch.begin() + n, h + r.low);
+    if (bytesMoved) *bytesMoved += 2LL * n * sizeof(StringHandle);
+
+    int bucketStart = r.low + counts[0];
+    for (int b = 1; b < 256; b++) {
+        if (counts[b] > 1) pending.push_back({ bucketStart, bucketStart + counts[b] - 1, d + 1 });
+        bucketStart += counts[b];
+    }
+}
+
+void MsdRadixSortFull(StringArena& arena, long long* comparisons, long long* bytesMoved) {
+    if (arena.handles.size() < 2) return;
+    std::vector<StringHandle> scratch(arena.handles.size());
+    std::vector<StringSortRange> pending;
+    pending.push_back({ 0, (int)arena.handles.size() - 1, 0 });
+    while (!pending.empty()) {
+        StringSortRange r = pending.back();
+        pending.pop_back();
+        MsdRadixPartition(arena, r, scratch, pending, comparisons, bytesMoved);
+    }
+}
+
+// --- Step engines ---
+// One range per step from stringRanges. The bars are rebuilt from the handles after
+// the step; highlightStart/End show the range and tertiaryIndex its first element.
+
+static bool StepStringEngine(VisualizationState& state, bool radix) {
+    if (state.stringRanges.empty()) {
+        state.status = VIZ_STATE_FINISHED;
+        state.tertiaryIndex = -1;
+        state.highlightStart = -1;
+        state.highlightEnd = -1;
+        return false;
+    }
+    StringSortRange r = state.stringRanges.back();
+    state.stringRanges.pop_back();
+    if (radix) {
+        MsdRadixPartition(state.strings, r, state.stringScratch, state.stringRanges, &state.comparisons, &state.bytesMoved);
+    } else {
+        MultikeyPartition(state.strings, r, state.stringRanges, &state.comparisons);
+    }
+    state.stringDepth = r.depth;
+    state.highlightStart = r.low;
+    state.highlightEnd = r.high;
+    state.tertiaryIndex = r.low;
+    for (int i = r.low; i <= r.high; i++) state.array[i] = StringViewValue(state.strings, state.strings.handles[i]);
+    return true;
+}
+
+bool StepMultikeyQuicksort(VisualizationState& state) {
+    return StepStringEngine(state, false);
+}
+
+bool StepMsdRadixSort(VisualizationState& state) {
+    return StepStringEngine(state, true);
+}
@@ -1,5 +1,7 @@
 #include "ui_components.h"
 #include "raymath.h" // Required for CheckCollisionPointRec
+#include "rlgl.h"    // Quads for the retained panels
+#include <cstring>
 
 bool DrawNButton(NButton& button) {
     Vector2 mousePos = GetMousePosition();
@@ -21,8 +23,12 @@ bool DrawNButton(NButton& button) {
         clicked = true;
     }
 
-    // Draw the button background using N-Patch
-    DrawTextureNPatch(button.texture, button.nPatchInfo, button.bounds, Vector2Zero(), 0.0f, currentTint);
+    // Draw the button background using N-Patch (a plain rectangle until the texture is uploaded)
+    if (button.texture.id != 0) {
+        DrawTextureNPatch(button.texture, button.nPatchInfo, button.bounds, Vector2Zero(), 0.0f, currentTint);
+    } else {
+        DrawRectangleRec(button.bounds, currentTint);
+    }
 
     // Draw the text centered
     float textWidth = MeasureText(button.text, button.fontSize);
@@ -34,4 +40,220 @@ bool DrawNButton(NButton& button) {
     DrawText(button.text, (int)textPosition.x, (int)textPosition.y, button.fontSize, button.textColor);
 
     return clicked;
-}
\ No newline at end of file
+}
+
+// --- Retained widgets ---
+
+void InitUiPanel(UiPanel& panel, int widgetCount) {
+    panel.widgets.assign(widgetCount, UiWidget{});
+    panel.texture = Texture2D{};
+    panel.nPatchInfo = NPatchInfo{};
+    panel.hovered = -1;
+    panel.clicked = -1;
+    panel.pressed = false;
+}
+
+void SetUiPanelTexture(UiPanel& panel, Texture2D texture, NPatchInfo nPatchInfo) {
+    const NPatchInfo& n = panel.nPatchInfo;
+    bool same = panel.texture.id == texture.id && panel.texture.width == texture.width &&
+                panel.texture.height == texture.height && n.left == nPatchInfo.left && n.top == nPatchInfo.top &&
+                n.right == nPatchInfo.right && n.bottom == nPatchInfo.bottom &&
+                n.source.x == nPatchInfo.source.x && n.source.y == nPatchInfo.source.y &&
+                n.source.width == nPatchInfo.source.width && n.source.height == nPatchInfo.source.height;
+    if (same) return;
+    panel.texture = texture;
+    panel.nPatchInfo = nPatchInfo;
+    for (UiWidget& widget : panel.widgets) widget.dirty = true;
+}
+
+void BeginUiLayout(UiPanel& panel) {
+    for (UiWidget& widget : panel.widgets) widget.visible = false;
+}
+
+static bool SameRectangle(Rectangle a, Rectangle b) {
+    return a.x == b.x && a.y == b.y && a.width == b.width && a.height == b.height;
+}
+
+// Copy a label (truncated to the capacity) and report whether it differs from the old one
+static bool StoreLabel(UiWidget& widget, const char* text) {
+    if (strncmp(widget.label, text, UI_LABEL_CAPACITY - 1) == 0) return false;
+    strncpy(widget.label, text, UI_LABEL_CAPACITY - 1);
+    widget.label[UI_LABEL_CAPACITY - 1] = '\0';
+    return true;
+}
+
+void SetUiButton(UiPanel& panel, int id, Rectangle bounds, const char* label,
+                 Color tintNormal, Color tintHover, Color tintPressed, Color textColor, int fontSize) {
+    UiWidget& widget = panel.widgets[id];
+    bool changed = StoreLabel(widget, label) || widget.kind != UI_WIDGET_BUTTON ||
+                   !SameRectangle(widget.bounds, bounds) || widget.fontSize != fontSize;
+    widget.kind = UI_WIDGET_BUTTON;
+    widget.visible = true;
+    widget.bounds = bounds;
+    widget.fontSize = fontSize;
+    // Colors are applied at submission, they do not invalidate the quads
+    widget.textColor = textColor;
+    widget.tintNormal = tintNormal;
+    widget.tintHover = tintHover;
+    widget.tintPressed = tintPressed;
+    if (changed) widget.dirty = true;
+}
+
+void SetUiLabel(UiPanel& panel, int id, float x, float y, const char* text, int fontSize, Color color) {
+    UiWidget& widget = panel.widgets[id];
+    bool changed = StoreLabel(widget, text) || widget.kind != UI_WIDGET_LABEL ||
+                   widget.bounds.x != x || widget.bounds.y != y || widget.fontSize != fontSize;
+    widget.kind = UI_WIDGET_LABEL;
+    widget.visible = true;
+    widget.bounds.x = x;
+    widget.bounds.y = y;
+    widget.fontSize = fontSize;
+    widget.textColor = color;
+    if (changed) widget.dirty = true;
+}
+
+void UpdateUiPanel(UiPanel& panel) {
+    Vector2 mousePos = GetMousePosition();
+    panel.hovered = -1;
+    for (int i = 0; i < (int)panel.widgets.size(); i++) {
+        const UiWidget& widget = panel.widgets[i];
+        if (widget.visible && widget.kind == UI_WIDGET_BUTTON && CheckCollisionPointRec(mousePos, widget.bounds)) {
+            panel.hovered = i;
+            break;
+        }
+    }
+    panel.pressed = panel.hovered >= 0 && IsMouseButtonDown(MOUSE_LEFT_BUTTON);
+    panel.clicked = (panel.hovered >= 0 && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) ? panel.hovered : -1;
+}
+
+static UiQuad MakeQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1) {
+    UiQuad quad = { x0, y0, x1, y1, u0, v0, u1, v1 };
+    return quad;
+}
+
+// Same split as DrawTextureNPatch (NPATCH_NINE_PATCH, no origin or rotation): borders
+// shrink proportionally when the button is smaller than them, and the center row or
+// column is then left out
+static void BuildBackgroundQuads(UiWidget& widget, Texture2D texture, NPatchInfo n) {
+    widget.backgroundQuads = 0;
+    if (texture.id == 0) return;
+
+    Rectangle dest = widget.bounds;
+    float width = (float)texture.width;
+    float height = (float)texture.height;
+    float patchWidth = ((int)dest.width <= 0) ? 0.0f : dest.width;
+    float patchHeight = ((int)dest.height <= 0) ? 0.0f : dest.height;
+    float left = (float)n.left, top = (float)n.top, right = (float)n.right, bottom = (float)n.bottom;
+    bool drawCenter = true;
+    bool drawMiddle = true;
+    if (patchWidth <= left + right) {
+        drawCenter = false;
+        left = (left / (left + right)) * patchWidth;
+        right = patchWidth - left;
+    }
+    if (patchHeight <= top + bottom) {
+        drawMiddle = false;
+        top = (top / (top + bottom)) * patchHeight;
+        bottom = patchHeight - top;
+    }
+
+    const float xs[4] = { dest.x, dest.x + left, dest.x + patchWidth - right, dest.x + patchWidth };
+    const float ys[4] = { dest.y, dest.y + top, dest.y + patchHeight - bottom, dest.y + patchHeight };
+    const float us[4] = { n.source.x / width, (n.source.x + left) / width,
+                          (n.source.x + n.source.width - right) / width, (n.source.x + n.source.width) / width };
+    const float vs[4] = { n.source.y / height, (n.source.y + top) / height,
+                          (n.source.y + n.source.height - bottom) / height, (n.source.y + n.source.height) / height };
+    for (int row = 0; row < 3; row++) {
+        if (row == 1 && !drawMiddle) continue;
+        for (int column = 0; column < 3; column++) {
+            if (column == 1 && !drawCenter) continue;
+            widget.background[widget.backgroundQuads++] =
+                MakeQuad(xs[column], ys[row], xs[column + 1], ys[row + 1], us[column], vs[row], us[column + 1], vs[row + 1]);
+        }
+    }
+}
+
+// Glyph quads at DrawText's positions (default font, spacing fontSize / 10, ASCII labels)
+static void BuildGlyphQuads(UiWidget& widget, Font font, float x, float y, int fontSize) {
+    widget.glyphs.clear();
+    float scale = (float)fontSize / (float)font.baseSize;
+    float spacing = (float)(fontSize / 10);
+    float padding = (float)font.glyphPadding;
+    float textureWidth = (float)font.texture.width;
+    float textureHeight = (float)font.texture.height;
+    float offsetX = 0.0f;
+    for (const char* c = widget.label; *c; c++) {
+        int index = GetGlyphIndex(font, (unsigned char)*c);
+        Rectangle rec = font.recs[index];
+        const GlyphInfo& glyph = font.glyphs[index];
+        if (*c != ' ' && *c != '\t') {
+            float x0 = x + offsetX + glyph.offsetX * scale - padding * scale;
+            float y0 = y + glyph.offsetY * scale - padding * scale;
+            widget.glyphs.push_back(MakeQuad(x0, y0, x0 + (rec.width + 2.0f * padding) * scale,
+                                             y0 + (rec.height + 2.0f * padding) * scale,
+                                             (rec.x - padding) / textureWidth, (rec.y - padding) / textureHeight,
+                                             (rec.x + rec.width + padding) / textureWidth,
+                                             (rec.y + rec.height + padding) / textureHeight));
+        }
+        offsetX += (glyph.advanceX == 0 ? rec.width : (float)glyph.advanceX) * scale + spacing;
+    }
+}
+
+static void BuildWidgetQuads(UiPanel& panel, UiWidget& widget, Font font) {
+    int fontSize = widget.fontSize < 10 ? 10 : widget.fontSize; // DrawText's minimum
+    float textWidth = (float)MeasureText(widget.label, fontSize);
+    if (widget.kind == UI_WIDGET_LABEL) {
+        widget.bounds.width = textWidth;
+        widget.bounds.height = (float)fontSize;
+        widget.backgroundQuads = 0;
+        BuildGlyphQuads(widget, font, widget.bounds.x, widget.bounds.y, fontSize);
+    } else {
+        BuildBackgroundQuads(widget, panel.texture, panel.nPatchInfo);
+        // Centered as DrawNButton does, on whole pixels like DrawText
+        float x = (float)(int)(widget.bounds.x + (widget.bounds.width - textWidth) / 2.0f);
+        float y = (float)(int)(widget.bounds.y + (widget.bounds.height - widget.fontSize) / 2.0f);
+        BuildGlyphQuads(widget, font, x, y, fontSize);
+    }
+    widget.dirty = false;
+}
+
+static void SubmitQuads(const UiQuad* quads, int count, unsigned int textureId, Color color) {
+    if (count == 0) return;
+    rlCheckRenderBatchLimit(4 * count);
+    rlSetTexture(textureId);
+    rlBegin(RL_QUADS);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < count; i++) {
+        const UiQuad& q = quads[i];
+        rlTexCoord2f(q.u0, q.v0); rlVertex2f(q.x0, q.y0);
+        rlTexCoord2f(q.u0, q.v1); rlVertex2f(q.x0, q.y1);
+        rlTexCoord2f(q.u1, q.v1); rlVertex2f(q.x1, q.y1);
+        rlTexCoord2f(q.u1, q.v0); rlVertex2f(q.x1, q.y0);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void DrawUiPanel(UiPanel& panel) {
+    Font font = GetFontDefault();
+    for (UiWidget& widget : panel.widgets) {
+        if (widget.visible && widget.dirty) BuildWidgetQuads(panel, widget, font);
+    }
+
+    // Backgrounds first: consecutive quads on one texture share a draw call
+    for (int i = 0; i < (int)panel.widgets.size(); i++) {
+        const UiWidget& widget = panel.widgets[i];
+        if (!widget.visible || widget.kind != UI_WIDGET_BUTTON) continue;
+        Color tint = widget.tintNormal;
+        if (i == panel.hovered) tint = panel.pressed ? widget.tintPressed : widget.tintHover;
+        if (panel.texture.id == 0) DrawRectangleRec(widget.bounds, tint); // Texture not uploaded yet
+        else SubmitQuads(widget.background, widget.backgroundQuads, panel.texture.id, tint);
+    }
+
+    // Then every label from the font atlas
+    for (const UiWidget& widget : panel.widgets) {
+        if (!widget.visible) continue;
+        SubmitQuads(widget.glyphs.data(), (int)widget.glyphs.size(), font.texture.id, widget.textColor);
+    }
+}
@@ -1,7 +1,28 @@
 #include "visualization_state.h"
-#include <cstdlib> // For rand(), srand()
+#include "quicksort.h"
+#include "sortingnetwork.h"
+#include "bubblesort.h"
+#include "oddevensort.h"
+#include "insertionsort.h"
+#include "shellsort.h"
+#include "powersort.h"
+#include "countingsort.h"
+#include "radixsort.h"
+#include "heapsort.h"
+#include "selection.h"
+#include "externalsort.h"
+#include "stringsort.h"
+#include "graph.h"
+#include "autoselect.h"
+#include "benchmark.h"
+#include "profiler.h"
+#include <cstdlib> // For rand(), srand(), getenv()
 #include <ctime>   // For time()
+#include <chrono>  // For timing full-speed runs
 #include <algorithm> // For std::swap, std::min/max if needed
+#include <cmath>     // For logf (access heatmap)
+#include <climits>   // For LLONG_MAX
+#include <cstring>   // For memcmp (control panel layout key)
 #include "raymath.h" // For Lerp
 
 // Constants for drawing
@@ -13,14 +34,62 @@ const Color BAR_HIGHLIGHT_SECONDARY = RED;     // j
 const Color BAR_HIGHLIGHT_TERTIARY = YELLOW;   // pivot / key
 const Color BAR_HIGHLIGHT_RANGE = BLUE;        // Range for quicksort partition
 const Color BAR_SORTED_COLOR = SKYBLUE;
+const int GRAPH_DRAW_EDGE_LIMIT = 40000; // Row entries; larger graphs are drawn as vertices only
+
+// rand() may only return 15 bits (RAND_MAX = 32767 on Windows), so combine two calls for large arrays
+static int RandomIndex(int n) {
+    long long r = (long long)rand() * ((long long)RAND_MAX + 1) + rand();
+    return (int)(r % n);
+}
+
+void GenerateArrayData(std::vector<int>& array, DataDistribution distribution) {
+    int n = (int)array.size();
+    if (n == 0) return;
+
+    switch (distribution) {
+        case DATA_NEARLY_SORTED:
+        case DATA_SORTED:
+        case DATA_REVERSED:
+            for (int i = 0; i < n; ++i) array[i] = 5 + (int)((long long)i * 100 / n);
+            if (distribution == DATA_REVERSED) std::reverse(array.begin(), array.end());
+            if (distribution == DATA_NEARLY_SORTED) {
+                int swapCount = std::max(1, n / 50);
+                for (int s = 0; s < swapCount; ++s) std::swap(array[RandomIndex(n)], array[RandomIndex(n)]);
+            }
+            break;
+        case DATA_SAWTOOTH: {
+            int runLength = std::max(2, n / 6);
+            for (int i = 0; i < n; ++i) array[i] = 5 + (int)((long long)(i % runLength) * 100 / runLength);
+            break;
+        }
+        case DATA_FEW_UNIQUE:
+            for (int i = 0; i < n; ++i) array[i] = 5 + 20 * (rand() % 5) + 19;
+            break;
+        case DATA_RANDOM:
+        default:
+            for (int i = 0; i < n; ++i) array[i] = rand() % 100 + 5; // Values from 5 to 104 (to ensure min height)
+            break;
+    }
+}
+
+const char* GetDistributionName(DataDistribution distribution) {
+    switch (distribution) {
+        case DATA_RANDOM: return "Random";
+        case DATA_NEARLY_SORTED: return "Nearly Sorted";
+        case DATA_SORTED: return "Sorted";
+        case DATA_REVERSED: return "Reversed";
+        case DATA_SAWTOOTH: return "Sawtooth";
+        case DATA_FEW_UNIQUE: return "Few Unique";
+        default: return "Unknown";
+    }
+}
 
 void InitializeVisualizationState(VisualizationState& state, int arraySize) {
     srand(time(NULL));
     state.size = arraySize;
     state.array.resize(state.size);
-    for (int i = 0; i < state.size; ++i) {
-        state.array[i] = rand() % 100 + 5; // Values from 5 to 104 (to ensure min height)
-    }
+    state.distribution = DATA_RANDOM;
+    GenerateArrayData(state.array, state.distribution);
     state.status = VIZ_STATE_IDLE;
     state.currentAlgorithm = ALGO_NONE;
     state.speed = 5.0f; // Default steps per second
@@ -33,15 +102,117 @@ void InitializeVisualizationState(VisualizationState& state, int arraySize) {
     state.tertiaryIndex = -1;
     state.highlightStart = -1;
     state.highlightEnd = -1;
-    state.quickSortStack.clear();
+    state.quickSortCurrent = { 0, -1, -1, -1 };
+    state.quickSortArena.clear();
+    state.quickSortDepth = 0;
+    state.quickSortMaxDepth = 0;
+    state.partitionKernel = ResolvePartitionKernel(PARTITION_AVX2);
+    state.useNetworkBaseCase = false;
+    state.networkLayers.clear();
+    state.networkLayerIndex = 0;
+    state.scratchBuffer.clear();
+    state.fullSpeedSeconds = -1.0;
+    state.fullSpeedCounters = {};
+    state.benchmarkResults.clear();
+    state.stepCount = 0;
+    state.comparisons = 0;
+    state.swaps = 0;
+    state.earlyExit = true;
+    state.swappedThisPass = false;
+    state.passDirection = 1;
+    state.passLow = 0;
+    state.passHigh = 0;
+    state.oddEvenPhase = 0;
+    state.quietPhases = 0;
+    state.bytesMoved = 0;
+    state.heldValue = 0;
+    state.gapSequence.clear();
+    state.gapIndex = -1;
+    state.runStack.clear();
+    state.activeRun = {0, 0, 0};
+    state.pendingRun = {0, 0, 0};
+    state.minRun = 0;
+    state.minGallop = POWERSORT_MIN_GALLOP;
+    state.sortPhase = 0;
+    state.counts.clear();
+    state.countMin = 0;
+    state.radixShift = 0;
+    state.radixMaxKey = 0;
+    state.countingFallback = false;
+    state.heapArity = HEAP_DEFAULT_ARITY;
+    state.heapPrefetch = true;
+    state.heapPath.clear();
+    state.selectFraction = 0.5f;
+    state.selectRank = 0;
+    state.selectLow = 0;
+    state.selectHigh = -1;
+    state.selectRounds = 0;
+    state.selectFallback = false;
+    state.selectFrames.clear();
+    state.autoSelect = false;
+    state.autoProfile = {};
+    state.autoReason = "";
+    state.stream.structure = STREAM_BTREE;
+    state.stream.arrivalRate = 10000;
+    state.stream.topK = state.size;
+    ResetStream(state.stream);
+    state.streamSegments.clear();
+    state.strings.bytes.clear();
+    state.strings.handles.clear();
+    state.stringKind = STRING_KEYS_WORDS;
+    state.stringRanges.clear();
+    state.stringScratch.clear();
+    state.stringDepth = 0;
+    state.externalSort.totalElements = 1 << 22;
+    state.externalSort.memoryCap = 1 << 16;
+    ReleaseExternalSort(state.externalSort);
+    state.graph.vertexCount = 0;
+    state.graphKind = GRAPH_GRID;
+    state.graphSource = 0;
+    state.bfsDirectionOptimizing = true;
+    state.dijkstraQueue = DIJKSTRA_RADIX_HEAP;
+    state.lookupMode = false;
+    state.searchLayouts.n = 0;
+    state.lookupLayout = SEARCH_BINARY;
+    state.lookupQuery = 0;
+    state.lookupCount = 0;
+    state.lookupProbes.clear();
+    state.lookupResults.clear();
+    state.memoryTrace = false;
+    state.eventStream = {};
+    state.eventStream.fd = -1;
+    InitCacheSimulator(state.cacheSim, 0);
+    state.accessCounts.assign(state.size, 0);
+}
+
+// --- Event Stream ---
+static void PublishStateEvent(VisualizationState& state, EventType type, int a, int b, int c) {
+    PublishEvent(state.eventStream, type, a, b, c, state.stepCount, state.comparisons, state.swaps);
+}
+
+// The bars as they are now; at most one copy per step, and steps are paced by the UI
+static void PublishArraySnapshot(VisualizationState& state) {
+    uint64_t sequence = PublishSnapshot(state.eventStream, state.array.data(), (int)state.array.size());
+    PublishStateEvent(state, EVENT_SNAPSHOT, (int)state.array.size(), 0, (int)sequence);
+}
+
+static void PublishReset(VisualizationState& state) {
+    PublishStateEvent(state, EVENT_RESET, state.size, (int)state.currentAlgorithm, 0);
+    PublishArraySnapshot(state);
+}
+
+void SetEventStreamEnabled(VisualizationState& state, bool enabled) {
+    if (!enabled) {
+        CloseEventStream(state.eventStream);
+        return;
+    }
+    if (OpenEventStream(state.eventStream, EVENT_STREAM_NAME)) PublishReset(state);
 }
 
 void ResetVisualizationState(VisualizationState& state) {
     // Regenerate array
     srand(time(NULL)); // Re-seed if desired, or keep sequence
-    for (int i = 0; i < state.size; ++i) {
-        state.array[i] = rand() % 100 + 5;
-    }
+    GenerateArrayData(state.array, state.distribution);
     state.status = VIZ_STATE_IDLE; // Ready to start again
     state.timeAccumulator = 0.0f;
     // Keep speed and stepMode settings
@@ -52,29 +223,225 @@ void ResetVisualizationState(VisualizationState& state) {
     state.tertiaryIndex = -1;
     state.highlightStart = -1;
     state.highlightEnd = -1;
-    state.quickSortStack.clear();
+    state.quickSortCurrent.stage = -1;
+    state.quickSortDepth = 0;
+    state.fullSpeedSeconds = -1.0;
+    state.fullSpeedCounters = {};
+    state.benchmarkResults.clear();
+    state.stepCount = 0;
+    state.comparisons = 0;
+    state.swaps = 0;
+    state.bytesMoved = 0;
+    state.swappedThisPass = false;
+    state.countingFallback = false;
+    state.lookupMode = false; // New data: the layouts are rebuilt when a lookup starts
+    state.lookupProbes.clear();
+    state.lookupResults.clear();
+    ResetCacheSimulator(state.cacheSim);
+    state.accessCounts.assign(state.size, 0);
+    if (state.currentAlgorithm != ALGO_EXTERNALSORT) ReleaseExternalSort(state.externalSort); // Closes the temp files
+
+    // Auto mode: profile the new data and pick the engine for it
+    if (state.currentAlgorithm == ALGO_AUTO) state.autoSelect = true;
+    if (state.autoSelect) {
+        state.autoProfile = ProfileInput(state.array);
+        state.currentAlgorithm = ChooseAlgorithm(state.autoProfile, state.size, &state.autoReason);
+    }
 
     // If an algorithm was selected, prepare it to start from beginning
     if (state.currentAlgorithm != ALGO_NONE) {
          state.status = VIZ_STATE_PAUSED; // Or IDLE, user presses play
         // Re-initialize specific algo state if needed (e.g., push initial Quicksort frame)
          if (state.currentAlgorithm == ALGO_QUICKSORT) {
-             state.quickSortStack.clear();
-             state.quickSortStack.push_back({0, state.size - 1, 0, -1});
+             PrepareQuickSort(state);
              state.highlightStart = 0;
              state.highlightEnd = state.size -1;
          } else if (state.currentAlgorithm == ALGO_BUBBLESORT) {
               state.primaryIndex = 0; // Ready for first step
               state.secondaryIndex = 0;
+         } else if (state.currentAlgorithm == ALGO_POWERSORT) {
+              state.runStack.clear();
+              state.activeRun = {0, 0, 0};
+              state.pendingRun = {0, 0, 0};
+              state.minRun = ComputeMinRun(state.size);
+              state.minGallop = POWERSORT_MIN_GALLOP;
+         } else if (state.currentAlgorithm == ALGO_QUICKSELECT || state.currentAlgorithm == ALGO_FLOYDRIVEST ||
+                    state.currentAlgorithm == ALGO_HEAPTOPK) {
+              state.selectRank = SelectionRank(state.selectFraction, state.size);
+              state.selectLow = 0;
+              state.selectHigh = state.size - 1;
+              state.selectRounds = 0;
+              state.selectFallback = false;
+              state.selectFrames.clear();
+              state.selectFrames.reserve(32); // Sample brackets shrink geometrically
+              state.selectFrames.push_back({ 0, state.size - 1, false });
+              state.sortPhase = 0;
+              state.primaryIndex = (state.selectRank + 1) / 2 - 1; // Heap top-k: last internal node
+              state.tertiaryIndex = state.selectRank;
+         } else if (IsStringAlgorithm(state.currentAlgorithm)) {
+              // The keys replace the int data; the bars show their leading bytes
+              GenerateStrings(state.strings, state.size, state.stringKind);
+              BuildStringView(state.strings, state.array);
+              state.stringScratch.resize(state.size);
+              state.stringRanges.clear();
+              state.stringRanges.push_back({ 0, state.size - 1, 0 });
+              state.stringDepth = 0;
+         } else if (IsGraphAlgorithm(state.currentAlgorithm)) {
+              // The graph replaces the bars: one vertex per element unless an edge list is loaded
+              if (state.graphKind != GRAPH_FILE || !LoadEdgeList(state.graph, getenv(GRAPH_FILE_VARIABLE))) {
+                  GenerateGraph(state.graph, state.graphKind == GRAPH_FILE ? GRAPH_RMAT : state.graphKind, state.size);
+              }
+              state.graphSource = PickGraphSource(state.graph);
+              if (state.currentAlgorithm == ALGO_BFS) {
+                  StartBfs(state.bfs, state.graph, state.graphSource, state.bfsDirectionOptimizing);
+              } else {
+                  StartDijkstra(state.dijkstra, state.graph, state.graphSource, state.dijkstraQueue);
+              }
+         } else if (state.currentAlgorithm == ALGO_EXTERNALSORT) {
+              // The data set only exists in the input file; the bars sample it
+              std::vector<int> data((size_t)state.externalSort.totalElements);
+              GenerateArrayData(data, state.distribution);
+              StartExternalSort(state.externalSort, data.data(), (long long)data.size(), &state.array);
+         } else if (state.currentAlgorithm == ALGO_STREAMING) {
+              // The bars show the structure's contents, which start empty; k follows the array size
+              state.stream.topK = state.size;
+              ResetStream(state.stream);
+              state.streamSegments.clear();
+              std::fill(state.array.begin(), state.array.end(), 0);
+         } else if (state.currentAlgorithm == ALGO_COUNTINGSORT || state.currentAlgorithm == ALGO_RADIXSORT) {
+              state.sortPhase = 0;
+              state.radixShift = 0;
+              state.counts.clear();
+         } else if (state.currentAlgorithm == ALGO_HEAPSORT) {
+              state.sortPhase = 0;
+              state.tertiaryIndex = (state.size > 1) ? (state.size - 2) / state.heapArity : -1; // Last internal node
+              state.heapPath.clear();
+              state.highlightStart = 0;
+              state.highlightEnd = state.size - 1;
+         } else if (state.currentAlgorithm == ALGO_COCKTAILSORT) {
+              state.passLow = 0;
+              state.passHigh = state.size - 1;
+              state.passDirection = 1;
+              state.secondaryIndex = 0;
+         } else if (state.currentAlgorithm == ALGO_ODDEVENTRANSPOSITION) {
+              state.oddEvenPhase = 0;
+              state.quietPhases = 0;
          } else if (state.currentAlgorithm == ALGO_INSERTIONSORT) {
               state.primaryIndex = 1; // Ready for first step
               state.secondaryIndex = -2; // Signal key prep needed
               state.highlightStart = 0;
               state.highlightEnd = 0;
+         } else if (state.currentAlgorithm == ALGO_BINARYINSERTIONSORT) {
+              state.primaryIndex = 1;
+              state.highlightStart = 0;
+              state.highlightEnd = 0;
+         } else if (state.currentAlgorithm == ALGO_SHELLSORT) {
+              BuildShellGaps(state.size, state.gapSequence);
+              state.gapIndex = (int)state.gapSequence.size() - 1;
+              state.primaryIndex = state.gapSequence[state.gapIndex];
+              state.secondaryIndex = -2;
+         } else if (state.currentAlgorithm == ALGO_BITONICSORT || state.currentAlgorithm == ALGO_ODDEVENMERGESORT) {
+              SortingNetworkKind kind = (state.currentAlgorithm == ALGO_BITONICSORT) ? NETWORK_BITONIC : NETWORK_ODDEVEN_MERGE;
+              BuildSortingNetwork(kind, state.size, state.networkLayers);
+              state.networkLayerIndex = 0;
          }
     }
+    if (state.eventStream.active) PublishReset(state);
 }
 
+void ResizeVisualizationState(VisualizationState& state, int arraySize) {
+    state.size = arraySize;
+    state.array.resize(state.size);
+    state.scratchBuffer.clear();
+    state.scratchBuffer.shrink_to_fit();
+    ResetVisualizationState(state);
+}
+
+static bool DispatchStep(VisualizationState& state) {
+    if (state.lookupMode) return StepLookup(state); // Lookup phase after the sort
+    switch (state.currentAlgorithm) {
+        case ALGO_QUICKSORT: return StepQuickSort(state);
+        case ALGO_BUBBLESORT: return StepBubbleSort(state);
+        case ALGO_INSERTIONSORT: return StepInsertionSort(state);
+        case ALGO_BITONICSORT:
+        case ALGO_ODDEVENMERGESORT: return StepSortingNetwork(state);
+        case ALGO_ODDEVENTRANSPOSITION: return StepOddEvenTranspositionSort(state);
+        case ALGO_COCKTAILSORT: return StepCocktailSort(state);
+        case ALGO_BINARYINSERTIONSORT: return StepBinaryInsertionSort(state);
+        case ALGO_SHELLSORT: return StepShellSort(state);
+        case ALGO_POWERSORT: return StepPowersort(state);
+        case ALGO_COUNTINGSORT: return StepCountingSort(state);
+        case ALGO_RADIXSORT: return StepRadixSort(state);
+        case ALGO_HEAPSORT: return StepHeapSort(state);
+        case ALGO_QUICKSELECT: return StepQuickSelect(state);
+        case ALGO_FLOYDRIVEST: return StepFloydRivest(state);
+        case ALGO_HEAPTOPK: return StepHeapTopK(state);
+        case ALGO_STREAMING: return StepStreamIngest(state);
+        case ALGO_EXTERNALSORT: return StepExternalSort(state);
+        case ALGO_MULTIKEYQUICKSORT: return StepMultikeyQuicksort(state);
+        case ALGO_MSDRADIXSORT: return StepMsdRadixSort(state);
+        case ALGO_BFS: return StepBfs(state);
+        case ALGO_DIJKSTRA: return StepDijkstra(state);
+        // Add cases for other algorithms
+        default: return false;
+    }
+}
+
+bool StepAlgorithm(VisualizationState& state) {
+    state.stepCount++;
+    bool running = DispatchStep(state);
+    if (state.eventStream.active) {
+        PublishStateEvent(state, EVENT_STEP, state.primaryIndex, state.secondaryIndex, state.tertiaryIndex);
+        PublishArraySnapshot(state);
+        if (!running) PublishStateEvent(state, EVENT_FINISHED, 1, 0, 0);
+    }
+    return running;
+}
+
+const char* GetAlgorithmName(AlgorithmType algorithm) {
+    switch (algorithm) {
+        case ALGO_QUICKSORT: return "Quicksort";
+        case ALGO_BUBBLESORT: return "Bubble Sort";
+        case ALGO_INSERTIONSORT: return "Insertion Sort";
+        case ALGO_BITONICSORT: return "Bitonic Network";
+        case ALGO_ODDEVENMERGESORT: return "Odd-Even Merge Network";
+        case ALGO_ODDEVENTRANSPOSITION: return "Odd-Even Transposition";
+        case ALGO_COCKTAILSORT: return "Cocktail Shaker Sort";
+        case ALGO_BINARYINSERTIONSORT: return "Binary Insertion Sort";
+        case ALGO_SHELLSORT: return "Shell Sort";
+        case ALGO_POWERSORT: return "Powersort";
+        case ALGO_COUNTINGSORT: return "Counting Sort";
+        case ALGO_RADIXSORT: return "LSD Radix Sort";
+        case ALGO_HEAPSORT: return "Heapsort";
+        case ALGO_QUICKSELECT: return "Quickselect";
+        case ALGO_FLOYDRIVEST: return "Floyd-Rivest";
+        case ALGO_HEAPTOPK: return "Heap Top-k";
+        case ALGO_STREAMING: return "Streaming Ingest";
+        case ALGO_EXTERNALSORT: return "External Merge Sort";
+        case ALGO_MULTIKEYQUICKSORT: return "Multikey Quicksort";
+        case ALGO_MSDRADIXSORT: return "MSD Radix (Strings)";
+        case ALGO_BFS: return "BFS";
+        case ALGO_DIJKSTRA: return "Dijkstra";
+        case ALGO_AUTO: return "Auto";
+        default: return "Select Algorithm";
+    }
+}
+
+
+// --- Memory Tracing ---
+
+void RecordMemoryAccess(VisualizationState& state, MemoryRegion region, int index, bool isWrite) {
+    if (state.eventStream.active) PublishStateEvent(state, isWrite ? EVENT_WRITE : EVENT_READ, index, (int)region, 0);
+    if (!state.memoryTrace) return;
+    SimulateCacheAccess(state.cacheSim, region, index, isWrite);
+    if (region == MEM_REGION_ARRAY && index >= 0 && index < (int)state.accessCounts.size()) {
+        state.accessCounts[index]++;
+    }
+}
+
+void RecordMemoryRange(VisualizationState& state, MemoryRegion region, int begin, int end, bool isWrite) {
+    for (int i = begin; i < end; i++) RecordMemoryAccess(state, region, i, isWrite);
+}
 
 void UpdateVisualization(VisualizationState& state, float deltaTime) {
     if (state.status != VIZ_STATE_SORTING || state.currentAlgorithm == ALGO_NONE) {
@@ -88,25 +455,12 @@ void UpdateVisualization(VisualizationState& state, float deltaTime) {
     state.timeAccumulator += deltaTime;
     float timePerStep = 1.0f / state.speed;
 
+    PROFILE_ZONE("Step batch");
     bool stillRunning = true;
     while (state.timeAccumulator >= timePerStep && stillRunning && state.status == VIZ_STATE_SORTING) {
         state.timeAccumulator -= timePerStep;
 
-        switch (state.currentAlgorithm) {
-            case ALGO_QUICKSORT:
-                stillRunning = StepQuickSort(state);
-                break;
-            case ALGO_BUBBLESORT:
-                stillRunning = StepBubbleSort(state);
-                break;
-            case ALGO_INSERTIONSORT:
-                stillRunning = StepInsertionSort(state);
-                break;
-            // Add cases for other algorithms
-            default:
-                stillRunning = false;
-                break;
-        }
+        stillRunning = StepAlgorithm(state);
          if (!stillRunning) {
              state.status = VIZ_STATE_FINISHED;
              // Clear highlights maybe? Or leave final state shown
@@ -123,9 +477,644 @@ void UpdateVisualization(VisualizationState& state, float deltaTime) {
      }
 }
 
+bool RunFullSpeedEngine(AlgorithmType algorithm, const VisualizationState& options, std::vector<int>& array,
+                        long long* comparisons, long long* bytesMoved) {
+    switch (algorithm) {
+        case ALGO_QUICKSORT:
+            QuickSortFull(array, options.partitionKernel);
+            break;
+        case ALGO_BITONICSORT:
+            SortingNetworkFull(array, NETWORK_BITONIC);
+            break;
+        case ALGO_ODDEVENMERGESORT:
+            SortingNetworkFull(array, NETWORK_ODDEVEN_MERGE);
+            break;
+        case ALGO_BUBBLESORT:
+            BubbleSortFull(array, options.earlyExit);
+            break;
+        case ALGO_COCKTAILSORT:
+            CocktailSortFull(array, options.earlyExit);
+            break;
+        case ALGO_ODDEVENTRANSPOSITION:
+            OddEvenTranspositionSortFull(array, options.earlyExit);
+            break;
+        case ALGO_INSERTIONSORT:
+            InsertionSortFull(array, comparisons, bytesMoved);
+            break;
+        case ALGO_BINARYINSERTIONSORT:
+            BinaryInsertionSortFull(array, comparisons, bytesMoved);
+            break;
+        case ALGO_SHELLSORT:
+            ShellSortFull(array, comparisons, bytesMoved);
+            break;
+        case ALGO_POWERSORT:
+            PowersortFull(array, comparisons, bytesMoved);
+            break;
+        case ALGO_COUNTINGSORT:
+            if (!CountingSortFull(array, bytesMoved)) RadixSortFull(array, bytesMoved);
+            break;
+        case ALGO_RADIXSORT:
+            RadixSortFull(array, bytesMoved);
+            break;
+        case ALGO_HEAPSORT:
+            HeapSortFull(array, options.heapArity, options.heapPrefetch, comparisons, bytesMoved);
+            break;
+        case ALGO_QUICKSELECT:
+            QuickSelectFull(array, SelectionRank(options.selectFraction, (int)array.size()), comparisons);
+            break;
+        case ALGO_FLOYDRIVEST:
+            FloydRivestFull(array, SelectionRank(options.selectFraction, (int)array.size()), comparisons);
+            break;
+        case ALGO_HEAPTOPK:
+            HeapTopKFull(array, SelectionRank(options.selectFraction, (int)array.size()), comparisons);
+            break;
+        case ALGO_EXTERNALSORT:
+            if (!ExternalSortFull(array, options.externalSort.memoryCap, bytesMoved)) return false; // I/O failed (logged)
+            break;
+        default:
+            return false; // No full-speed engine for this algorithm
+    }
+    return true;
+}
+
+bool RunAlgorithmFullSpeed(VisualizationState& state) {
+    PROFILE_ZONE("Full-speed engine");
+    PerfCounterSet counters;
+    OpenPerfCounters(counters);
+    StartPerfCounters(counters);
+    auto start = std::chrono::steady_clock::now();
+
+    bool ran;
+    if (state.lookupMode) {
+        ran = false; // Lookups are timed by RunLookupBenchmark
+    } else if (state.currentAlgorithm == ALGO_EXTERNALSORT) {
+        // The data set is the job's input file, not the bars: finish the job in place
+        AdvanceExternalSort(state.externalSort, LLONG_MAX, &state.array);
+        state.bytesMoved = state.externalSort.bytesRead + state.externalSort.bytesWritten;
+        ran = true;
+    } else if (IsGraphAlgorithm(state.currentAlgorithm)) {
+        // Finish the search in progress on the current graph
+        if (state.currentAlgorithm == ALGO_BFS) {
+            while (BfsLevel(state.bfs, state.graph, &state.comparisons)) {}
+        } else {
+            while (DijkstraSettleNext(state.dijkstra, state.graph, &state.comparisons)) {}
+        }
+        ran = true;
+    } else if (IsStringAlgorithm(state.currentAlgorithm)) {
+        // String engines sort the arena; the bars follow afterwards
+        if (state.currentAlgorithm == ALGO_MSDRADIXSORT) MsdRadixSortFull(state.strings, &state.comparisons, &state.bytesMoved);
+        else MultikeyQuicksortFull(state.strings, &state.comparisons);
+        state.stringRanges.clear();
+        ran = true;
+    } else {
+        ran = RunFullSpeedEngine(state.currentAlgorithm, state, state.array, &state.comparisons, &state.bytesMoved);
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    StopPerfCounters(counters, state.fullSpeedCounters);
+    ClosePerfCounters(counters);
+    if (!ran) return false; // No full-speed engine for this algorithm
+    if (IsStringAlgorithm(state.currentAlgorithm)) BuildStringView(state.strings, state.array);
+    state.fullSpeedSeconds = elapsed.count();
+
+    state.status = VIZ_STATE_FINISHED;
+    state.primaryIndex = -1;
+    state.secondaryIndex = -1;
+    state.tertiaryIndex = -1;
+    state.highlightStart = -1;
+    state.highlightEnd = -1;
+    state.quickSortCurrent.stage = -1;
+    state.quickSortDepth = 0;
+    if (state.eventStream.active) {
+        PublishArraySnapshot(state);
+        PublishStateEvent(state, EVENT_FINISHED, 0, 0, 0);
+    }
+    return true;
+}
+
+// Powersort: runs as colored bands under the bars, and the merge stack as a list
+static void DrawRunsAndMergeStack(const VisualizationState& state, float startX, float startY, float barWidth, Rectangle bounds) {
+    static const Color runColors[] = { ORANGE, PURPLE, LIME, PINK, GOLD, VIOLET };
+    const int runColorCount = sizeof(runColors) / sizeof(runColors[0]);
+    float bandY = startY + 4;
+    float bandHeight = BAR_AREA_PADDING - 8;
+
+    for (int r = 0; r < (int)state.runStack.size(); r++) {
+        const VisualizationState::SortedRun& run = state.runStack[r];
+        DrawRectangleRec({ startX + run.start * barWidth, bandY, run.length * barWidth, bandHeight }, runColors[r % runColorCount]);
+    }
+    const VisualizationState::SortedRun& a = state.activeRun;
+    if (a.length > 0) DrawRectangleRec({ startX + a.start * barWidth, bandY, a.length * barWidth, bandHeight }, WHITE);
+    const VisualizationState::SortedRun& b = state.pendingRun;
+    if (b.length > 0) DrawRectangleRec({ startX + b.start * barWidth, bandY, b.length * barWidth, bandHeight }, GRAY);
+
+    // Merge stack, bottom entry first
+    int textX = (int)startX;
+    int textY = (int)bounds.y + 5;
+    DrawText(TextFormat("Min run %d, min gallop %d   Merge stack:", state.minRun, state.minGallop), textX, textY, 20, LIGHTGRAY);
+    textY += 24;
+    for (int r = 0; r < (int)state.runStack.size(); r++) {
+        const VisualizationState::SortedRun& run = state.runStack[r];
+        DrawText(TextFormat("[%d..%d) power %d", run.start, run.start + run.length, run.power), textX, textY, 10, runColors[r % runColorCount]);
+        textY += 12;
+    }
+    if (a.length > 0) DrawText(TextFormat("A [%d..%d)", a.start, a.start + a.length), textX, textY, 10, WHITE);
+    if (b.length > 0) DrawText(TextFormat("B [%d..%d) power %d", b.start, b.start + b.length, b.power), textX + 120, textY, 10, GRAY);
+}
+
+// Counting sort: histogram of the counters. Radix sort: the output buffer being filled.
+// Both are drawn as a strip across the top of the panel.
+static void DrawBucketStrip(const VisualizationState& state, float startX, float panelWidth, Rectangle bounds) {
+    float stripTop = bounds.y + 30;
+    float stripHeight = 60;
+
+    bool radix = state.currentAlgorithm == ALGO_RADIXSORT || state.countingFallback;
+    if (!radix && !state.counts.empty()) {
+        int maxCount = 1;
+        for (int c : state.counts) maxCount = std::max(maxCount, c);
+        float bucketWidth = panelWidth / state.counts.size();
+        for (int b = 0; b < (int)state.counts.size(); b++) {
+            float h = stripHeight * state.counts[b] / maxCount;
+            DrawRectangleRec({ startX + b * bucketWidth, stripTop + stripHeight - h, std::max(1.0f, bucketWidth - 1), h }, ORANGE);
+        }
+        DrawText(state.sortPhase == 1 ? "Counting" : "Writing buckets back", (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    } else if (radix && state.sortPhase == 1 && !state.scratchBuffer.empty()) {
+        float slotWidth = panelWidth / state.size;
+        for (int i = 0; i < state.primaryIndex && i < state.size; i++) {
+            float h = stripHeight * state.scratchBuffer[i] / 105.0f;
+            DrawRectangleRec({ startX + i * slotWidth, stripTop + stripHeight - h, std::max(1.0f, slotWidth - 1), h }, ORANGE);
+        }
+        DrawText(TextFormat("Digit bits %d..%d: scattering into buckets", state.radixShift, state.radixShift + RADIX_VIZ_BITS - 1),
+                 (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    }
+}
+
+// Heapsort: the top levels of the heap as a tree across the top of the panel, with the
+// path of the last sift in orange (levels wider than HEAP_TREE_DRAW_LEVEL_NODES are left out)
+static void DrawHeapTree(const VisualizationState& state, float startX, float panelWidth, float panelHeight, Rectangle bounds) {
+    int d = state.heapArity;
+    int heapSize = (state.sortPhase == 1) ? state.secondaryIndex + 1 : state.size;
+    const char* phase = (state.sortPhase == 0) ? "building" : "extracting";
+    DrawText(TextFormat("%d-ary heap of %d, %s", d, heapSize, phase), (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    if (heapSize <= 0) return;
+
+    int levels = 0;
+    for (long long first = 0, width = 1; first < heapSize && width <= HEAP_TREE_DRAW_LEVEL_NODES; first += width, width *= d) levels++;
+    float treeTop = bounds.y + 40;
+    float levelHeight = std::min(40.0f, panelHeight * 0.4f / levels);
+    std::vector<bool> onPath(heapSize, false);
+    for (int node : state.heapPath) {
+        if (node < heapSize) onPath[node] = true;
+    }
+
+    // Node i sits at level L, slot i - first(L), of d^L evenly spaced slots
+    auto nodePosition = [&](int level, int first, int width, int node) {
+        return Vector2{ startX + (node - first + 0.5f) * panelWidth / width, treeTop + level * levelHeight };
+    };
+    int first = 0;
+    int width = 1;
+    for (int level = 0; level < levels; level++) {
+        int childFirst = first + width;
+        for (int node = first; node < first + width && node < heapSize; node++) {
+            Vector2 position = nodePosition(level, first, width, node);
+            if (level + 1 < levels) {
+                for (int c = d * node + 1; c <= d * node + d && c < heapSize; c++) {
+                    Color edge = (onPath[node] && onPath[c]) ? ORANGE : DARKGRAY;
+                    DrawLineV(position, nodePosition(level + 1, childFirst, width * d, c), edge);
+                }
+            }
+            DrawCircleV(position, 3, onPath[node] ? ORANGE : LIGHTGRAY);
+            if (width <= 16) {
+                DrawText(TextFormat("%d", state.array[node]), (int)position.x + 5, (int)position.y - 12, 10, WHITE);
+            }
+        }
+        first = childFirst;
+        width *= d;
+    }
+}
+
+// Auto mode: the sampled statistics and the resulting decision, top right
+static void DrawAutoProfile(const VisualizationState& state, Rectangle bounds) {
+    const InputProfile& p = state.autoProfile;
+    int x = (int)(bounds.x + bounds.width - 330);
+    int y = (int)bounds.y + 5;
+    DrawRectangle(x - 5, y - 2, 325, 98, { 0, 0, 0, 160 });
+    DrawText(TextFormat("Auto -> %s", GetAlgorithmName(state.currentAlgorithm)), x, y, 20, YELLOW);
+    DrawText(state.autoReason, x, y + 24, 10, WHITE);
+    DrawText(TextFormat("Sample %d   Range %lld (%d..%d)", p.sampleSize, p.range, p.minValue, p.maxValue), x, y + 40, 10, LIGHTGRAY);
+    DrawText(TextFormat("Duplicates %.0f%%   Sorted pairs %.0f%%", p.duplicateRatio * 100.0f, p.sortedness * 100.0f), x, y + 54, 10, LIGHTGRAY);
+    DrawText(TextFormat("Descending pairs %.0f%%   Est. runs %lld", p.reversedness * 100.0f, p.estimatedRuns), x, y + 68, 10, LIGHTGRAY);
+}
+
+// Memory tracing: per-level hits and misses of the simulated hierarchy, top right
+static void DrawCacheStats(const VisualizationState& state, Rectangle bounds) {
+    const CacheSimulator& sim = state.cacheSim;
+    int x = (int)(bounds.x + bounds.width - 330);
+    int y = (int)bounds.y + 5 + (state.autoSelect ? 105 : 0);
+    DrawRectangle(x - 5, y - 2, 325, 30 + 14 * sim.levelCount, { 0, 0, 0, 160 });
+    DrawText(TextFormat("Cache: %s", GetCachePreset(sim.presetIndex).name), x, y, 10, YELLOW);
+    DrawText(TextFormat("%lld accesses (%lld reads, %lld writes)", sim.accesses, sim.reads, sim.writes), x, y + 14, 10, LIGHTGRAY);
+    for (int l = 0; l < sim.levelCount; l++) {
+        const CacheLevel& level = sim.levels[l];
+        long long total = level.hits + level.misses;
+        float missRate = total > 0 ? 100.0f * (float)level.misses / (float)total : 0.0f;
+        DrawText(TextFormat("%s %dK %d-way: %lld misses (%.1f%%)", level.config.name, level.config.sizeBytes / 1024,
+                            level.config.ways, level.misses, missRate),
+                 x, y + 28 + 14 * l, 10, WHITE);
+    }
+}
+
+// Memory tracing: how often each index was touched, drawn as columns behind the bars.
+// Indices are binned to screen columns and the scale is logarithmic so hot spots do
+// not wash out everything else.
+static void DrawAccessHeatmap(const VisualizationState& state, float startX, float startY, float panelWidth, float panelHeight) {
+    if (state.accessCounts.empty()) return;
+    int columns = std::min(state.size, std::max(1, (int)panelWidth));
+    std::vector<unsigned long long> binned(columns, 0);
+    unsigned long long maxCount = 0;
+    for (int i = 0; i < state.size; i++) {
+        unsigned long long& bin = binned[(long long)i * columns / state.size];
+        bin += state.accessCounts[i];
+        maxCount = std::max(maxCount, bin);
+    }
+    if (maxCount == 0) return;
+
+    float columnWidth = panelWidth / columns;
+    float logMax = logf((float)maxCount + 1.0f);
+    for (int c = 0; c < columns; c++) {
+        if (binned[c] == 0) continue;
+        float heat = logf((float)binned[c] + 1.0f) / logMax;
+        Color cold = { 40, 40, 160, 90 };
+        Color hot = { 255, 60, 0, 140 };
+        Color color = {
+            (unsigned char)Lerp(cold.r, hot.r, heat),
+            (unsigned char)Lerp(cold.g, hot.g, heat),
+            (unsigned char)Lerp(cold.b, hot.b, heat),
+            (unsigned char)Lerp(cold.a, hot.a, heat)
+        };
+        DrawRectangleRec({ startX + c * columnWidth, startY - panelHeight, columnWidth, panelHeight }, color);
+    }
+}
+
+// Quicksort: deferred ranges as bands under the bars (darker = deeper), and the
+// arena as a row of slots filled up to the current depth
+static void DrawQuickSortStack(const VisualizationState& state, float startX, float startY, float barWidth, Rectangle bounds) {
+    int capacity = (int)state.quickSortArena.size();
+    float bandY = startY + 4;
+    float bandHeight = BAR_AREA_PADDING - 8;
+    for (int d = 0; d < state.quickSortDepth; d++) {
+        const VisualizationState::QuickSortStackFrame& frame = state.quickSortArena[d];
+        unsigned char shade = (unsigned char)(230 - 150 * d / std::max(1, capacity - 1));
+        DrawRectangleRec({ startX + frame.low * barWidth, bandY, (frame.high - frame.low + 1) * barWidth, bandHeight },
+                         { shade, (unsigned char)(shade / 2), 255, 255 });
+    }
+
+    int textX = (int)startX;
+    int textY = (int)bounds.y + 5;
+    const char* label = TextFormat("Stack %d / %d  (max %d, %d bytes)", state.quickSortDepth, capacity, state.quickSortMaxDepth,
+                                   capacity * (int)sizeof(VisualizationState::QuickSortStackFrame));
+    DrawText(label, textX, textY, 20, LIGHTGRAY);
+    int slotX = textX + MeasureText(label, 20) + 15;
+    for (int d = 0; d < capacity; d++) {
+        Rectangle slot = { (float)slotX + d * 14, (float)textY + 3, 12, 14 };
+        if (d < state.quickSortDepth) DrawRectangleRec(slot, VIOLET);
+        else if (d < state.quickSortMaxDepth) DrawRectangleRec(slot, { 90, 60, 110, 255 }); // Reached earlier
+        DrawRectangleLinesEx(slot, 1, LIGHTGRAY);
+    }
+}
+
+// Streaming: LSM segments as bands under the bars, and the ingest statistics with
+// one row per checkpoint (every doubling of the stream), top right
+static void DrawStreamStats(const VisualizationState& state, float startX, float startY, float barWidth, Rectangle bounds) {
+    static const Color levelColors[] = { ORANGE, GOLD, LIME, SKYBLUE, VIOLET, PINK };
+    const int levelColorCount = sizeof(levelColors) / sizeof(levelColors[0]);
+    for (const StreamSegment& segment : state.streamSegments) {
+        Color color = (segment.level < 0) ? WHITE : levelColors[segment.level % levelColorCount];
+        DrawRectangleRec({ startX + segment.start * barWidth, startY + 4, segment.length * barWidth - 1, BAR_AREA_PADDING - 8 }, color);
+    }
+
+    const StreamIngest& stream = state.stream;
+    const char* shape = "";
+    if (stream.structure == STREAM_TOPK_HEAP) shape = TextFormat("k = %d, kept %d", stream.topK, (int)stream.heap.size());
+    else if (stream.structure == STREAM_BTREE) shape = TextFormat("height %d, %d nodes", stream.height, (int)stream.nodes.size());
+    else shape = TextFormat("%d runs, %lld compactions", (int)stream.runs.size(), stream.compactions);
+    DrawText(TextFormat("%s: %lld elements (%s)", GetStreamStructureName(stream.structure), stream.count, shape),
+             (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+
+    int x = (int)(bounds.x + bounds.width - 330);
+    int y = (int)bounds.y + 5;
+    int rows = (int)stream.checkpoints.size();
+    DrawRectangle(x - 5, y - 2, 325, 46 + 12 * rows, { 0, 0, 0, 160 });
+    DrawText(TextFormat("Arrivals %d/s   Ingest p50 %.0f  p99 %.0f  p99.9 %.0f ns", stream.arrivalRate,
+                        stream.p50Ns, stream.p99Ns, stream.p999Ns), x, y, 10, YELLOW);
+    double seconds = ProfilerTicksToMs(stream.ingestTicks) / 1000.0;
+    DrawText(TextFormat("Capacity %.2f M elements/s (CPU time)", seconds > 0.0 ? stream.count / seconds / 1e6 : 0.0), x, y + 14, 10, WHITE);
+    DrawText("Elements      p50 ns    p99 ns   p99.9 ns     M/s", x, y + 30, 10, LIGHTGRAY);
+    for (int r = 0; r < rows; r++) {
+        const StreamCheckpoint& c = stream.checkpoints[r];
+        DrawText(TextFormat("%8lld %9.0f %9.0f %10.0f %9.2f", c.count, c.p50Ns, c.p99Ns, c.p999Ns, c.elementsPerSecond / 1e6),
+                 x, y + 42 + 12 * r, 10, WHITE);
+    }
+}
+
+// Selection engines: outline the bar at rank k and describe the window still holding it
+static void DrawSelectionTarget(const VisualizationState& state, float startX, float startY, float barWidth,
+                                float panelHeight, Rectangle bounds) {
+    int k = state.selectRank;
+    if (k < 0 || k >= state.size) return;
+    Rectangle column = { startX + k * barWidth - 1, startY - panelHeight, std::max(3.0f, barWidth + 1), panelHeight };
+    DrawRectangleLinesEx(column, 1, YELLOW);
+    DrawRectangleRec({ column.x, startY + 4, column.width, BAR_AREA_PADDING - 8 }, YELLOW);
+
+    const char* progress = "";
+    if (state.status == VIZ_STATE_FINISHED) {
+        progress = TextFormat("rank %d holds %d", k, state.array[k]);
+    } else if (state.currentAlgorithm == ALGO_QUICKSELECT) {
+        progress = TextFormat("window [%d..%d], round %d%s", state.selectLow, state.selectHigh, state.selectRounds,
+                              state.selectFallback ? " (median of medians)" : "");
+    } else if (state.currentAlgorithm == ALGO_FLOYDRIVEST && !state.selectFrames.empty()) {
+        const VisualizationState::SelectFrame& frame = state.selectFrames.back();
+        progress = TextFormat("window [%d..%d], sample depth %d", frame.low, frame.high, (int)state.selectFrames.size() - 1);
+    } else if (state.currentAlgorithm == ALGO_HEAPTOPK) {
+        static const char* phases[] = { "heapify", "scan", "sort heap" };
+        progress = TextFormat("heap of %d, %s", k + 1, phases[std::min(state.sortPhase, 2)]);
+    }
+    DrawText(TextFormat("k = %d (%.1f%%): %s", k, state.selectFraction * 100.0f, progress),
+             (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+}
+
+// External merge sort: runs of the file as bands under the bars (during a merge the
+// source runs on top and the merged runs below), and the I/O cost box, top right
+static void DrawExternalSortProgress(const VisualizationState& state, float startX, float startY, float barWidth, Rectangle bounds) {
+    static const Color runColors[] = { ORANGE, GOLD, LIME, SKYBLUE, VIOLET, PINK };
+    const int runColorCount = sizeof(runColors) / sizeof(runColors[0]);
+    const ExternalSortJob& job = state.externalSort;
+    double barsPerElement = (double)barWidth / std::max<long long>(1, job.totalElements / state.size);
+    float bandHeight = BAR_AREA_PADDING - 8;
+
+    bool merging = (job.phase == EXTSORT_MERGING);
+    const std::vector<ExternalRun>& formed = merging ? job.runs : job.nextRuns;
+    for (int r = 0; r < (int)formed.size(); r++) {
+        Color color = runColors[r % runColorCount];
+        if (merging && (r < job.groupStart || r >= job.groupStart + job.groupSize)) color = Fade(color, 0.4f);
+        DrawRectangleRec({ startX + (float)(formed[r].start * barsPerElement), startY + 4,
+                           std::max(1.0f, (float)(formed[r].length * barsPerElement)), merging ? bandHeight / 2 : bandHeight }, color);
+    }
+    if (merging) {
+        for (int r = 0; r < (int)job.nextRuns.size(); r++) {
+            DrawRectangleRec({ startX + (float)(job.nextRuns[r].start * barsPerElement), startY + 4 + bandHeight / 2,
+                               std::max(1.0f, (float)(job.nextRuns[r].length * barsPerElement)), bandHeight / 2 }, WHITE);
+        }
+    }
+
+    // Merge passes predicted from the run count (estimated at twice the heap until formation ends)
+    int fanout = std::max(2, job.fanout);
+    long long runs = job.initialRuns > 0 ? job.initialRuns
+                                         : (job.totalElements + 2LL * job.heapCapacity - 1) / std::max(1, 2 * job.heapCapacity);
+    int mergePasses = 0;
+    for (long long r = runs; r > 1; r = (r + fanout - 1) / fanout) mergePasses++;
+
+    const char* progress = "";
+    if (job.phase == EXTSORT_FILLING) progress = TextFormat("heap %d / %d", job.heapSize, job.heapCapacity);
+    else if (job.phase == EXTSORT_FORMING) progress = TextFormat("run %d, heap %d", (int)job.nextRuns.size(), job.heapSize);
+    else if (merging) progress = TextFormat("pass %d of %d, runs %d-%d of %d", job.pass, mergePasses, job.groupStart + 1,
+                                            job.groupStart + job.groupSize, (int)job.runs.size());
+    else if (job.phase == EXTSORT_DONE) progress = TextFormat("%d runs, %d merge pass%s", job.initialRuns, job.pass - 1, job.pass == 2 ? "" : "es");
+    else if (job.phase == EXTSORT_FAILED) progress = job.error;
+    DrawText(TextFormat("%s: %s", GetExternalSortPhaseName(job.phase), progress), (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+
+    int x = (int)(bounds.x + bounds.width - 330);
+    int y = (int)bounds.y + 5;
+    double megabytes = job.totalElements * sizeof(int) / 1048576.0;
+    double busyMs = ProfilerTicksToMs(job.busyTicks);
+    double waitMs = ProfilerTicksToMs(job.ioWaitTicks);
+    double movedMb = (job.bytesRead + job.bytesWritten) / 1048576.0;
+    DrawRectangle(x - 5, y - 2, 325, 86, { 0, 0, 0, 160 });
+    DrawText(TextFormat("File %.1f MB, memory %d KB, fanout %d", megabytes, (int)(job.memoryCap * sizeof(int) / 1024), fanout),
+             x, y, 10, YELLOW);
+    DrawText(TextFormat("Runs %lld%s (%.2fx memory each)", runs, job.initialRuns > 0 ? "" : " expected",
+                        runs > 0 ? (double)job.totalElements / runs / std::max(1, job.memoryCap) : 0.0), x, y + 14, 10, WHITE);
+    DrawText(TextFormat("Read %.1f MB  written %.1f MB  (model %.1f MB)", job.bytesRead / 1048576.0, job.bytesWritten / 1048576.0,
+                        2.0 * megabytes * (1 + mergePasses)), x, y + 28, 10, WHITE);
+    DrawText(TextFormat("CPU %.1f ms, waiting on I/O %.1f ms (%.0f%%)", busyMs - waitMs, waitMs,
+                        busyMs > 0.0 ? 100.0 * waitMs / busyMs : 0.0), x, y + 42, 10, WHITE);
+    DrawText(TextFormat("Throughput %.1f MB/s moved", busyMs > 0.0 ? movedMb * 1000.0 / busyMs : 0.0), x, y + 56, 10, WHITE);
+    DrawText(TextFormat("Block %d KB, two buffers per stream", (int)(EXTSORT_BLOCK_ELEMENTS * sizeof(int) / 1024)), x, y + 70, 10, GRAY);
+}
+
+// String sorting: depth of the last range and its first keys, with the bytes already
+// known equal in gray and the byte the range was split on in yellow
+static void DrawStringSortInfo(const VisualizationState& state, float startX, Rectangle bounds) {
+    const StringArena& arena = state.strings;
+    DrawText(TextFormat("%s keys, depth %d, %d ranges pending (shared prefix %d bytes)", GetStringKeyKindName(state.stringKind),
+                        state.stringDepth, (int)state.stringRanges.size(), arena.sharedPrefix),
+             (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    if (state.highlightStart < 0 || arena.handles.empty()) return;
+
+    int x = (int)(bounds.x + bounds.width - 330);
+    int y = (int)bounds.y + 30;
+    int rows = std::min(12, state.highlightEnd - state.highlightStart + 1);
+    DrawRectangle(x - 5, y - 2, 325, 14 * rows + 4, { 0, 0, 0, 160 });
+    for (int r = 0; r < rows; r++) {
+        std::string key = GetStringKey(arena, arena.handles[state.highlightStart + r]);
+        int depth = std::min(state.stringDepth, (int)key.size());
+        std::string known = key.substr(0, depth);
+        std::string split = key.substr(depth, 1);
+        std::string rest = key.size() > (size_t)depth + 1 ? key.substr(depth + 1, 40) : "";
+        int cx = x;
+        DrawText(known.c_str(), cx, y + 14 * r, 10, GRAY);
+        cx += MeasureText(known.c_str(), 10) + 1;
+        DrawText(split.c_str(), cx, y + 14 * r, 10, YELLOW);
+        cx += MeasureText(split.c_str(), 10) + 1;
+        DrawText(rest.c_str(), cx, y + 14 * r, 10, WHITE);
+    }
+}
+
+// Lookup phase: the last query's probes as a path descending over the bars, one row
+// per probe, and the cache lines of the layout it touched in the band under the bars
+static void DrawLookupProbes(const VisualizationState& state, float startX, float startY, float barWidth,
+                             float panelWidth, Rectangle bounds) {
+    const SearchLayouts& layouts = state.searchLayouts;
+    const std::vector<SearchProbe>& probes = state.lookupProbes;
+    const char* layoutName = GetSearchLayoutName(state.lookupLayout);
+    if (probes.empty()) {
+        DrawText(TextFormat("Lookup (%s): %d of %d queries", layoutName, state.lookupCount, LOOKUP_VIZ_QUERIES),
+                 (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+        return;
+    }
+
+    // Lines of 16 ints, counted from the start of the memory the layout searches
+    int memorySize = layouts.n;
+    if (state.lookupLayout == SEARCH_EYTZINGER) memorySize = layouts.n + 1;
+    if (state.lookupLayout == SEARCH_STREE) memorySize = layouts.streeNodes * STREE_NODE_KEYS;
+    std::vector<int> lines;
+    for (const SearchProbe& probe : probes) lines.push_back(probe.memoryIndex / 16);
+    std::sort(lines.begin(), lines.end());
+    lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+    DrawText(TextFormat("Query %d: %d probes, %d cache lines (%s, %d of %d)", state.lookupQuery, (int)probes.size(),
+                        (int)lines.size(), layoutName, state.lookupCount, LOOKUP_VIZ_QUERIES),
+             (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+
+    float top = bounds.y + 40;
+    float rowHeight = std::min(24.0f, (startY - top - 20) / probes.size());
+    Vector2 previous = { 0, 0 };
+    for (int p = 0; p < (int)probes.size(); p++) {
+        Vector2 point = { startX + (probes[p].sortedIndex + 0.5f) * barWidth, top + p * rowHeight };
+        if (p > 0) DrawLineV(previous, point, YELLOW);
+        DrawCircleV(point, 3, p + 1 == (int)probes.size() ? RED : YELLOW);
+        previous = point;
+    }
+
+    float bandY = startY + 4;
+    float bandHeight = BAR_AREA_PADDING - 8;
+    float lineWidth = panelWidth * 16 / std::max(1, memorySize);
+    DrawRectangleRec({ startX, bandY, panelWidth, bandHeight }, DARKGRAY);
+    for (int line : lines) {
+        DrawRectangleRec({ startX + line * lineWidth, bandY, std::max(2.0f, lineWidth), bandHeight }, ORANGE);
+    }
+}
+
+// Graph traversal, drawn instead of the bars: vertices at their layout positions
+// colored by search state (gray: unreached, yellow: frontier / queued, green to blue:
+// done, by depth or distance), the search tree on top of the edges
+static void DrawGraphPanel(const VisualizationState& state, Rectangle bounds) {
+    const CsrGraph& graph = state.graph;
+    int n = graph.vertexCount;
+    if (n == 0) return;
+    bool isBfs = state.currentAlgorithm == ALGO_BFS;
+    const BfsSearch& bfs = state.bfs;
+    const DijkstraSearch& dijkstra = state.dijkstra;
+    int edgeCount = (int)graph.targets.size() / 2;
+
+    if (isBfs) {
+        DrawText(TextFormat("%s, %d vertices, %d edges   Level %d: frontier %d, next %s   (%d top-down, %d bottom-up)",
+                            GetGraphKindName(state.graphKind), n, edgeCount, bfs.level, (int)bfs.frontier.size(),
+                            bfs.bottomUp ? "bottom-up" : "top-down", bfs.topDownLevels, bfs.bottomUpLevels),
+                 (int)bounds.x + BAR_AREA_PADDING, (int)bounds.y + 5, 20, LIGHTGRAY);
+    } else {
+        DrawText(TextFormat("%s, %d vertices, %d edges   Settled %d, queued %lld (%s), %lld stale",
+                            GetGraphKindName(state.graphKind), n, edgeCount, dijkstra.settledCount, dijkstra.queued,
+                            GetDijkstraQueueName(dijkstra.queue), dijkstra.staleEntries),
+                 (int)bounds.x + BAR_AREA_PADDING, (int)bounds.y + 5, 20, LIGHTGRAY);
+    }
+
+    float left = bounds.x + BAR_AREA_PADDING;
+    float top = bounds.y + 40;
+    float width = bounds.width - 2 * BAR_AREA_PADDING;
+    float height = bounds.height - 40 - BAR_AREA_PADDING;
+    float radius = std::max(1.0f, std::min(6.0f, 0.3f * sqrtf(width * height / n)));
+    std::vector<Vector2> points(n);
+    for (int v = 0; v < n; v++) points[v] = { left + graph.layoutX[v] * width, top + graph.layoutY[v] * height };
+
+    const std::vector<int>& parent = isBfs ? bfs.parent : dijkstra.parent;
+    if ((int)graph.targets.size() <= GRAPH_DRAW_EDGE_LIMIT) {
+        for (int v = 0; v < n; v++) {
+            for (int e = graph.offsets[v]; e < graph.offsets[v + 1]; e++) {
+                if (graph.targets[e] > v) DrawLineV(points[v], points[graph.targets[e]], { 90, 90, 90, 255 });
+            }
+        }
+        for (int v = 0; v < n; v++) {
+            if (parent[v] >= 0 && parent[v] != v) DrawLineV(points[parent[v]], points[v], LIGHTGRAY);
+        }
+    }
+
+    // Reached vertices shade from green to blue over the depth / distance so far
+    float reach = 1.0f;
+    if (isBfs) reach = (float)std::max(1, bfs.level);
+    else if (dijkstra.current >= 0) reach = (float)std::max<int64_t>(1, dijkstra.distance[dijkstra.current]);
+    for (int v = 0; v < n; v++) {
+        Color color = DARKGRAY;
+        if (isBfs) {
+            if (bfs.depth[v] == bfs.level) color = YELLOW;
+            else if (bfs.depth[v] >= 0) color = ColorLerp(LIME, BLUE, bfs.depth[v] / reach);
+        } else {
+            if (dijkstra.settled[v]) color = ColorLerp(LIME, BLUE, std::min(1.0f, dijkstra.distance[v] / reach));
+            else if (dijkstra.distance[v] != GRAPH_UNREACHED) color = YELLOW;
+            if (v == dijkstra.current) color = BAR_HIGHLIGHT_SECONDARY;
+        }
+        if (v == state.graphSource) color = WHITE;
+        if (radius >= 2.0f) DrawCircleV(points[v], radius, color);
+        else DrawRectangleRec({ points[v].x, points[v].y, 1, 1 }, color);
+    }
+}
+
+// Compact counter value: 1234567 -> "1.23M"
+static const char* FormatCount(double value) {
+    if (value >= 1e9) return TextFormat("%.2fG", value / 1e9);
+    if (value >= 1e6) return TextFormat("%.2fM", value / 1e6);
+    if (value >= 1e3) return TextFormat("%.1fK", value / 1e3);
+    return TextFormat("%.0f", value);
+}
+
+// Benchmark sweep: one row per distribution/size, counters normalized per element
+static void DrawBenchmarkTable(const VisualizationState& state, Rectangle bounds) {
+    int x = (int)bounds.x + BAR_AREA_PADDING;
+    int y = (int)bounds.y + 30;
+    int rowHeight = 14;
+    int columns[] = { 0, 110, 170, 300, 380, 460, 520, 610 };
+    DrawRectangle(x - 5, y - 2, 710, rowHeight * ((int)state.benchmarkResults.size() + 2) + 4, { 0, 0, 0, 200 });
+    DrawText(TextFormat("Benchmark (best of %d, %s)", BENCHMARK_REPETITIONS, GetPerfCounterStatus()), x, y, 10, YELLOW);
+    y += rowHeight;
+    const char* headers[] = { "Distribution", "Size", "Engine", "ms", "cyc/elem", "IPC", "br-miss/elem", "cache-miss/elem" };
+    for (int c = 0; c < 8; c++) DrawText(headers[c], x + columns[c], y, 10, LIGHTGRAY);
+    y += rowHeight;
+
+    for (const VisualizationState::BenchmarkResult& r : state.benchmarkResults) {
+        const PerfSample& p = r.counters;
+        double n = (double)r.size;
+        if (r.inputName) DrawText(r.inputName, x + columns[0], y, 10, WHITE);
+        else if (r.rank >= 0) DrawText(TextFormat("%s k=%d", GetDistributionName(r.distribution), r.rank), x + columns[0], y, 10, WHITE);
+        else DrawText(GetDistributionName(r.distribution), x + columns[0], y, 10, WHITE);
+        DrawText(TextFormat("%d", r.size), x + columns[1], y, 10, WHITE);
+        DrawText(r.engineName ? r.engineName : GetAlgorithmName(r.algorithm), x + columns[2], y, 10, WHITE);
+        DrawText(TextFormat("%.3f", r.seconds * 1000.0), x + columns[3], y, 10, WHITE);
+        if (p.valid[PERF_CYCLES]) DrawText(TextFormat("%.1f", p.values[PERF_CYCLES] / n), x + columns[4], y, 10, WHITE);
+        if (p.valid[PERF_CYCLES] && p.valid[PERF_INSTRUCTIONS] && p.values[PERF_CYCLES] > 0) {
+            DrawText(TextFormat("%.2f", (double)p.values[PERF_INSTRUCTIONS] / p.values[PERF_CYCLES]), x + columns[5], y, 10, WHITE);
+        }
+        if (p.valid[PERF_BRANCH_MISSES]) DrawText(TextFormat("%.3f", p.values[PERF_BRANCH_MISSES] / n), x + columns[6], y, 10, WHITE);
+        if (p.valid[PERF_CACHE_MISSES]) DrawText(TextFormat("%.3f", p.values[PERF_CACHE_MISSES] / n), x + columns[7], y, 10, WHITE);
+        y += rowHeight;
+    }
+}
+
+// Lookup sweep: one row per size and layout
+static void DrawLookupTable(const VisualizationState& state, Rectangle bounds) {
+    int x = (int)bounds.x + BAR_AREA_PADDING;
+    int y = (int)bounds.y + 30;
+    int rowHeight = 12;
+    int columns[] = { 0, 80, 200, 270, 340, 440 };
+    DrawRectangle(x - 5, y - 2, 540, rowHeight * ((int)state.lookupResults.size() + 2) + 4, { 0, 0, 0, 200 });
+    DrawText(TextFormat("Lookups (%d queries, best of %d, %s)", LOOKUP_BENCHMARK_QUERIES, BENCHMARK_REPETITIONS,
+                        GetPerfCounterStatus()), x, y, 10, YELLOW);
+    y += rowHeight;
+    const char* headers[] = { "Size", "Layout", "ns/query", "Mq/s", "br-miss/query", "cache-miss/query" };
+    for (int c = 0; c < 6; c++) DrawText(headers[c], x + columns[c], y, 10, LIGHTGRAY);
+    y += rowHeight;
+
+    for (const LookupResult& r : state.lookupResults) {
+        const PerfSample& p = r.counters;
+        double queries = (double)LOOKUP_BENCHMARK_QUERIES;
+        DrawText(TextFormat("%d", r.size), x + columns[0], y, 10, WHITE);
+        DrawText(TextFormat("%s%s", GetSearchLayoutName(r.layout), r.prefetch ? " +prefetch" : ""), x + columns[1], y, 10, WHITE);
+        DrawText(TextFormat("%.1f", r.nsPerQuery), x + columns[2], y, 10, WHITE);
+        DrawText(TextFormat("%.1f", 1000.0 / r.nsPerQuery), x + columns[3], y, 10, WHITE);
+        if (p.valid[PERF_BRANCH_MISSES]) DrawText(TextFormat("%.2f", p.values[PERF_BRANCH_MISSES] / queries), x + columns[4], y, 10, WHITE);
+        if (p.valid[PERF_CACHE_MISSES]) DrawText(TextFormat("%.2f", p.values[PERF_CACHE_MISSES] / queries), x + columns[5], y, 10, WHITE);
+        y += rowHeight;
+    }
+}
+
 void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
     if (state.array.empty()) return;
 
+    if (IsGraphAlgorithm(state.currentAlgorithm)) {
+        DrawGraphPanel(state, bounds); // No bars: the graph is the data
+        if (state.memoryTrace) DrawCacheStats(state, bounds);
+        if (!state.benchmarkResults.empty()) DrawBenchmarkTable(state, bounds);
+        return;
+    }
+
     float panelWidth = bounds.width - 2 * BAR_AREA_PADDING;
     float panelHeight = bounds.height - 2 * BAR_AREA_PADDING;
     float barWidth = panelWidth / state.size;
@@ -137,6 +1126,31 @@ void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
     float startX = bounds.x + BAR_AREA_PADDING;
     float startY = bounds.y + bounds.height - BAR_AREA_PADDING; // Bottom edge
 
+    // Sorting networks and odd-even transposition: mark both sides of every
+    // comparator in the layer/phase just applied
+    std::vector<signed char> comparatorRole;
+    bool isNetwork = (state.currentAlgorithm == ALGO_BITONICSORT || state.currentAlgorithm == ALGO_ODDEVENMERGESORT);
+    bool isOddEven = (state.currentAlgorithm == ALGO_ODDEVENTRANSPOSITION);
+    if (state.status != VIZ_STATE_FINISHED && !state.lookupMode) {
+        std::vector<std::pair<int, int>> pairs;
+        if (isNetwork && state.networkLayerIndex > 0) {
+            GetNetworkLayerPairs(state.networkLayers[state.networkLayerIndex - 1], state.size, pairs);
+        } else if (isOddEven && state.oddEvenPhase > 0) {
+            for (int i = (state.oddEvenPhase - 1) & 1; i + 1 < state.size; i += 2) pairs.push_back({i, i + 1});
+        }
+        if (!pairs.empty()) {
+            comparatorRole.assign(state.size, 0);
+            for (const std::pair<int, int>& p : pairs) {
+                comparatorRole[p.first] = 1;  // Receives the minimum
+                comparatorRole[p.second] = 2; // Receives the maximum
+            }
+        }
+    }
+
+    if (state.memoryTrace) {
+        DrawAccessHeatmap(state, startX, startY, panelWidth, panelHeight);
+    }
+
     for (int i = 0; i < state.size; ++i) {
         float barHeight = ((float)state.array[i] / maxValue) * panelHeight;
         if (barHeight < MIN_BAR_HEIGHT) barHeight = MIN_BAR_HEIGHT;
@@ -157,7 +1171,18 @@ void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
             isDefaultColor = false;
        } else {
            // Specific highlights take precedence
-           if (i == state.tertiaryIndex) {
+           if (state.lookupMode) {
+                // Lookup phase: only the lower bound of the last query
+                if (i == state.primaryIndex) {
+                    barColor = BAR_HIGHLIGHT_PRIMARY;
+                    isDefaultColor = false;
+                }
+           }
+           else if (!comparatorRole.empty() && comparatorRole[i] != 0) {
+                barColor = (comparatorRole[i] == 1) ? BAR_HIGHLIGHT_PRIMARY : BAR_HIGHLIGHT_SECONDARY;
+                isDefaultColor = false;
+           }
+           else if (i == state.tertiaryIndex) {
                 barColor = BAR_HIGHLIGHT_TERTIARY;
                 isDefaultColor = false;
            }
@@ -171,11 +1196,12 @@ void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
            }
            // Range highlight (only apply if color is still default)
            else if (isDefaultColor && state.highlightStart != -1 && i >= state.highlightStart && i <= state.highlightEnd) {
-                if (state.currentAlgorithm == ALGO_QUICKSORT) {
+                if (state.currentAlgorithm == ALGO_QUICKSORT || state.currentAlgorithm == ALGO_POWERSORT ||
+                    state.currentAlgorithm == ALGO_HEAPSORT || IsSelectionAlgorithm(state.currentAlgorithm)) {
                     // Assign range color directly instead of blending incorrectly
                     barColor = BAR_HIGHLIGHT_RANGE;
                     isDefaultColor = false;
-                } else if (state.currentAlgorithm == ALGO_INSERTIONSORT) {
+                } else if (state.currentAlgorithm == ALGO_INSERTIONSORT || state.currentAlgorithm == ALGO_BINARYINSERTIONSORT) {
                     // Assign sorted color directly
                     barColor = BAR_SORTED_COLOR; // Or a slightly different shade if desired
                     isDefaultColor = false;
@@ -187,6 +1213,16 @@ void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
                  barColor = BAR_SORTED_COLOR; // Or a slightly different shade
                  isDefaultColor = false;
             }
+            // Cocktail shaker sorts both ends
+            else if (isDefaultColor && state.currentAlgorithm == ALGO_COCKTAILSORT && (i < state.passLow || i > state.passHigh)) {
+                 barColor = BAR_SORTED_COLOR;
+                 isDefaultColor = false;
+            }
+            // Heapsort: extracted maxima collect after the heap
+            else if (isDefaultColor && state.currentAlgorithm == ALGO_HEAPSORT && state.sortPhase == 1 && i > state.secondaryIndex) {
+                 barColor = BAR_SORTED_COLOR;
+                 isDefaultColor = false;
+            }
        }
 
 
@@ -196,30 +1232,324 @@ void DrawVisualizationPanel(const VisualizationState& state, Rectangle bounds) {
              DrawText(TextFormat("%d", state.array[i]), (int)barRect.x, (int)(barRect.y - 15), 10, WHITE);
          }
     }
+
+    if (state.lookupMode) {
+        DrawLookupProbes(state, startX, startY, barWidth, panelWidth, bounds);
+    } else if (isNetwork) {
+        DrawText(TextFormat("Layer %d / %d", state.networkLayerIndex, (int)state.networkLayers.size()),
+                 (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    } else if (isOddEven) {
+        DrawText(TextFormat("Phase %d  (%d pairs in parallel)", state.oddEvenPhase, state.size / 2),
+                 (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    } else if (state.currentAlgorithm == ALGO_SHELLSORT && state.gapIndex >= 0) {
+        DrawText(TextFormat("Gap %d  (%d of %d)", state.gapSequence[state.gapIndex],
+                            (int)state.gapSequence.size() - state.gapIndex, (int)state.gapSequence.size()),
+                 (int)startX, (int)bounds.y + 5, 20, LIGHTGRAY);
+    } else if (state.currentAlgorithm == ALGO_QUICKSORT && state.status != VIZ_STATE_FINISHED && !state.quickSortArena.empty()) {
+        DrawQuickSortStack(state, startX, startY, barWidth, bounds);
+    } else if (IsSelectionAlgorithm(state.currentAlgorithm)) {
+        DrawSelectionTarget(state, startX, startY, barWidth, panelHeight, bounds);
+    } else if (IsStringAlgorithm(state.currentAlgorithm)) {
+        DrawStringSortInfo(state, startX, bounds);
+    } else if (state.currentAlgorithm == ALGO_EXTERNALSORT) {
+        DrawExternalSortProgress(state, startX, startY, barWidth, bounds);
+    } else if (state.currentAlgorithm == ALGO_STREAMING) {
+        DrawStreamStats(state, startX, startY, barWidth, bounds);
+    } else if (state.currentAlgorithm == ALGO_POWERSORT && state.status != VIZ_STATE_FINISHED) {
+        DrawRunsAndMergeStack(state, startX, startY, barWidth, bounds);
+    } else if ((state.currentAlgorithm == ALGO_COUNTINGSORT || state.currentAlgorithm == ALGO_RADIXSORT) && state.status != VIZ_STATE_FINISHED) {
+        DrawBucketStrip(state, startX, panelWidth, bounds);
+    } else if (state.currentAlgorithm == ALGO_HEAPSORT && state.status != VIZ_STATE_FINISHED) {
+        DrawHeapTree(state, startX, panelWidth, panelHeight, bounds);
+    }
+
+    if (state.autoSelect) {
+        DrawAutoProfile(state, bounds);
+    }
+    if (state.memoryTrace) {
+        DrawCacheStats(state, bounds);
+    }
+    if (!state.benchmarkResults.empty()) {
+        DrawBenchmarkTable(state, bounds);
+    }
+    if (!state.lookupResults.empty()) {
+        DrawLookupTable(state, bounds);
+    }
 }
 
 // Draw the control panel (buttons, sliders) - Implementation depends heavily on ui_components
 // This is a basic example placeholder
 #include "ui_components.h" // Ensure included
 
-void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D buttonTexture, NPatchInfo buttonNpatchInfo) {
-    // Layout buttons within the bounds
-    float padding = 10;
-    float buttonWidth = 100;
-    float buttonHeight = 30;
-    float sliderWidth = 150;
+// Control panel widgets, kept across frames in controlPanel
+typedef enum {
+    CONTROL_PLAY,
+    CONTROL_STEP,
+    CONTROL_RESET,
+    CONTROL_SPEED_CAPTION,
+    CONTROL_SPEED_TEXT,
+    CONTROL_STATUS,
+    CONTROL_TRACE,
+    CONTROL_CACHE,
+    CONTROL_KERNEL,
+    CONTROL_BASE_CASE,
+    CONTROL_EARLY_EXIT,
+    CONTROL_ARITY,
+    CONTROL_PREFETCH,
+    CONTROL_RANK,
+    CONTROL_KEYS,
+    CONTROL_GRAPH,
+    CONTROL_SEARCH,
+    CONTROL_DATA,
+    CONTROL_MEMORY,
+    CONTROL_STRUCTURE,
+    CONTROL_RATE,
+    CONTROL_LOOKUP,
+    CONTROL_LAYOUT,
+    CONTROL_INSTANT,
+    CONTROL_FULL_SPEED_TIME,
+    CONTROL_FULL_SPEED_COUNTERS,
+    CONTROL_BENCH,
+    CONTROL_DISTRIBUTION,
+    CONTROL_SIZE,
+    CONTROL_WIDGET_COUNT
+} ControlWidget;
+
+// Everything the panel's labels, visibility and positions depend on. The panel is laid
+// out again only when this differs from the last layout (compared bytewise, so it is
+// cleared before being filled in).
+struct ControlPanelKey {
+    Rectangle bounds;
+    VisualizationStatus status;
+    AlgorithmType algorithm;
+    bool stepMode;
+    bool memoryTrace;
+    bool useNetworkBaseCase;
+    bool earlyExit;
+    bool heapPrefetch;
+    bool bfsDirectionOptimizing;
+    bool lookupMode;
+    int cachePreset;
+    int heapArity;
+    PartitionKernel partitionKernel;
+    float speed;
+    float selectFraction;
+    StringKeyKind stringKind;
+    GraphKind graphKind;
+    DijkstraQueue dijkstraQueue;
+    long long externalElements;
+    int externalMemoryCap;
+    StreamStructure streamStructure;
+    int arrivalRate;
+    SearchLayoutKind lookupLayout;
+    DataDistribution distribution;
+    int size;
+    double fullSpeedSeconds;
+};
+
+static UiPanel controlPanel;
+static ControlPanelKey controlPanelKey;
+
+static void MakeControlPanelKey(const VisualizationState& state, Rectangle bounds, ControlPanelKey& key) {
+    memset(&key, 0, sizeof(key));
+    key.bounds = bounds;
+    key.status = state.status;
+    key.algorithm = state.currentAlgorithm;
+    key.stepMode = state.stepMode;
+    key.memoryTrace = state.memoryTrace;
+    key.useNetworkBaseCase = state.useNetworkBaseCase;
+    key.earlyExit = state.earlyExit;
+    key.heapPrefetch = state.heapPrefetch;
+    key.bfsDirectionOptimizing = state.bfsDirectionOptimizing;
+    key.lookupMode = state.lookupMode;
+    key.cachePreset = state.cacheSim.presetIndex;
+    key.heapArity = state.heapArity;
+    key.partitionKernel = state.partitionKernel;
+    key.speed = state.speed;
+    key.selectFraction = state.selectFraction;
+    key.stringKind = state.stringKind;
+    key.graphKind = state.graphKind;
+    key.dijkstraQueue = state.dijkstraQueue;
+    key.externalElements = state.externalSort.totalElements;
+    key.externalMemoryCap = state.externalSort.memoryCap;
+    key.streamStructure = state.stream.structure;
+    key.arrivalRate = state.stream.arrivalRate;
+    key.lookupLayout = state.lookupLayout;
+    key.distribution = state.distribution;
+    key.size = state.size;
+    key.fullSpeedSeconds = state.fullSpeedSeconds;
+}
+
+// Panel geometry shared by the layout and the input handling
+static const float controlPadding = 10;
+static const float controlButtonWidth = 100;
+static const float controlButtonHeight = 30;
+static const float controlSliderWidth = 150;
+static const float controlOptionWidth = 170;
+
+static Rectangle SpeedSliderRect(Rectangle bounds) {
+    float x = bounds.x + controlPadding + 3 * (controlButtonWidth + controlPadding) + controlPadding;
+    return { x, bounds.y + controlPadding, controlSliderWidth, controlButtonHeight };
+}
+
+static bool IsSortedIntAlgorithm(AlgorithmType algorithm) {
+    return !IsSelectionAlgorithm(algorithm) && !IsStringAlgorithm(algorithm) && !IsGraphAlgorithm(algorithm) &&
+           algorithm != ALGO_STREAMING && algorithm != ALGO_EXTERNALSORT;
+}
+
+static void SetControlButton(int id, float x, float y, float width, const char* label) {
+    SetUiButton(controlPanel, id, { x, y, width, controlButtonHeight }, label, GRAY, DARKGRAY, BLACK, WHITE, 20);
+}
+
+// Place every widget the current state shows and format its label
+static void LayoutControlPanel(const VisualizationState& state, Rectangle bounds) {
+    float padding = controlPadding;
+    float buttonWidth = controlButtonWidth;
     float currentX = bounds.x + padding;
-    float currentY = bounds.y + padding; // Center vertically maybe? currentY = bounds.y + (bounds.height - buttonHeight) / 2;
+    float currentY = bounds.y + padding;
+    BeginUiLayout(controlPanel);
+
+    SetControlButton(CONTROL_PLAY, currentX, currentY, buttonWidth, (state.status == VIZ_STATE_SORTING) ? "Pause" : "Play");
+    currentX += buttonWidth + padding;
+    SetControlButton(CONTROL_STEP, currentX, currentY, buttonWidth, "Step");
+    currentX += buttonWidth + padding;
+    SetControlButton(CONTROL_RESET, currentX, currentY, buttonWidth, "Reset");
+
+    // Speed slider captions (the bar itself is two rectangles drawn every frame)
+    Rectangle sliderRect = SpeedSliderRect(bounds);
+    SetUiLabel(controlPanel, CONTROL_SPEED_CAPTION, sliderRect.x, sliderRect.y - 15, "Speed", 10, WHITE);
+    SetUiLabel(controlPanel, CONTROL_SPEED_TEXT, (float)(int)(sliderRect.x + controlSliderWidth + 5), currentY + 10,
+               TextFormat("%.1f steps/s", state.speed), 10, WHITE);
+    currentX = sliderRect.x + controlSliderWidth + padding + 60; // Space for text
+
+    // Status Text
+    const char* statusText = "Status: IDLE";
+    switch (state.status) {
+        case VIZ_STATE_SORTING: statusText = state.stepMode ? "Status: STEP" : "Status: SORTING"; break;
+        case VIZ_STATE_PAUSED:  statusText = "Status: PAUSED"; break;
+        case VIZ_STATE_FINISHED:statusText = "Status: FINISHED"; break;
+        case VIZ_STATE_IDLE: /* Default */ break;
+    }
+    SetUiLabel(controlPanel, CONTROL_STATUS, (float)(int)currentX, currentY + 10, statusText, 20, WHITE);
+
+    // Memory tracing toggle and cache preset, left of the Back button's place
+    float cacheX = bounds.x + bounds.width - buttonWidth - 2 * padding - 170;
+    float traceWidth = 130;
+    SetControlButton(CONTROL_TRACE, cacheX - traceWidth - padding, currentY, traceWidth, state.memoryTrace ? "Trace: On" : "Trace: Off");
+    if (state.memoryTrace) SetControlButton(CONTROL_CACHE, cacheX, currentY, 170, GetCachePreset(state.cacheSim.presetIndex).name);
+
+    // Algorithm options on the second row, laid out left to right
+    float optionX = bounds.x + padding;
+    float optionY = currentY + controlButtonHeight + padding;
+    float optionWidth = controlOptionWidth;
+
+    // Partition options (quicksort only)
+    if (state.currentAlgorithm == ALGO_QUICKSORT) {
+        SetControlButton(CONTROL_KERNEL, optionX, optionY, optionWidth, TextFormat("Kernel: %s", GetPartitionKernelName(state.partitionKernel)));
+        optionX += optionWidth + padding;
+        SetControlButton(CONTROL_BASE_CASE, optionX, optionY, optionWidth, state.useNetworkBaseCase ? "Base: Network" : "Base: None");
+        optionX += optionWidth + padding;
+    }
+
+    // Early exit toggle (bubble family)
+    if (state.currentAlgorithm == ALGO_BUBBLESORT || state.currentAlgorithm == ALGO_COCKTAILSORT || state.currentAlgorithm == ALGO_ODDEVENTRANSPOSITION) {
+        SetControlButton(CONTROL_EARLY_EXIT, optionX, optionY, optionWidth, state.earlyExit ? "Early Exit: On" : "Early Exit: Off");
+        optionX += optionWidth + padding;
+    }
+
+    // Heapsort: arity and the full-speed engine's prefetch
+    if (state.currentAlgorithm == ALGO_HEAPSORT) {
+        SetControlButton(CONTROL_ARITY, optionX, optionY, optionWidth, TextFormat("Arity: %d", state.heapArity));
+        optionX += optionWidth + padding;
+        SetControlButton(CONTROL_PREFETCH, optionX, optionY, optionWidth, state.heapPrefetch ? "Prefetch: On" : "Prefetch: Off");
+        optionX += optionWidth + padding;
+    }
 
+    // Selection: target rank as a fraction of n
+    if (IsSelectionAlgorithm(state.currentAlgorithm)) {
+        SetControlButton(CONTROL_RANK, optionX, optionY, optionWidth, TextFormat("k: %.0f%%", state.selectFraction * 100.0f));
+        optionX += optionWidth + padding;
+    }
+
+    // String sorting: key kind
+    if (IsStringAlgorithm(state.currentAlgorithm)) {
+        SetControlButton(CONTROL_KEYS, optionX, optionY, optionWidth, TextFormat("Keys: %s", GetStringKeyKindName(state.stringKind)));
+        optionX += optionWidth + padding;
+    }
+
+    // Graphs: generator and the BFS direction / Dijkstra queue
+    if (IsGraphAlgorithm(state.currentAlgorithm)) {
+        SetControlButton(CONTROL_GRAPH, optionX, optionY, optionWidth, TextFormat("Graph: %s", GetGraphKindName(state.graphKind)));
+        optionX += optionWidth + padding;
+        bool isBfs = state.currentAlgorithm == ALGO_BFS;
+        SetControlButton(CONTROL_SEARCH, optionX, optionY, optionWidth,
+                         isBfs ? (state.bfsDirectionOptimizing ? "BFS: Dir-opt" : "BFS: Top-down")
+                               : (state.dijkstraQueue == DIJKSTRA_RADIX_HEAP ? "Queue: Radix" : "Queue: Binary"));
+        optionX += optionWidth + padding;
+    }
+
+    // External sort: data set size and memory cap
+    if (state.currentAlgorithm == ALGO_EXTERNALSORT) {
+        SetControlButton(CONTROL_DATA, optionX, optionY, optionWidth, TextFormat("Data: %lldM", state.externalSort.totalElements >> 20));
+        optionX += optionWidth + padding;
+        SetControlButton(CONTROL_MEMORY, optionX, optionY, optionWidth,
+                         TextFormat("Memory: %d KB", (int)(state.externalSort.memoryCap * sizeof(int) / 1024)));
+        optionX += optionWidth + padding;
+    }
+
+    // Streaming: online structure and arrival rate
+    if (state.currentAlgorithm == ALGO_STREAMING) {
+        SetControlButton(CONTROL_STRUCTURE, optionX, optionY, optionWidth, GetStreamStructureName(state.stream.structure));
+        optionX += optionWidth + padding;
+        SetControlButton(CONTROL_RATE, optionX, optionY, optionWidth, TextFormat("Rate: %d/s", state.stream.arrivalRate));
+        optionX += optionWidth + padding;
+    }
+
+    // Lookup phase: offered once an int sort has finished
+    if (state.lookupMode || (IsSortedIntAlgorithm(state.currentAlgorithm) && state.status == VIZ_STATE_FINISHED)) {
+        SetControlButton(CONTROL_LOOKUP, optionX, optionY, buttonWidth, "Lookup");
+        optionX += buttonWidth + padding;
+    }
+    if (state.lookupMode) {
+        SetControlButton(CONTROL_LAYOUT, optionX, optionY, optionWidth, TextFormat("Layout: %s", GetSearchLayoutName(state.lookupLayout)));
+        optionX += optionWidth + padding;
+    }
+
+    // Instant Button and the last full-speed run
+    SetControlButton(CONTROL_INSTANT, optionX, optionY, buttonWidth, "Instant");
+    optionX += buttonWidth + padding;
+    if (state.fullSpeedSeconds >= 0.0) {
+        const PerfSample& p = state.fullSpeedCounters;
+        SetUiLabel(controlPanel, CONTROL_FULL_SPEED_TIME, (float)(int)optionX, (float)(int)optionY + 3,
+                   TextFormat("Full speed: %.3f ms", state.fullSpeedSeconds * 1000.0), 10, LIGHTGRAY);
+        if (p.valid[PERF_CYCLES] && p.valid[PERF_INSTRUCTIONS] && p.values[PERF_CYCLES] > 0) {
+            SetUiLabel(controlPanel, CONTROL_FULL_SPEED_COUNTERS, (float)(int)optionX, (float)(int)optionY + 17,
+                       TextFormat("%s cyc  IPC %.2f  %s br-miss", FormatCount((double)p.values[PERF_CYCLES]),
+                                  (double)p.values[PERF_INSTRUCTIONS] / p.values[PERF_CYCLES],
+                                  p.valid[PERF_BRANCH_MISSES] ? FormatCount((double)p.values[PERF_BRANCH_MISSES]) : "-"),
+                       10, LIGHTGRAY);
+        } else {
+            SetUiLabel(controlPanel, CONTROL_FULL_SPEED_COUNTERS, (float)(int)optionX, (float)(int)optionY + 17,
+                       GetPerfCounterStatus(), 10, GRAY);
+        }
+    }
+
+    // Right-aligned on the option row: Bench, distribution, size
+    SetControlButton(CONTROL_BENCH, bounds.x + bounds.width - 2 * (optionWidth + padding) - buttonWidth - padding, optionY, buttonWidth, "Bench");
+    SetControlButton(CONTROL_DISTRIBUTION, bounds.x + bounds.width - 2 * (optionWidth + padding), optionY, optionWidth,
+                     GetDistributionName(state.distribution));
+    SetControlButton(CONTROL_SIZE, bounds.x + bounds.width - optionWidth - padding, optionY, optionWidth, TextFormat("Size: %d", state.size));
+}
+
+void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D buttonTexture, NPatchInfo buttonNpatchInfo) {
+    if (controlPanel.widgets.empty()) InitUiPanel(controlPanel, CONTROL_WIDGET_COUNT);
+    SetUiPanelTexture(controlPanel, buttonTexture, buttonNpatchInfo);
+
+    // Clicks land on the widgets as they were drawn last frame
+    UpdateUiPanel(controlPanel);
 
     // Play/Pause Button
-    NButton playPauseButton = {
-        { currentX, currentY, buttonWidth, buttonHeight },
-        (state.status == VIZ_STATE_SORTING) ? "Pause" : "Play",
-        buttonTexture, buttonNpatchInfo,
-        GRAY, DARKGRAY, BLACK, WHITE, 20
-    };
-    if (DrawNButton(playPauseButton) && state.currentAlgorithm != ALGO_NONE && state.status != VIZ_STATE_FINISHED) {
+    if (IsUiWidgetClicked(controlPanel, CONTROL_PLAY) && state.currentAlgorithm != ALGO_NONE && state.status != VIZ_STATE_FINISHED) {
         if (state.status == VIZ_STATE_SORTING) {
             state.status = VIZ_STATE_PAUSED;
             state.stepMode = false; // Ensure step mode is off when pausing normally
@@ -227,7 +1557,10 @@ void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D but
             state.status = VIZ_STATE_SORTING;
             state.stepMode = false;
              // If was IDLE, need to init algo state
-             if(state.currentAlgorithm == ALGO_QUICKSORT && state.quickSortStack.empty()) {
+             if (state.lookupMode) {
+                 // Lookup phase: the layouts were built when it started
+             }
+             else if(state.currentAlgorithm == ALGO_QUICKSORT && state.quickSortCurrent.stage < 0) {
                  ResetVisualizationState(state); // This will set up the first frame
                  state.status = VIZ_STATE_SORTING;
              }
@@ -241,32 +1574,21 @@ void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D but
                }
         }
     }
-    currentX += buttonWidth + padding;
 
     // Step Button
-    NButton stepButton = {
-        { currentX, currentY, buttonWidth, buttonHeight },
-        "Step",
-        buttonTexture, buttonNpatchInfo,
-        GRAY, DARKGRAY, BLACK, WHITE, 20
-    };
-     if (DrawNButton(stepButton) && state.currentAlgorithm != ALGO_NONE && (state.status == VIZ_STATE_PAUSED || state.status == VIZ_STATE_IDLE)) {
+     if (IsUiWidgetClicked(controlPanel, CONTROL_STEP) && state.currentAlgorithm != ALGO_NONE && (state.status == VIZ_STATE_PAUSED || state.status == VIZ_STATE_IDLE)) {
         state.status = VIZ_STATE_SORTING; // Set to sorting to allow one step
         state.stepMode = true; // Enter step mode
 
-         // Ensure algo state is initialized if starting from IDLE
-         if(state.currentAlgorithm == ALGO_QUICKSORT && state.quickSortStack.empty()) ResetVisualizationState(state);
-         else if(state.currentAlgorithm == ALGO_BUBBLESORT && state.primaryIndex == -1) ResetVisualizationState(state);
-         else if(state.currentAlgorithm == ALGO_INSERTIONSORT && state.primaryIndex == -1) ResetVisualizationState(state);
+         // Ensure algo state is initialized if starting from IDLE (the lookup phase needs nothing)
+         if (!state.lookupMode) {
+             if(state.currentAlgorithm == ALGO_QUICKSORT && state.quickSortCurrent.stage < 0) ResetVisualizationState(state);
+             else if(state.currentAlgorithm == ALGO_BUBBLESORT && state.primaryIndex == -1) ResetVisualizationState(state);
+             else if(state.currentAlgorithm == ALGO_INSERTIONSORT && state.primaryIndex == -1) ResetVisualizationState(state);
+         }
 
          // Manually call the step function ONCE
-         bool stillRunning = true;
-         switch (state.currentAlgorithm) {
-             case ALGO_QUICKSORT: stillRunning = StepQuickSort(state); break;
-             case ALGO_BUBBLESORT: stillRunning = StepBubbleSort(state); break;
-             case ALGO_INSERTIONSORT: stillRunning = StepInsertionSort(state); break;
-             default: stillRunning = false; break;
-         }
+         bool stillRunning = StepAlgorithm(state);
 
          if (!stillRunning) {
              state.status = VIZ_STATE_FINISHED;
@@ -277,64 +1599,164 @@ void DrawControlPanel(VisualizationState& state, Rectangle bounds, Texture2D but
          }
          // state.stepMode remains true until Play is pressed
      }
-    currentX += buttonWidth + padding;
 
-
-    // Reset Button
-    NButton resetButton = {
-        { currentX, currentY, buttonWidth, buttonHeight },
-        "Reset",
-        buttonTexture, buttonNpatchInfo,
-        GRAY, DARKGRAY, BLACK, WHITE, 20
-    };
-    if (DrawNButton(resetButton)) {
-        ResetVisualizationState(state); // Resets array and state, keeps current algo selected
+    // Reset Button: resets array and state, keeps current algo selected
+    if (IsUiWidgetClicked(controlPanel, CONTROL_RESET)) {
+        ResetVisualizationState(state);
     }
-    currentX += buttonWidth + padding;
 
     // Speed Slider (Using basic Raylib rects for simplicity here)
-    currentX += padding;
-    Rectangle sliderRect = { currentX, currentY, sliderWidth, buttonHeight };
-    DrawRectangleRec(sliderRect, DARKGRAY);
-    float speedNormalized = Lerp(0.1f, 200.0f, state.speed / 200.0f); // Map speed to slider range (adjust max speed)
-     // Non-linear mapping might be better (e.g., logarithmic)
-     float sliderHandlePos = sliderRect.x + (state.speed / 200.0f) * sliderRect.width; // Linear for now
-
-
-    DrawText("Speed", (int)sliderRect.x, (int)(sliderRect.y - 15), 10, WHITE);
-    Rectangle handleRect = { sliderHandlePos - 5, currentY, 10, buttonHeight };
-    DrawRectangleRec(handleRect, LIGHTGRAY);
-
+    Rectangle sliderRect = SpeedSliderRect(bounds);
     if (CheckCollisionPointRec(GetMousePosition(), sliderRect) && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
         float mouseXRelative = GetMousePosition().x - sliderRect.x;
         state.speed = (mouseXRelative / sliderRect.width) * 200.0f; // Adjust max speed
         if (state.speed < 0.1f) state.speed = 0.1f; // Min speed
         if (state.speed > 200.0f) state.speed = 200.0f;
     }
-     DrawText(TextFormat("%.1f steps/s", state.speed), (int)(sliderRect.x + sliderWidth + 5), (int)currentY + 10, 10, WHITE);
-    currentX += sliderWidth + padding + 60; // Space for text
 
+    // Memory tracing toggle and cache preset
+    if (IsUiWidgetClicked(controlPanel, CONTROL_TRACE)) {
+        state.memoryTrace = !state.memoryTrace;
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_CACHE)) {
+        // A different hierarchy invalidates the statistics gathered so far
+        InitCacheSimulator(state.cacheSim, (state.cacheSim.presetIndex + 1) % GetCachePresetCount());
+        std::fill(state.accessCounts.begin(), state.accessCounts.end(), 0);
+    }
+
+    // Partition options
+    if (IsUiWidgetClicked(controlPanel, CONTROL_KERNEL)) {
+        // Cycle through the kernels this CPU can actually run
+        PartitionKernel next = (PartitionKernel)((state.partitionKernel + 1) % PARTITION_KERNEL_COUNT);
+        if (ResolvePartitionKernel(next) != next) next = PARTITION_SCALAR;
+        state.partitionKernel = next;
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_BASE_CASE)) {
+        state.useNetworkBaseCase = !state.useNetworkBaseCase;
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_EARLY_EXIT)) {
+        state.earlyExit = !state.earlyExit;
+    }
 
-    // Status Text
-    const char* statusText = "Status: IDLE";
-    switch (state.status) {
-        case VIZ_STATE_SORTING: statusText = state.stepMode ? "Status: STEP" : "Status: SORTING"; break;
-        case VIZ_STATE_PAUSED:  statusText = "Status: PAUSED"; break;
-        case VIZ_STATE_FINISHED:statusText = "Status: FINISHED"; break;
-        case VIZ_STATE_IDLE: /* Default */ break;
+    // Heap arity (restarts the sort) and prefetch
+    if (IsUiWidgetClicked(controlPanel, CONTROL_ARITY)) {
+        state.heapArity = NextHeapArity(state.heapArity);
+        ResetVisualizationState(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_PREFETCH)) {
+        state.heapPrefetch = !state.heapPrefetch;
     }
-     DrawText(statusText, (int)currentX, (int)currentY + 10, 20, WHITE);
 
-    // Back Button (example)
-     NButton backButton = {
-         { bounds.x + bounds.width - buttonWidth - padding, currentY, buttonWidth, buttonHeight },
-         "Back",
-         buttonTexture, buttonNpatchInfo,
-         GRAY, DARKGRAY, BLACK, WHITE, 20
-     };
-     // We need a way to signal back to main.cpp. Let's return true if back is clicked.
-     // Modify DrawControlPanel prototype if needed, or use a flag in the state.
-     // For now, assume main.cpp checks for ESCAPE key.
+    // Selection rank (restarts the run)
+    if (IsUiWidgetClicked(controlPanel, CONTROL_RANK)) {
+        static const float fractionChoices[] = { 0.01f, 0.1f, 0.25f, 0.5f, 0.9f };
+        static const int fractionChoiceCount = sizeof(fractionChoices) / sizeof(fractionChoices[0]);
+        int next = 0;
+        while (next < fractionChoiceCount && fractionChoices[next] <= state.selectFraction) next++;
+        state.selectFraction = fractionChoices[next % fractionChoiceCount];
+        ResetVisualizationState(state);
+    }
 
+    // String key kind (new keys)
+    if (IsUiWidgetClicked(controlPanel, CONTROL_KEYS)) {
+        state.stringKind = (StringKeyKind)((state.stringKind + 1) % STRING_KEY_KIND_COUNT);
+        ResetVisualizationState(state);
+    }
 
-}
\ No newline at end of file
+    // Graph generator (new graph) and search variant (restarts the search)
+    if (IsUiWidgetClicked(controlPanel, CONTROL_GRAPH)) {
+        GraphKind next = (GraphKind)((state.graphKind + 1) % GRAPH_KIND_COUNT);
+        if (next == GRAPH_FILE && !getenv(GRAPH_FILE_VARIABLE)) next = GRAPH_GRID; // Nothing to load
+        state.graphKind = next;
+        ResetVisualizationState(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_SEARCH)) {
+        if (state.currentAlgorithm == ALGO_BFS) state.bfsDirectionOptimizing = !state.bfsDirectionOptimizing;
+        else state.dijkstraQueue = (DijkstraQueue)((state.dijkstraQueue + 1) % DIJKSTRA_QUEUE_COUNT);
+        ResetVisualizationState(state);
+    }
+
+    // External sort: data set size and memory cap (both restart the sort)
+    static const int externalChoiceCount = 3;
+    if (IsUiWidgetClicked(controlPanel, CONTROL_DATA)) {
+        static const int dataChoices[] = { 1 << 20, 1 << 22, 1 << 24 };
+        int next = 0;
+        while (next < externalChoiceCount && dataChoices[next] <= state.externalSort.totalElements) next++;
+        state.externalSort.totalElements = dataChoices[next % externalChoiceCount];
+        ResetVisualizationState(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_MEMORY)) {
+        static const int memoryChoices[] = { 1 << 14, 1 << 16, 1 << 18 };
+        int next = 0;
+        while (next < externalChoiceCount && memoryChoices[next] <= state.externalSort.memoryCap) next++;
+        state.externalSort.memoryCap = memoryChoices[next % externalChoiceCount];
+        ResetVisualizationState(state);
+    }
+
+    // Streaming: online structure (restarts the stream) and arrival rate
+    if (IsUiWidgetClicked(controlPanel, CONTROL_STRUCTURE)) {
+        state.stream.structure = (StreamStructure)((state.stream.structure + 1) % STREAM_STRUCTURE_COUNT);
+        ResetVisualizationState(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_RATE)) {
+        static const int rateChoices[] = { 100, 1000, 10000, 100000, 1000000 };
+        static const int rateChoiceCount = sizeof(rateChoices) / sizeof(rateChoices[0]);
+        int next = 0;
+        while (next < rateChoiceCount && rateChoices[next] <= state.stream.arrivalRate) next++;
+        state.stream.arrivalRate = rateChoices[next % rateChoiceCount];
+    }
+
+    // Lookup phase over the sorted bars (restarts the queries)
+    if (IsUiWidgetClicked(controlPanel, CONTROL_LOOKUP) && std::is_sorted(state.array.begin(), state.array.end())) {
+        StartLookup(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_LAYOUT)) {
+        state.lookupLayout = (SearchLayoutKind)((state.lookupLayout + 1) % SEARCH_LAYOUT_COUNT);
+        StartLookup(state);
+    }
+
+    // Instant: finish the run with the full-speed engine
+    if (IsUiWidgetClicked(controlPanel, CONTROL_INSTANT) && state.currentAlgorithm != ALGO_NONE && state.status != VIZ_STATE_FINISHED) {
+        RunAlgorithmFullSpeed(state);
+    }
+
+    // Benchmark: sweep the full-speed engine over all distributions and sizes
+    // (selection engines: over k, against a full sort; lookup phase: over the search layouts;
+    // graphs: every traversal variant over the generators)
+    if (IsUiWidgetClicked(controlPanel, CONTROL_BENCH) && state.currentAlgorithm != ALGO_NONE) {
+        // Blocks the UI for the duration of the sweep
+        if (state.lookupMode) RunLookupBenchmark(state);
+        else if (IsSelectionAlgorithm(state.currentAlgorithm)) RunSelectionBenchmark(state);
+        else if (IsGraphAlgorithm(state.currentAlgorithm)) RunGraphBenchmark(state);
+        else if (IsStringAlgorithm(state.currentAlgorithm)) RunStringBenchmark(state);
+        else if (state.currentAlgorithm == ALGO_HEAPSORT) RunHeapBenchmark(state);
+        else RunBenchmarkSweep(state);
+    }
+
+    // Input distribution and array size
+    if (IsUiWidgetClicked(controlPanel, CONTROL_DISTRIBUTION)) {
+        state.distribution = (DataDistribution)((state.distribution + 1) % DATA_DISTRIBUTION_COUNT);
+        ResetVisualizationState(state);
+    }
+    if (IsUiWidgetClicked(controlPanel, CONTROL_SIZE)) {
+        static const int sizeChoices[] = { 20, 50, 200, 1000, 10000, 100000 };
+        static const int sizeChoiceCount = sizeof(sizeChoices) / sizeof(sizeChoices[0]);
+        int next = 0;
+        while (next < sizeChoiceCount && sizeChoices[next] <= state.size) next++;
+        ResizeVisualizationState(state, sizeChoices[next % sizeChoiceCount]);
+    }
+
+    // Lay out again only if something the panel shows has changed (including the clicks above)
+    ControlPanelKey key;
+    MakeControlPanelKey(state, bounds, key);
+    if (memcmp(&key, &controlPanelKey, sizeof(key)) != 0) {
+        LayoutControlPanel(state, bounds);
+        controlPanelKey = key;
+    }
+
+    // The slider bar and handle, then every button and label in one pass
+    DrawRectangleRec(sliderRect, DARKGRAY);
+    float sliderHandlePos = sliderRect.x + (state.speed / 200.0f) * sliderRect.width; // Linear for now
+    DrawRectangleRec({ sliderHandlePos - 5, sliderRect.y, 10, controlButtonHeight }, LIGHTGRAY);
+    DrawUiPanel(controlPanel);
+}